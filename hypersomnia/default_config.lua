@@ -217,7 +217,10 @@ return {
     regenerate_every_time = false,
 	rescan_assets_on_window_focus = true,
 	atlas_blitting_threads = 3,
-	neon_regeneration_threads = 3
+	neon_regeneration_threads = 3,
+	cache_baked_atlas = true,
+	cache_decoded_sounds = true,
+	sound_decoding_threads = 3
   },
   debug = {
     determinism_test_cloned_cosmoi_count = 0,
@@ -641,6 +644,12 @@ return {
 
 	current_arena = "de_cyberaqua",
 	override_default_ruleset = "",
+
+	pool_headroom = {
+	  arena_content_mult = 0.25,
+	  min_free_entities = 64,
+	  spawn_headroom_mult = 1
+	}
   },
 
   server = {
@@ -688,7 +697,30 @@ return {
   },
 
   dedicated_server = {
+	-- Number of independent matches hosted by a single dedicated server process.
+	-- Every next instance binds to the next free port after the previous one, starting from default_server_start.port.
+	-- NAT is detected separately for each of these ports.
+	num_instances = 1
+  },
+
+  server_relay = {
+	-- If enabled, the dedicated server does not host a match of its own.
+	-- Instead, it connects to the upstream server as a single client and re-serves its match to spectators.
+	-- Relays can be chained by pointing one relay at another.
+	enabled = false,
+
+	upstream = {
+	  address = "127.0.0.1",
+	  default_port = 8412
+	},
+
+	nickname = "Relay",
+
+	-- Must match the rcon password of the upstream server, otherwise it will treat the relay as a regular player.
+	upstream_rcon_password = "",
 
+	-- Spectators see the match this many seconds later than it happens.
+	broadcast_delay_secs = 0
   },
 
   client = {
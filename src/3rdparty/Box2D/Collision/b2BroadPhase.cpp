@@ -121,6 +121,19 @@ bool b2BroadPhase::QueryCallback(int32 proxyId)
 b2BroadPhase& b2BroadPhase::operator=(const b2BroadPhase& b) {
 	m_proxyCount = b.m_proxyCount;
 
+	// Keep our buffers if they are already of the right size.
+	if (m_pairCapacity != b.m_pairCapacity)
+	{
+		b2Free(m_pairBuffer);
+		m_pairBuffer = (b2Pair*)b2Alloc(b.m_pairCapacity * sizeof(b2Pair));
+	}
+
+	if (m_moveCapacity != b.m_moveCapacity)
+	{
+		b2Free(m_moveBuffer);
+		m_moveBuffer = (int32*)b2Alloc(b.m_moveCapacity * sizeof(int32));
+	}
+
 	m_moveCapacity = b.m_moveCapacity;
 	m_moveCount = b.m_moveCount;
 
@@ -129,9 +142,6 @@ b2BroadPhase& b2BroadPhase::operator=(const b2BroadPhase& b) {
 
 	m_queryProxyId = b.m_queryProxyId;
 
-	m_pairBuffer = (b2Pair*)b2Alloc(m_pairCapacity * sizeof(b2Pair));
-	m_moveBuffer = (int32*)b2Alloc(m_moveCapacity * sizeof(int32));
-
 	memcpy(m_pairBuffer, b.m_pairBuffer, m_pairCount * sizeof(b2Pair));
 	memcpy(m_moveBuffer, b.m_moveBuffer, m_moveCount * sizeof(int32));
 
@@ -108,6 +108,7 @@ public:
 private:
 
 	friend class physics_world_cache;
+	friend class b2world_cloner;
 	friend class b2DynamicTree;
 
 	void BufferMove(int32 proxyId);
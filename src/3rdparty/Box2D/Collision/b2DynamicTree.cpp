@@ -793,8 +793,6 @@ void b2DynamicTree::ShiftOrigin(const b2Vec2& newOrigin)
 
 b2DynamicTree& b2DynamicTree::operator=(const b2DynamicTree& b) 
 {
-	this->~b2DynamicTree();
-
 	const auto bytes = b.m_nodeCapacity * sizeof(b2TreeNode);
 #if DEBUG_PHYSICS_WORLD_CACHE_COPY
 #if PLATFORM_WINDOWS
@@ -804,7 +802,13 @@ b2DynamicTree& b2DynamicTree::operator=(const b2DynamicTree& b)
 #endif
 #endif
 
-	m_nodes = (b2TreeNode*)b2Alloc(static_cast<int32>(bytes));
+	// Keep our nodes if they are already of the right size.
+	if (m_nodes == nullptr || m_nodeCapacity != b.m_nodeCapacity)
+	{
+		this->~b2DynamicTree();
+		m_nodes = (b2TreeNode*)b2Alloc(static_cast<int32>(bytes));
+	}
+
 	memcpy(m_nodes, b.m_nodes, bytes);
 
 	m_root = b.m_root;
@@ -131,6 +131,7 @@ public:
 
 private:
 	friend class physics_world_cache;
+	friend class b2world_cloner;
 
 	int32 AllocateNode();
 	void FreeNode(int32 node);
@@ -21,6 +21,7 @@
 #include <climits>
 #include <cstring>
 #include <memory>
+#include <algorithm>
 
 #include "augs/build_settings/setting_debug_physics_world_cache_copy.h"
 
@@ -68,6 +69,12 @@ b2BlockAllocator::b2BlockAllocator()
 	m_chunkCount = 0;
 	m_chunks = (b2Chunk*)b2Alloc(m_chunkSpace * sizeof(b2Chunk));
 
+	m_numLargeAllocations = 0;
+
+	m_migrations = NULL;
+	m_migrationCount = 0;
+	m_migrationSpace = 0;
+
 	memset(m_chunks, 0, m_chunkSpace * sizeof(b2Chunk));
 	memset(m_freeLists, 0, sizeof(m_freeLists));
 
@@ -100,6 +107,11 @@ b2BlockAllocator::~b2BlockAllocator()
 	}
 
 	b2Free(m_chunks);
+
+	if (m_migrations)
+	{
+		b2Free(m_migrations);
+	}
 }
 
 void* b2BlockAllocator::Allocate(int32 size)
@@ -115,6 +127,7 @@ void* b2BlockAllocator::Allocate(int32 size)
 
 	if (size > b2_maxBlockSize)
 	{
+		++m_numLargeAllocations;
 		return b2Alloc(size);
 	}
 
@@ -179,6 +192,7 @@ void b2BlockAllocator::Free(void* p, int32 size)
 
 	if (size > b2_maxBlockSize)
 	{
+		--m_numLargeAllocations;
 		b2Free(p);
 		return;
 	}
@@ -228,4 +242,119 @@ void b2BlockAllocator::Clear()
 	memset(m_chunks, 0, m_chunkSpace * sizeof(b2Chunk));
 
 	memset(m_freeLists, 0, sizeof(m_freeLists));
+
+	m_numLargeAllocations = 0;
+	m_migrationCount = 0;
+}
+
+void b2BlockAllocator::CloneChunksFrom(const b2BlockAllocator& source)
+{
+	b2Assert(this != &source);
+	b2Assert(source.m_numLargeAllocations == 0);
+
+	const int32 count = source.m_chunkCount;
+
+	if (m_chunkSpace < count)
+	{
+		b2Chunk* oldChunks = m_chunks;
+		const int32 newSpace = source.m_chunkSpace;
+
+		m_chunks = (b2Chunk*)b2Alloc(newSpace * sizeof(b2Chunk));
+		memcpy(m_chunks, oldChunks, m_chunkCount * sizeof(b2Chunk));
+		memset(m_chunks + m_chunkCount, 0, (newSpace - m_chunkCount) * sizeof(b2Chunk));
+		b2Free(oldChunks);
+
+		m_chunkSpace = newSpace;
+	}
+
+	/* Reuse what we already own, allocate only the missing chunks and free the surplus. */
+
+	for (int32 i = m_chunkCount; i < count; ++i)
+	{
+		m_chunks[i].blocks = (b2Block*)b2Alloc(b2_chunkSize);
+	}
+
+	for (int32 i = count; i < m_chunkCount; ++i)
+	{
+		b2Free(m_chunks[i].blocks);
+		m_chunks[i].blocks = NULL;
+		m_chunks[i].blockSize = 0;
+	}
+
+	m_chunkCount = count;
+
+	if (m_migrationSpace < count)
+	{
+		if (m_migrations)
+		{
+			b2Free(m_migrations);
+		}
+
+		m_migrationSpace = source.m_chunkSpace;
+		m_migrations = (b2ChunkMigration*)b2Alloc(m_migrationSpace * sizeof(b2ChunkMigration));
+	}
+
+	m_migrationCount = count;
+
+	for (int32 i = 0; i < count; ++i)
+	{
+		const b2Chunk& from = source.m_chunks[i];
+		b2Chunk& to = m_chunks[i];
+
+		to.blockSize = from.blockSize;
+		memcpy(to.blocks, from.blocks, b2_chunkSize);
+
+		m_migrations[i].sourceBlocks = (const int8*)from.blocks;
+		m_migrations[i].blocks = (int8*)to.blocks;
+	}
+
+	std::sort(
+		m_migrations,
+		m_migrations + m_migrationCount,
+		[](const b2ChunkMigration& a, const b2ChunkMigration& b) { return a.sourceBlocks < b.sourceBlocks; }
+	);
+
+	m_numLargeAllocations = 0;
+
+#if DEBUG_PHYSICS_WORLD_CACHE_COPY
+	m_numAllocatedObjects = source.m_numAllocatedObjects;
+#endif
+
+	/* The free lists are threaded through the copied blocks, so they need migrating too. */
+
+	for (int32 i = 0; i < b2_blockSizes; ++i)
+	{
+		b2Block** link = &m_freeLists[i];
+		*link = (b2Block*)MigrateFromSource(source.m_freeLists[i]);
+
+		while (*link)
+		{
+			link = &(*link)->next;
+			*link = (b2Block*)MigrateFromSource(*link);
+		}
+	}
+}
+
+void* b2BlockAllocator::MigrateFromSource(const void* p) const
+{
+	if (p == NULL)
+	{
+		return NULL;
+	}
+
+	const int8* const bytes = (const int8*)p;
+
+	/* The last chunk that starts at or before p. */
+
+	const b2ChunkMigration* const found = std::upper_bound(
+		m_migrations,
+		m_migrations + m_migrationCount,
+		bytes,
+		[](const int8* value, const b2ChunkMigration& m) { return value < m.sourceBlocks; }
+	) - 1;
+
+	b2Assert(found >= m_migrations);
+	b2Assert(bytes < found->sourceBlocks + b2_chunkSize);
+
+	return found->blocks + (bytes - found->sourceBlocks);
 }
@@ -50,6 +50,23 @@ public:
 	b2BlockAllocator& operator=(const b2BlockAllocator&) {
 		return *this;
 	}
+
+	/// Number of live allocations larger than b2_maxBlockSize, which live outside of the chunks.
+	int32 GetNumLargeAllocations() const {
+		return m_numLargeAllocations;
+	}
+
+	/// Make this allocator a byte-exact copy of the source, chunk by chunk.
+	/// Chunk memory already owned by this allocator is reused.
+	/// The source must have no large allocations.
+	/// Pointers inside the copied blocks still point into the source -
+	/// translate them with MigrateFromSource.
+	void CloneChunksFrom(const b2BlockAllocator& source);
+
+	/// Translate a pointer into a chunk of the source of the last CloneChunksFrom
+	/// to the corresponding location in this allocator's chunks.
+	void* MigrateFromSource(const void* p) const;
+
 private:
 
 	b2Chunk* m_chunks;
@@ -58,6 +75,19 @@ private:
 
 	b2Block* m_freeLists[b2_blockSizes];
 
+	int32 m_numLargeAllocations;
+
+	/// Chunks of the last cloned source sorted by their address, for MigrateFromSource.
+	struct b2ChunkMigration
+	{
+		const int8* sourceBlocks;
+		int8* blocks;
+	};
+
+	b2ChunkMigration* m_migrations;
+	int32 m_migrationCount;
+	int32 m_migrationSpace;
+
 #if DEBUG_PHYSICS_WORLD_CACHE_COPY
 public:
 	unsigned m_numAllocatedObjects;
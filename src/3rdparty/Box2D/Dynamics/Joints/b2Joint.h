@@ -157,6 +157,7 @@ protected:
 	friend class b2Island;
 	friend class b2GearJoint;
 	friend class physics_world_cache;
+	friend class b2world_cloner;
 
 	static b2Joint* Create(const b2JointDef* def, b2BlockAllocator* allocator);
 	static void Destroy(b2Joint* joint, b2BlockAllocator* allocator);
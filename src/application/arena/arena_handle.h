@@ -4,6 +4,8 @@
 #include "application/arena/mode_and_rules.h"
 
 #include "application/arena/arena_utils.h"
+#include "game/cosmos/cosmic_functions.h"
+#include "game/cosmos/entity_pool_headroom.h"
 #include "test_scenes/test_scene_settings.h"
 #include "view/game_drawing_settings.h"
 
@@ -29,8 +31,8 @@ class basic_arena_handle {
 
 				ensure(vars != nullptr);
 
-				if constexpr(M::needs_initial_signi) {
-					const auto in = I { *vars, self.initial_signi, self.advanced_cosm };
+				if constexpr(M::needs_initial_cosm) {
+					const auto in = I { *vars, self.initial_cosm, self.advanced_cosm };
 
 					return callback(typed_mode, in);
 				}
@@ -64,7 +66,13 @@ public:
 	maybe_const_ref_t<C, intercosm> scene;
 	maybe_const_ref_t<C, cosmos> advanced_cosm;
 	maybe_const_ref_t<C, predefined_rulesets> rulesets;
-	const cosmos_solvable_significant& initial_signi;
+
+	/*
+		The state every round starts from, already inferred,
+		so that starting a round is a copy instead of a reinference.
+	*/
+
+	const cosmos& initial_cosm;
 
 	template <class T>
 	void transfer_all_solvables(T& from) {
@@ -135,21 +143,26 @@ public:
 
 	void load_from(
 		const arena_paths& paths,
-		cosmos_solvable_significant& target_initial_signi
+		const entity_pool_headroom& headroom,
+		cosmos& target_initial_cosm,
+		shared_arena_cache* const shared = nullptr
 	) const {
 		load_arena_from(
 			paths,
 			scene,
-			rulesets
+			rulesets,
+			shared
 		);
 
-		target_initial_signi = advanced_cosm.get_solvable().significant;
+		cosmic::fit_entity_pools(advanced_cosm, headroom);
+		target_initial_cosm = advanced_cosm;
 	}
 
 	template <class S>
 	void make_default(
 		S& lua,
-		cosmos_solvable_significant& target_initial_signi
+		const entity_pool_headroom& headroom,
+		cosmos& target_initial_cosm
 	) const {
 		scene.clear();
 
@@ -188,7 +201,8 @@ public:
 		rulesets.meta.server_default = id;
 		rulesets.meta.playtest_default = id;
 
-		target_initial_signi = advanced_cosm.get_solvable().significant;
+		cosmic::fit_entity_pools(advanced_cosm, headroom);
+		target_initial_cosm = advanced_cosm;
 	}
 
 	template <class... Args>
@@ -8,11 +8,13 @@ namespace sol {
 struct intercosm;
 struct predefined_rulesets;
 struct arena_paths;
+class shared_arena_cache;
 
 void load_arena_from(
 	const arena_paths& paths,
 	intercosm& scene,
-	predefined_rulesets& rulesets
+	predefined_rulesets& rulesets,
+	shared_arena_cache* shared = nullptr
 );
 
 void make_test_online_arena(
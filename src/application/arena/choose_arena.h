@@ -6,7 +6,8 @@ inline void choose_arena(
 	sol::state& lua,
 	online_arena_handle<false> handle,
 	const server_solvable_vars& vars,
-	cosmos_solvable_significant& initial_signi
+	cosmos& initial_cosm,
+	shared_arena_cache* const shared = nullptr
 ) {
 	const auto& name = vars.current_arena;
 	const auto emigrated_session = handle.on_mode([](const auto& typed_mode) { return typed_mode.emigrate(); });
@@ -16,7 +17,8 @@ inline void choose_arena(
 
 		handle.make_default(
 			lua, 
-			initial_signi
+			vars.pool_headroom,
+			initial_cosm
 		);
 	}
 	else {
@@ -25,7 +27,9 @@ inline void choose_arena(
 
 		handle.load_from(
 			paths,
-			initial_signi
+			vars.pool_headroom,
+			initial_cosm,
+			shared
 		);
 	}
 
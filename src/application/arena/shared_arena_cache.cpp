@@ -0,0 +1,85 @@
+#include "augs/filesystem/file.h"
+#include "application/intercosm.h"
+#include "application/arena/intercosm_paths.h"
+#include "application/arena/shared_arena_cache.h"
+
+std::shared_ptr<const intercosm> shared_arena_cache::load(const intercosm_paths& paths) {
+	/* Report a missing arena just like loading it would, so that the callers fall back the same way. */
+
+	auto write_time_of = [](const augs::path_type& path) {
+		std::error_code err;
+		const auto result = std::filesystem::last_write_time(path, err);
+
+		if (err) {
+			throw augs::file_open_error("Failed to open " + path.string());
+		}
+
+		return result;
+	};
+
+	const auto write_times = std::array<augs::file_time_type, 3> {
+		write_time_of(paths.viewables_file),
+		write_time_of(paths.comm_file),
+		write_time_of(paths.solv_file)
+	};
+
+	auto lock = std::unique_lock<std::mutex>(loading_mutex);
+
+	auto& cached = loaded[paths.solv_file];
+
+	if (cached.scene == nullptr || cached.write_times != write_times) {
+		auto fresh = std::make_shared<intercosm>();
+		fresh->load_from_bytes(paths);
+
+		cached.scene = std::move(fresh);
+		cached.write_times = write_times;
+	}
+
+	return cached.scene;
+}
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+#include "game/cosmos/change_common_significant.hpp"
+
+TEST_CASE("SharedArenaCache SharesTheCommonState") {
+	const auto paths = intercosm_paths(GENERATED_FILES_DIR, "test_shared_arena");
+
+	{
+		auto source = std::make_unique<intercosm>();
+
+		source->world.change_common_significant([](cosmos_common_significant& common) {
+			common.ambient_light_color = rgba(1, 2, 3, 4);
+			return changer_callback_result::DONT_REFRESH;
+		});
+
+		source->save_as_bytes(paths);
+	}
+
+	shared_arena_cache cache;
+
+	const auto first = cache.load(paths);
+	REQUIRE(cache.load(paths) == first);
+
+	auto a = std::make_unique<intercosm>(*first);
+	auto b = std::make_unique<intercosm>(*first);
+
+	REQUIRE(&a->world.get_common_significant() == &b->world.get_common_significant());
+	REQUIRE(a->world.get_common_significant().ambient_light_color == rgba(1, 2, 3, 4));
+
+	/* An instance that changes the common state gets a copy of its own. */
+
+	a->world.change_common_significant([](cosmos_common_significant& common) {
+		common.ambient_light_color = rgba(5, 6, 7, 8);
+		return changer_callback_result::DONT_REFRESH;
+	});
+
+	REQUIRE(&a->world.get_common_significant() != &b->world.get_common_significant());
+	REQUIRE(b->world.get_common_significant().ambient_light_color == rgba(1, 2, 3, 4));
+	REQUIRE(first->world.get_common_significant().ambient_light_color == rgba(1, 2, 3, 4));
+
+	augs::remove_file(paths.viewables_file);
+	augs::remove_file(paths.comm_file);
+	augs::remove_file(paths.solv_file);
+}
+#endif
@@ -0,0 +1,33 @@
+#pragma once
+#include <array>
+#include <mutex>
+#include <memory>
+#include <unordered_map>
+
+#include "augs/filesystem/path.h"
+#include "augs/filesystem/file_time_type.h"
+
+struct intercosm;
+struct intercosm_paths;
+
+/*
+	Arenas loaded once for all the dedicated server instances hosted in a process.
+
+	Every instance copies the loaded scene, so the common state of the arena
+	- the flavours and the logical assets - is shared between them until one of them changes it.
+	The cache itself never changes a loaded scene, it only replaces it with a fresh one
+	once any of its files was written to.
+*/
+
+class shared_arena_cache {
+	struct entry {
+		std::array<augs::file_time_type, 3> write_times;
+		std::shared_ptr<const intercosm> scene;
+	};
+
+	std::mutex loading_mutex;
+	std::unordered_map<augs::path_type, entry> loaded;
+
+public:
+	std::shared_ptr<const intercosm> load(const intercosm_paths&);
+};
@@ -0,0 +1,141 @@
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "augs/log.h"
+#include "augs/filesystem/file.h"
+#include "augs/misc/timing/timer.h"
+#include "augs/string/get_type_name.h"
+#include "augs/readwrite/delta_compression.h"
+
+#include "game/cosmos/entity_solvable.h"
+#include "game/organization/all_entity_types.h"
+
+#include "application/benchmark/delta_benchmark.h"
+
+namespace {
+	/* The per-byte loop that object_delta used before, as the baseline. */
+
+	template <class T, class offset_type>
+	void per_byte_delta(const T& base, const T& enco, std::vector<std::byte>& changed_bytes, std::vector<offset_type>& changed_offsets) {
+		const auto* const base_ptr = reinterpret_cast<const std::byte*>(std::addressof(base));
+		const auto* const enco_ptr = reinterpret_cast<const std::byte*>(std::addressof(enco));
+
+		thread_local std::vector<char> diff_flags;
+		diff_flags.resize(sizeof(T));
+
+		for (std::size_t i = 0; i < sizeof(T); ++i) {
+			if (base_ptr[i] == enco_ptr[i]) {
+				diff_flags[i] = 0;
+			}
+			else {
+				diff_flags[i] = 1;
+				changed_bytes.push_back(enco_ptr[i]);
+			}
+		}
+
+		changed_offsets = augs::run_length_encoding<offset_type>(diff_flags);
+	}
+
+	template <class T>
+	std::string benchmark_object_delta(const unsigned iterations, const unsigned changed_runs) {
+		using offset_type = get_index_type_for_size_of_t<T>;
+
+		const auto base = std::make_unique<T>();
+		const auto enco = std::make_unique<T>();
+
+		{
+			auto* const enco_ptr = reinterpret_cast<std::byte*>(enco.get());
+			std::minstd_rand rng(static_cast<unsigned>(sizeof(T)));
+
+			for (unsigned r = 0; r < changed_runs; ++r) {
+				const auto run_begin = rng() % sizeof(T);
+				const auto run_end = std::min(sizeof(T), run_begin + 1 + rng() % 24);
+
+				for (auto i = run_begin; i < run_end; ++i) {
+					enco_ptr[i] ^= std::byte(0x5a);
+				}
+			}
+		}
+
+		augs::timer tm;
+
+		for (unsigned i = 0; i < iterations; ++i) {
+			std::vector<std::byte> changed_bytes;
+			std::vector<offset_type> changed_offsets;
+
+			per_byte_delta(*base, *enco, changed_bytes, changed_offsets);
+		}
+
+		const auto per_byte_us = tm.extract<std::chrono::microseconds>() / iterations;
+
+		for (unsigned i = 0; i < iterations; ++i) {
+			const auto dt = augs::object_delta<T>(*base, *enco);
+			(void)dt;
+		}
+
+		const auto object_delta_us = tm.extract<std::chrono::microseconds>() / iterations;
+
+		return typesafe_sprintf(
+			"\t\t{ \"type\": \"%x\", \"bytes\": %x, \"changed_runs\": %x, \"per_byte_us\": %x, \"object_delta_us\": %x }",
+			get_type_name<T>(),
+			sizeof(T),
+			changed_runs,
+			per_byte_us,
+			object_delta_us
+		);
+	}
+}
+
+bool perform_delta_benchmark(const delta_benchmark_settings& settings) {
+	const auto iterations = std::max(settings.iterations, 1u);
+
+	LOG("(Delta benchmark) Encoding each entity type %x times.", iterations);
+
+	std::vector<std::string> results;
+
+	auto benchmark = [&](auto dummy) {
+		using E = decltype(dummy);
+		using S = entity_solvable<E>;
+
+		if constexpr(std::is_trivially_copyable_v<S>) {
+			for (const auto changed_runs : { 0u, 4u, 64u }) {
+				results.push_back(benchmark_object_delta<S>(iterations, changed_runs));
+			}
+		}
+	};
+
+	benchmark(controlled_character());
+	benchmark(shootable_weapon());
+	benchmark(plain_missile());
+
+	std::string joined;
+
+	for (const auto& r : results) {
+		if (!joined.empty()) {
+			joined += ",\n";
+		}
+
+		joined += r;
+	}
+
+	const auto report = typesafe_sprintf(
+		"{\n"
+		"\t\"iterations\": %x,\n"
+		"\t\"results\": [\n%x\n\t]\n"
+		"}\n",
+		iterations,
+		joined
+	);
+
+	if (settings.report_path.empty()) {
+		LOG("(Delta benchmark) Report:\n%x", report);
+	}
+	else {
+		augs::save_as_text(settings.report_path, report);
+		LOG("(Delta benchmark) Report written to: %x", settings.report_path);
+	}
+
+	return true;
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include "augs/filesystem/path.h"
+
+/*
+	Headless benchmark of object_delta - the encoder of entity changes.
+
+	Encodes several entity_solvable types with a few changed runs
+	through both object_delta and the per-byte loop it replaced,
+	and reports the average microseconds per encoding of each.
+*/
+
+struct delta_benchmark_settings {
+	unsigned iterations = 0;
+	augs::path_type report_path;
+};
+
+bool perform_delta_benchmark(const delta_benchmark_settings&);
@@ -0,0 +1,89 @@
+#include <algorithm>
+
+#include "augs/log.h"
+#include "augs/templates/introspect.h"
+#include "augs/filesystem/file.h"
+
+#include "view/frame_profiler.h"
+#include "view/audiovisual_state/audiovisual_profiler.h"
+#include "application/session_profiler.h"
+
+#include "application/benchmark/headless_client.h"
+
+void report_headless_client_performance(const headless_client_report_input in) {
+	const auto frames = std::max(in.num_frames, std::size_t(1));
+
+	auto ms = [](const double secs) {
+		return secs * 1000;
+	};
+
+	auto profiler_to_json = [&](const auto& profiler) {
+		std::string result;
+
+		augs::introspect(
+			[&](const auto& label, const auto& m) {
+				using T = remove_cref<decltype(m)>;
+
+				if (m.get_num_measurements() == 0) {
+					return;
+				}
+
+				if constexpr(std::is_same_v<T, augs::time_measurements>) {
+					result += typesafe_sprintf(
+						"%x\n\t\t\"%x\": { \"total_ms\": %x, \"ms_per_frame\": %x, \"count\": %x }",
+						result.empty() ? "" : ",",
+						label,
+						ms(m.get_total_units()),
+						ms(m.get_total_units()) / frames,
+						m.get_num_measurements()
+					);
+				}
+				else {
+					result += typesafe_sprintf(
+						"%x\n\t\t\"%x\": { \"total\": %x, \"per_frame\": %x }",
+						result.empty() ? "" : ",",
+						label,
+						m.get_total_units(),
+						static_cast<double>(m.get_total_units()) / frames
+					);
+				}
+			},
+			profiler
+		);
+
+		return result;
+	};
+
+	const auto& total = in.frame.total;
+
+	const auto report = typesafe_sprintf(
+		"{\n"
+		"\t\"frames\": %x,\n"
+		"\t\"total_seconds\": %x,\n"
+		"\t\"frames_per_second\": %x,\n"
+		"\t\"frame_ms\": { \"mean\": %x, \"median\": %x, \"p99\": %x },\n"
+		"\t\"frame\": {%x\n\t},\n"
+		"\t\"session\": {%x\n\t},\n"
+		"\t\"render_commands\": {%x\n\t},\n"
+		"\t\"audiovisual\": {%x\n\t}\n"
+		"}\n",
+		in.num_frames,
+		in.total_secs,
+		in.total_secs > 0.0 ? in.num_frames / in.total_secs : 0.0,
+		total.get_num_measurements() > 0 ? ms(total.get_total_units()) / total.get_num_measurements() : 0.0,
+		ms(total.get_percentile_units(0.5)),
+		ms(total.get_percentile_units(0.99)),
+		profiler_to_json(in.frame),
+		profiler_to_json(in.session),
+		profiler_to_json(in.render_commands),
+		profiler_to_json(in.audiovisual)
+	);
+
+	if (in.settings.report_path.empty()) {
+		LOG("(Headless client) Report:\n%x", report);
+	}
+	else {
+		augs::save_as_text(in.settings.report_path, report);
+		LOG("(Headless client) Report written to: %x", in.settings.report_path);
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "augs/filesystem/path.h"
+
+struct frame_profiler;
+struct session_profiler;
+struct render_commands_profiler;
+struct audiovisual_profiler;
+
+/*
+	The regular game client, run with augs::graphics::null_renderer_backend in place of the OpenGL one.
+
+	Everything a frame normally does on the CPU - visibility jobs, illuminated rendering,
+	particle triangle generation, the game GUI - still happens,
+	but the resulting command stream is only counted instead of being sent to the GPU.
+	It can thus measure the client-side frame cost on machines with no GPU at all.
+
+	It needs a build with BUILD_OPENGL and BUILD_WINDOW_FRAMEWORK turned off,
+	so that no GL objects or windows are created in the first place.
+
+	The client either connects to a server (--connect) or replays a demo (--play-demo)
+	and quits after the given number of frames, writing the averages of all profilers as JSON.
+	Frames are only counted from the first one rendered once the gameplay is on,
+	so the time spent connecting or loading the demo never lowers the results.
+*/
+
+struct headless_client_settings {
+	bool enabled = false;
+	unsigned frames = 0;
+	augs::path_type demo_path;
+	augs::path_type report_path;
+	augs::path_type dump_path;
+};
+
+struct headless_client_report_input {
+	const headless_client_settings& settings;
+	const std::size_t num_frames;
+	const double total_secs;
+
+	const frame_profiler& frame;
+	const session_profiler& session;
+	const render_commands_profiler& render_commands;
+	const audiovisual_profiler& audiovisual;
+};
+
+void report_headless_client_performance(const headless_client_report_input);
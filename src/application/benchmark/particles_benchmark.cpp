@@ -0,0 +1,144 @@
+#include <memory>
+#include <vector>
+
+#include "augs/log.h"
+#include "augs/filesystem/file.h"
+#include "augs/misc/timing/timer.h"
+#include "augs/misc/randomization.h"
+
+#include "view/viewables/particle_types.hpp"
+#include "view/viewables/general_particle_store.h"
+#include "view/viewables/images_in_atlas_map.h"
+
+#include "application/benchmark/particles_benchmark.h"
+
+namespace {
+	auto make_benchmark_particles(const unsigned n) {
+		auto rng = randomization(0);
+
+		std::vector<general_particle> result;
+		result.reserve(n);
+
+		for (unsigned i = 0; i < n; ++i) {
+			general_particle p;
+
+			p.image_id.indirection_index = 0;
+			p.pos = { rng.randval(-2000.f, 2000.f), rng.randval(-2000.f, 2000.f) };
+			p.vel = { rng.randval(-800.f, 800.f), rng.randval(-800.f, 800.f) };
+			p.acc = { rng.randval(-100.f, 100.f), rng.randval(-100.f, 100.f) };
+			p.size = { rng.randval(2, 30), rng.randval(2, 30) };
+			p.rotation = rng.randval(0.f, 360.f);
+			p.rotation_speed = rng.randval(-720.f, 720.f);
+			p.linear_damping = rng.randval(0.f, 400.f);
+			p.angular_damping = rng.randval(0.f, 400.f);
+
+			/* Nothing dies during the benchmark so that the count stays fixed */
+			p.max_lifetime_ms = 1e9f;
+			p.shrink_when_ms_remaining = rng.randval(0.f, 500.f);
+			p.unshrinking_time_ms = rng.randval(0.f, 200.f);
+
+			result.push_back(p);
+		}
+
+		return result;
+	}
+}
+
+bool perform_particles_benchmark(const particles_benchmark_settings& settings) {
+	const auto n = settings.particles;
+	const auto frames = std::max(settings.frames, 1u);
+	const auto dt = 1 / 144.f;
+
+	LOG("(Particles benchmark) Advancing %x particles for %x frames.", n, frames);
+
+	const auto images = std::make_unique<images_in_atlas_map>();
+	const auto anims = plain_animations_pool();
+
+	auto particles = make_benchmark_particles(n);
+
+	const auto num_stores = (n + general_particle_store::capacity - 1) / general_particle_store::capacity;
+	std::vector<std::unique_ptr<general_particle_store>> stores;
+
+	for (std::size_t s = 0; s < num_stores; ++s) {
+		stores.emplace_back(std::make_unique<general_particle_store>());
+	}
+
+	for (std::size_t i = 0; i < particles.size(); ++i) {
+		stores[i / general_particle_store::capacity]->push_back(particles[i]);
+	}
+
+	std::vector<augs::vertex_triangle> triangles(2 * n);
+
+	auto per_ms = [&](const double secs) {
+		return secs > 0.0 ? static_cast<double>(n) * frames / (secs * 1000) : 0.0;
+	};
+
+	double scalar_integrate_secs = 0.0;
+	double scalar_draw_secs = 0.0;
+
+	for (unsigned f = 0; f < frames; ++f) {
+		auto integrate_timer = augs::timer();
+
+		for (auto& p : particles) {
+			p.integrate(dt);
+		}
+
+		scalar_integrate_secs += integrate_timer.get<std::chrono::seconds>();
+
+		auto draw_timer = augs::timer();
+
+		for (std::size_t i = 0; i < particles.size(); ++i) {
+			particles[i].draw_as_sprite<false>(triangles[2 * i], triangles[2 * i + 1], *images, anims);
+		}
+
+		scalar_draw_secs += draw_timer.get<std::chrono::seconds>();
+	}
+
+	double store_integrate_secs = 0.0;
+	double store_draw_secs = 0.0;
+
+	for (unsigned f = 0; f < frames; ++f) {
+		auto integrate_timer = augs::timer();
+
+		for (auto& s : stores) {
+			s->integrate(0, static_cast<int>(s->size()), dt);
+		}
+
+		store_integrate_secs += integrate_timer.get<std::chrono::seconds>();
+
+		auto draw_timer = augs::timer();
+		auto* out = triangles.data();
+
+		for (auto& s : stores) {
+			s->write_sprites(out, 0, static_cast<int>(s->size()), *images);
+			out += 2 * s->size();
+		}
+
+		store_draw_secs += draw_timer.get<std::chrono::seconds>();
+	}
+
+	const auto report = typesafe_sprintf(
+		"{\n"
+		"\t\"particles\": %x,\n"
+		"\t\"frames\": %x,\n"
+		"\t\"scalar\": { \"integrate_per_ms\": %x, \"draw_per_ms\": %x },\n"
+		"\t\"store\": { \"integrate_per_ms\": %x, \"draw_per_ms\": %x }\n"
+		"}\n",
+		n,
+		frames,
+		per_ms(scalar_integrate_secs),
+		per_ms(scalar_draw_secs),
+		per_ms(store_integrate_secs),
+		per_ms(store_draw_secs)
+	);
+
+	if (settings.report_path.empty()) {
+		LOG("(Particles benchmark) Report:\n%x", report);
+	}
+	else {
+		augs::save_as_text(settings.report_path, report);
+		LOG("(Particles benchmark) Report written to: %x", settings.report_path);
+	}
+
+	return true;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "augs/filesystem/path.h"
+
+/*
+	Headless benchmark of general particle integration and quad generation.
+
+	Advances the same set of particles through the scalar per-particle path
+	and through the structure-of-arrays store, and reports how many particles
+	each of them processes per millisecond.
+*/
+
+struct particles_benchmark_settings {
+	unsigned particles = 0;
+	unsigned frames = 300;
+	augs::path_type report_path;
+};
+
+bool perform_particles_benchmark(const particles_benchmark_settings&);
@@ -0,0 +1,301 @@
+#include <memory>
+#include <optional>
+#include <algorithm>
+
+#include "augs/log.h"
+#include "augs/templates/introspect.h"
+#include "augs/filesystem/file.h"
+#include "augs/misc/timing/timer.h"
+#include "augs/misc/allocation_counter.h"
+#include "augs/misc/randomization.h"
+
+#include "game/cosmos/entity_handle.h"
+#include "game/cosmos/cosmic_functions.h"
+#include "game/cosmos/logic_step.h"
+#include "game/organization/all_messages_includes.h"
+#include "game/modes/test_mode.h"
+
+#include "test_scenes/test_scene_settings.h"
+
+#include "application/intercosm.h"
+#include "application/benchmark/solve_benchmark.h"
+
+namespace {
+	/*
+		A bot that walks in a random direction for a while,
+		sways its crosshair and fires now and then.
+		Everything is drawn from a single seeded rng,
+		so two runs with the same settings produce identical entropies.
+	*/
+
+	struct scripted_bot {
+		mode_player_id id;
+		std::optional<game_intent_type> held_movement;
+		bool shooting = false;
+
+		void generate(randomization& rng, cosmic_entropy& into, const entity_id character) {
+			auto& commands = into[character].commands;
+
+			auto press = [&](const game_intent_type t) {
+				commands.intents.push_back({ t, intent_change::PRESSED });
+			};
+
+			auto release = [&](const game_intent_type t) {
+				commands.intents.push_back({ t, intent_change::RELEASED });
+			};
+
+			if (held_movement == std::nullopt || rng.randval(0, 29) == 0) {
+				if (held_movement) {
+					release(*held_movement);
+				}
+
+				static constexpr game_intent_type movements[] = {
+					game_intent_type::MOVE_FORWARD,
+					game_intent_type::MOVE_BACKWARD,
+					game_intent_type::MOVE_LEFT,
+					game_intent_type::MOVE_RIGHT
+				};
+
+				held_movement = movements[rng.randval(0, 3)];
+				press(*held_movement);
+			}
+
+			if (shooting) {
+				release(game_intent_type::CROSSHAIR_PRIMARY_ACTION);
+				shooting = false;
+			}
+			else if (rng.randval(0, 19) == 0) {
+				press(game_intent_type::CROSSHAIR_PRIMARY_ACTION);
+				shooting = true;
+			}
+
+			auto& crosshair = commands.motions[game_motion_type::MOVE_CROSSHAIR];
+			crosshair.x = static_cast<short>(rng.randval(-20, 20));
+			crosshair.y = static_cast<short>(rng.randval(-20, 20));
+		}
+	};
+
+	struct step_time_stats {
+		double mean = 0.0;
+		double median = 0.0;
+		double p99 = 0.0;
+		double max = 0.0;
+	};
+
+	step_time_stats calc_stats(std::vector<double> samples) {
+		step_time_stats result;
+
+		if (samples.empty()) {
+			return result;
+		}
+
+		std::sort(samples.begin(), samples.end());
+
+		double sum = 0.0;
+
+		for (const auto s : samples) {
+			sum += s;
+		}
+
+		auto at_fraction = [&](const double f) {
+			return samples[std::min(samples.size() - 1, static_cast<std::size_t>(f * samples.size()))];
+		};
+
+		result.mean = sum / samples.size();
+		result.median = at_fraction(0.5);
+		result.p99 = at_fraction(0.99);
+		result.max = samples.back();
+
+		return result;
+	}
+}
+
+bool perform_solve_benchmark(sol::state& lua, const solve_benchmark_settings& settings) {
+#if BUILD_TEST_SCENES
+	const auto scene_name = settings.minimal_scene ? "minimal_scene" : "testbed";
+
+	LOG("(Solve benchmark) Populating %x with %x bots.", scene_name, settings.bots);
+
+	auto scene = std::make_unique<intercosm>();
+	auto mode = test_mode();
+	auto ruleset = test_mode_ruleset();
+
+	{
+		auto scene_settings = test_scene_settings();
+		scene_settings.create_minimal = settings.minimal_scene;
+
+		scene->make_test_scene(lua, scene_settings, ruleset);
+	}
+
+	auto& cosm = scene->world;
+
+	std::vector<scripted_bot> bots;
+
+	for (unsigned i = 0; i < settings.bots; ++i) {
+		const auto faction = i % 2 == 0 ? faction_type::RESISTANCE : faction_type::METROPOLIS;
+		const auto id = mode.add_player({ ruleset, cosm }, faction);
+
+		if (id.is_set()) {
+			bots.push_back({ id, std::nullopt, false });
+		}
+	}
+
+	auto rng = randomization(settings.seed);
+
+	auto advance = [&]() {
+		auto entropy = mode_entropy();
+
+		for (auto& b : bots) {
+			if (const auto character = cosm[mode.lookup(b.id)]) {
+				b.generate(rng, entropy.cosmic, character.get_id());
+			}
+		}
+
+		mode.advance({ ruleset, cosm }, entropy, solver_callbacks(), solve_settings());
+	};
+
+	for (unsigned i = 0; i < settings.warmup_steps; ++i) {
+		advance();
+	}
+
+	cosm.profiler = cosmic_profiler();
+
+	LOG("(Solve benchmark) Advancing %x steps.", settings.steps);
+
+	std::vector<double> step_times;
+	step_times.reserve(settings.steps);
+
+	const auto allocations_before = augs::get_num_allocations();
+	auto total_timer = augs::timer();
+
+	for (unsigned i = 0; i < settings.steps; ++i) {
+		auto step_timer = augs::timer();
+		advance();
+		step_times.push_back(step_timer.get<std::chrono::seconds>());
+	}
+
+	const auto total_secs = total_timer.get<std::chrono::seconds>();
+	const auto num_allocations = augs::get_num_allocations() - allocations_before;
+
+	const auto steps = std::max(settings.steps, 1u);
+	const auto stats = calc_stats(step_times);
+
+	/*
+		Rebuilding and copying the inferred caches of the final state,
+		which is what rewinding, resimulation and round restarts pay for.
+	*/
+
+	const auto cache_repeats = 10u;
+
+	auto reinference_timer = augs::timer();
+
+	for (unsigned i = 0; i < cache_repeats; ++i) {
+		cosmic::reinfer_solvable(cosm);
+	}
+
+	const auto reinference_secs = reinference_timer.get<std::chrono::seconds>() / cache_repeats;
+
+	auto copy_timer = augs::timer();
+
+	for (unsigned i = 0; i < cache_repeats; ++i) {
+		const auto copied = cosm;
+		(void)copied;
+	}
+
+	const auto copy_secs = copy_timer.get<std::chrono::seconds>() / cache_repeats;
+
+	auto ms = [](const double secs) {
+		return secs * 1000;
+	};
+
+	std::string systems;
+	std::string amounts;
+
+	augs::introspect(
+		[&](const auto& label, const auto& m) {
+			using T = remove_cref<decltype(m)>;
+
+			if (m.get_num_measurements() == 0) {
+				return;
+			}
+
+			if constexpr(std::is_same_v<T, augs::time_measurements>) {
+				systems += typesafe_sprintf(
+					"%x\n\t\t\"%x\": { \"total_ms\": %x, \"ms_per_step\": %x, \"count\": %x }",
+					systems.empty() ? "" : ",",
+					label,
+					ms(m.get_total_units()),
+					ms(m.get_total_units()) / steps,
+					m.get_num_measurements()
+				);
+			}
+			else {
+				amounts += typesafe_sprintf(
+					"%x\n\t\t\"%x\": { \"total\": %x, \"per_step\": %x }",
+					amounts.empty() ? "" : ",",
+					label,
+					m.get_total_units(),
+					static_cast<double>(m.get_total_units()) / steps
+				);
+			}
+		},
+		cosm.profiler
+	);
+
+	const auto report = typesafe_sprintf(
+		"{\n"
+		"\t\"scene\": \"%x\",\n"
+		"\t\"bots\": %x,\n"
+		"\t\"seed\": %x,\n"
+		"\t\"warmup_steps\": %x,\n"
+		"\t\"steps\": %x,\n"
+		"\t\"entities\": %x,\n"
+		"\t\"total_seconds\": %x,\n"
+		"\t\"steps_per_second\": %x,\n"
+		"\t\"step_ms\": { \"mean\": %x, \"median\": %x, \"p99\": %x, \"max\": %x },\n"
+		"\t\"allocations\": %x,\n"
+		"\t\"allocations_per_step\": %x,\n"
+		"\t\"reinference_ms\": %x,\n"
+		"\t\"cosmos_copy_ms\": %x,\n"
+		"\t\"final_state_hash\": %x,\n"
+		"\t\"systems\": {%x\n\t},\n"
+		"\t\"amounts\": {%x\n\t}\n"
+		"}\n",
+		scene_name,
+		bots.size(),
+		settings.seed,
+		settings.warmup_steps,
+		settings.steps,
+		cosm.get_entities_count(),
+		total_secs,
+		total_secs > 0.0 ? settings.steps / total_secs : 0.0,
+		ms(stats.mean),
+		ms(stats.median),
+		ms(stats.p99),
+		ms(stats.max),
+		num_allocations,
+		static_cast<double>(num_allocations) / steps,
+		ms(reinference_secs),
+		ms(copy_secs),
+		cosm.calculate_solvable_signi_hash<uint32_t>(),
+		systems,
+		amounts
+	);
+
+	if (settings.report_path.empty()) {
+		LOG("(Solve benchmark) Report:\n%x", report);
+	}
+	else {
+		augs::save_as_text(settings.report_path, report);
+		LOG("(Solve benchmark) Report written to: %x", settings.report_path);
+	}
+
+	return true;
+#else
+	(void)lua;
+	(void)settings;
+
+	LOG("(Solve benchmark) The benchmark requires BUILD_TEST_SCENES=1.");
+	return false;
+#endif
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <string>
+#include "augs/filesystem/path.h"
+#include "augs/misc/randomization_declaration.h"
+
+namespace sol {
+	class state;
+}
+
+/*
+	Headless benchmark of standard_solve.
+
+	Populates a test scene, spawns a number of bots driven by scripted, seeded entropies
+	and advances the simulation for a fixed number of steps without any window, renderer or audio.
+	The results are written as JSON so that they can be compared between builds.
+*/
+
+struct solve_benchmark_settings {
+	unsigned steps = 0;
+	unsigned warmup_steps = 60;
+	unsigned bots = 8;
+	rng_seed_type seed = 0;
+	bool minimal_scene = false;
+	augs::path_type report_path;
+};
+
+bool perform_solve_benchmark(sol::state& lua, const solve_benchmark_settings&);
@@ -17,6 +17,7 @@
 #include "application/network/resolve_address.h"
 #include "application/masterserver/masterserver_requests.h"
 #include "application/masterserver/gameserver_command_readwrite.h"
+#include "application/masterserver/server_list_delta.h"
 
 constexpr auto ping_retry_interval = 1;
 constexpr auto reping_interval = 10;
@@ -46,9 +47,14 @@ bool server_list_entry::is_set() const {
 
 browse_servers_gui_state::~browse_servers_gui_state() = default;
 
+struct server_list_response {
+	std::shared_ptr<httplib::Response> response;
+	bool is_delta = false;
+};
+
 struct browse_servers_gui_internal {
 	std::optional<httplib::Client> http;
-	std::future<std::shared_ptr<httplib::Response>> future_response;
+	std::future<server_list_response> future_response;
 	netcode_socket_t socket;
 
 	std::future<official_addrs> future_official_addresses;
@@ -76,8 +82,6 @@ void browse_servers_gui_state::refresh_server_list(const browse_servers_input in
 
 	official_server_addresses.clear();
 	error_message.clear();
-	server_list.clear();
-	selected_server = {};
 
 	auto& http_opt = data->http;
 
@@ -105,13 +109,20 @@ void browse_servers_gui_state::refresh_server_list(const browse_servers_input in
 		}
 	);
 
+	const auto delta_request = typesafe_sprintf(
+		"%x?epoch=%x&since=%x",
+		server_list_delta_path,
+		server_list_epoch,
+		server_list_version
+	);
+
 	data->future_response = launch_async(
-		[&http_opt, address = in.server_list_provider]() -> std::shared_ptr<Response> {
+		[&http_opt, address = in.server_list_provider, delta_request]() -> server_list_response {
 			const auto resolved = resolve_address(address);
 			LOG(resolved.report());
 
 			if (resolved.result != resolve_result_type::OK) {
-				return nullptr;
+				return {};
 			}
 
 			auto resolved_addr = resolved.addr;
@@ -135,7 +146,14 @@ void browse_servers_gui_state::refresh_server_list(const browse_servers_input in
 			auto& http = *http_opt;
 			http.follow_location(true);
 
-			return http.Get("/server_list_binary", progress);
+			auto delta = http.Get(delta_request.c_str(), progress);
+
+			if (delta != nullptr && delta->status == 404) {
+				LOG("The server list host does not serve deltas. Downloading the full list.");
+				return { http.Get(server_list_binary_path.c_str(), progress), false };
+			}
+
+			return { delta, true };
 		}
 	);
 
@@ -494,7 +512,9 @@ bool browse_servers_gui_state::perform(const browse_servers_input in) {
 
 	const auto couldnt_download = std::string("Couldn't download the server list.\n");
 
-	auto handle_response = [&](auto response) {
+	auto handle_response = [&](const server_list_response& result) {
+		const auto& response = result.response;
+
 		if (response == nullptr) {
 			error_message = "Couldn't connect to the server list host.";
 			return;
@@ -515,7 +535,43 @@ bool browse_servers_gui_state::perform(const browse_servers_input in) {
 
 		auto stream = augs::make_read_stream(bytes.data(), bytes.size());
 
+		auto remove_entry = [&](const netcode_address_t& address) {
+			erase_if(server_list, [&](const auto& s) { return s.address == address; });
+
+			if (selected_server.address == address) {
+				selected_server = {};
+			}
+		};
+
 		try {
+			if (result.is_delta) {
+				server_list_delta_header header;
+				augs::read_bytes(stream, header);
+
+				if (header.is_full) {
+					server_list.clear();
+					selected_server = {};
+				}
+				else {
+					uint32_t num_removed = 0;
+					augs::read_bytes(stream, num_removed);
+
+					for (uint32_t i = 0; i < num_removed; ++i) {
+						remove_entry(augs::read_bytes<netcode_address_t>(stream));
+					}
+				}
+
+				server_list_epoch = header.epoch;
+				server_list_version = header.version;
+			}
+			else {
+				server_list.clear();
+				selected_server = {};
+
+				server_list_epoch = 0;
+				server_list_version = 0;
+			}
+
 			while (stream.has_unread_bytes()) {
 				server_list_entry entry;
 
@@ -523,12 +579,26 @@ bool browse_servers_gui_state::perform(const browse_servers_input in) {
 				augs::read_bytes(stream, entry.appeared_when);
 				augs::read_bytes(stream, entry.heartbeat);
 
-				server_list.emplace_back(std::move(entry));
+				if (const auto existing = find_entry(entry.address)) {
+					/* Keep the measured ping of a server that only changed its heartbeat. */
+
+					existing->appeared_when = entry.appeared_when;
+					existing->heartbeat = std::move(entry.heartbeat);
+				}
+				else {
+					server_list.emplace_back(std::move(entry));
+				}
 			}
+
+			LOG("Server list version: %x. Servers: %x", server_list_version, server_list.size());
 		}
 		catch (const augs::stream_read_error& err) {
 			error_message = "There was a problem deserializing the server list:\n" + std::string(err.what()) + "\n\nTry restarting the game and updating your client!";
 			server_list.clear();
+			selected_server = {};
+
+			server_list_epoch = 0;
+			server_list_version = 0;
 		}
 	};
 
@@ -83,6 +83,10 @@ class browse_servers_gui_state : public standard_window_mixin<browse_servers_gui
 
 	std::vector<server_list_entry> server_list;
 
+	/* Identify the last downloaded list, so that the next refresh only fetches what changed since. */
+	uint64_t server_list_epoch = 0;
+	uint64_t server_list_version = 0;
+
 	server_list_entry selected_server;
 	official_addrs official_server_addresses;
 
@@ -14,6 +14,7 @@
 #include "augs/log.h"
 #include "augs/misc/readable_bytesize.h"
 #include "augs/readwrite/stream_read_error.h"
+#include "application/setups/client/demo_container.h"
 
 class demo_chooser : keyboard_acquiring_popup {
 	using I = std::string;
@@ -62,7 +63,7 @@ public:
 					path_meta meta;
 
 					try {
-						auto t = augs::with_exceptions<std::ifstream>(full_path, std::ios::in | std::ios::binary);
+						auto t = open_demo_at_meta(full_path);
 						decltype(demo_file_meta::server_address) addr;
 						augs::read_bytes(t, addr);
 
@@ -1491,6 +1491,10 @@ void settings_gui_state::perform(
 
 					revertable_slider(SCOPE_CFG_NVP(atlas_blitting_threads), 1u, t_max);
 					revertable_slider(SCOPE_CFG_NVP(neon_regeneration_threads), 1u, t_max);
+					revertable_checkbox(SCOPE_CFG_NVP(cache_baked_atlas));
+
+					revertable_checkbox(SCOPE_CFG_NVP(cache_decoded_sounds));
+					revertable_slider(SCOPE_CFG_NVP(sound_decoding_threads), 1u, t_max);
 				}
 
 				break;
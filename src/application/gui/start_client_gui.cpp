@@ -16,6 +16,7 @@
 #include "augs/misc/imgui/imgui_enum_radio.h"
 #include "application/gui/demo_chooser.h"
 #include "application/setups/client/demo_file.h"
+#include "application/setups/client/demo_container.h"
 #include "application/gui/pretty_tabs.h"
 #include "augs/readwrite/byte_readwrite.h"
 
@@ -110,8 +111,7 @@ bool start_client_gui_state::perform(
 
 			if (!demo_path.empty() && demo_choice_result == D::SHOULD_ANALYZE) {
 				try {
-					auto t = augs::with_exceptions<std::ifstream>();
-					t.open(demo_path);
+					auto t = open_demo_at_meta(demo_path);
 
 					augs::read_bytes(t, demo_meta);
 					demo_size = readable_bytesize(augs::get_file_size(demo_path));
@@ -1,7 +1,11 @@
 #if PLATFORM_UNIX
 #include <csignal>
+#include <poll.h>
+#include <cerrno>
 #endif
-#include <shared_mutex>
+#include <queue>
+#include <cstdlib>
+#include <algorithm>
 
 #include "application/masterserver/masterserver.h"
 #include "3rdparty/cpp-httplib/httplib.h"
@@ -22,6 +26,7 @@
 #include "augs/readwrite/to_bytes.h"
 #include "application/masterserver/masterserver_requests.h"
 #include "application/masterserver/netcode_address_hash.h"
+#include "application/masterserver/server_list_delta.h"
 
 std::string ToString(const netcode_address_t&);
 
@@ -89,6 +94,27 @@ bool host_equal(const netcode_address_t& a, const netcode_address_t& b) {
 double yojimbo_time();
 void yojimbo_sleep(double);
 
+/*
+	When a server will time out unless it sends another heartbeat.
+	Entries are never updated in place - a newer heartbeat just pushes another one,
+	and the outdated ones are skipped when they reach the top of the heap.
+*/
+
+struct heartbeat_expiry {
+	double when;
+	netcode_address_t address;
+
+	bool operator>(const heartbeat_expiry& b) const {
+		return when > b.when;
+	}
+};
+
+using heartbeat_expiry_heap = std::priority_queue<
+	heartbeat_expiry,
+	std::vector<heartbeat_expiry>,
+	std::greater<heartbeat_expiry>
+>;
+
 void perform_masterserver(const config_lua_table& cfg) try {
 	using namespace httplib;
 
@@ -116,29 +142,39 @@ void perform_masterserver(const config_lua_table& cfg) try {
 
 	std::unordered_map<netcode_address_t, masterserver_client> server_list;
 
-	std::vector<std::byte> serialized_list;
-	std::shared_mutex serialized_list_mutex;
+	const auto timeout_secs = settings.server_entry_timeout_secs;
+	heartbeat_expiry_heap expiries;
 
-	httplib::Server http;
+	/* 
+		Clients remember the epoch together with the list version,
+		so that versions from before a restart are never mistaken for current ones.
+	*/
 
-	const auto masterserver_dump_path = augs::path_type(USER_FILES_DIR) / "masterserver.dump";
+	const auto list_epoch = static_cast<uint64_t>(augs::date_time::secs_since_epoch() * 1000);
+	published_server_list published_list(list_epoch);
 
-	auto reserialize_list = [&]() {
-		MSR_LOG("Reserializing the server list.");
+	httplib::Server http;
 
-		std::lock_guard<std::shared_mutex> lock(serialized_list_mutex);
+	const auto masterserver_dump_path = augs::path_type(USER_FILES_DIR) / "masterserver.dump";
 
-		serialized_list.clear();
+	auto publish = [&](const netcode_address_t& address, const masterserver_client& server) {
+		MSR_LOG("Republishing the server at %x.", ::ToString(address));
 
-		auto ss = augs::ref_memory_stream(serialized_list);
+		std::vector<std::byte> serialized_entry;
 
-		for (auto& server : server_list) {
-			const auto address = server.first;
+		{
+			auto ss = augs::ref_memory_stream(serialized_entry);
 
 			augs::write_bytes(ss, address);
-			augs::write_bytes(ss, server.second.meta.appeared_when);
-			augs::write_bytes(ss, server.second.last_heartbeat);
+			augs::write_bytes(ss, server.meta.appeared_when);
+			augs::write_bytes(ss, server.last_heartbeat);
 		}
+
+		published_list.set(address, std::move(serialized_entry));
+	};
+
+	auto expect_heartbeat = [&](const netcode_address_t& address, const masterserver_client& server) {
+		expiries.push({ server.time_of_last_heartbeat + timeout_secs, address });
 	};
 
 	auto dump_server_list_to_file = [&]() {
@@ -146,7 +182,7 @@ void perform_masterserver(const config_lua_table& cfg) try {
 
 		if (n > 0) {
 			LOG("Saving %x servers to %x", n, masterserver_dump_path);
-			augs::bytes_to_file(std::as_const(serialized_list), masterserver_dump_path);
+			augs::bytes_to_file(published_list.write_full_list(), masterserver_dump_path);
 		}
 		else {
 			LOG("The server list is empty: deleting the dump file.");
@@ -171,10 +207,11 @@ void perform_masterserver(const config_lua_table& cfg) try {
 
 				entry.time_of_last_heartbeat = current_time;
 
-				server_list.try_emplace(address, std::move(entry));
+				if (const auto it = server_list.try_emplace(address, std::move(entry)); it.second) {
+					publish(address, it.first->second);
+					expect_heartbeat(address, it.first->second);
+				}
 			}
-
-			reserialize_list();
 		}
 		catch (const augs::file_open_error& err) {
 			LOG("Could not load the server list file: %x.\nStarting from an empty server list. Details:\n%x", masterserver_dump_path, err.what());
@@ -190,30 +227,55 @@ void perform_masterserver(const config_lua_table& cfg) try {
 
 	load_server_list_from_file();
 
-	auto make_list_streamer_lambda = [&]() {
-		return [data=serialized_list](uint64_t offset, uint64_t length, DataSink sink) {
+	auto make_list_streamer_lambda = [&](std::vector<std::byte>&& bytes) {
+		return [data=std::move(bytes)](uint64_t offset, uint64_t length, DataSink sink) {
 			sink(reinterpret_cast<const char*>(&data[offset]), length);
 		};
 	};
 
 	auto remove_from_list = [&](const auto& by_external_addr) {
 		server_list.erase(by_external_addr);
-		reserialize_list();
+		published_list.erase(by_external_addr);
 	};
 
 	auto define_http_server = [&]() {
-		http.Get("/server_list_binary", [&](const Request&, Response& res) {
-			std::shared_lock<std::shared_mutex> lock(serialized_list_mutex);
+		http.Get(server_list_binary_path.c_str(), [&](const Request&, Response& res) {
+			auto serialized_list = published_list.write_full_list();
 
 			if (serialized_list.size() > 0) {
 				MSR_LOG("List request arrived. Sending list of size: %x", serialized_list.size());
 
+				const auto n = serialized_list.size();
+
 				res.set_content_provider(
-					serialized_list.size(),
-					make_list_streamer_lambda()
+					n,
+					make_list_streamer_lambda(std::move(serialized_list))
 				);
 			}
 		});
+
+		http.Get(server_list_delta_path.c_str(), [&](const Request& req, Response& res) {
+			auto param_or_zero = [&](const char* const key) {
+				if (req.has_param(key)) {
+					return std::strtoull(req.get_param_value(key).c_str(), nullptr, 10);
+				}
+
+				return 0ull;
+			};
+
+			const auto client_epoch = static_cast<uint64_t>(param_or_zero("epoch"));
+			const auto since_version = static_cast<uint64_t>(param_or_zero("since"));
+
+			auto delta = published_list.write_delta(client_epoch, since_version);
+			const auto n = delta.size();
+
+			MSR_LOG("Delta list request arrived (since: %x). Sending %x bytes.", since_version, n);
+
+			res.set_content_provider(
+				n,
+				make_list_streamer_lambda(std::move(delta))
+			);
+		});
 	};
 
 	define_http_server();
@@ -227,6 +289,22 @@ void perform_masterserver(const config_lua_table& cfg) try {
 
 	uint8_t packet_buffer[NETCODE_MAX_PACKET_BYTES];
 
+#if PLATFORM_UNIX
+	std::vector<pollfd> polled_sockets;
+
+	for (const auto& s : udp_command_sockets) {
+		pollfd p;
+		p.fd = s.socket.handle;
+		p.events = POLLIN;
+		p.revents = 0;
+
+		polled_sockets.push_back(p);
+	}
+
+	/* Bounds the time to notice a shutdown signal if it does not interrupt poll. */
+	const auto max_wait_secs = 1.0;
+#endif
+
 	while (true) {
 #if PLATFORM_UNIX
 		if (signal_status != 0) {
@@ -247,14 +325,7 @@ void perform_masterserver(const config_lua_table& cfg) try {
 
 		const auto current_time = yojimbo_time();
 
-		auto process_socket_messages = [&](auto& socket) {
-			netcode_address_t from;
-			const auto packet_bytes = netcode_socket_receive_packet(&socket, &from, packet_buffer, NETCODE_MAX_PACKET_BYTES);
-
-			if (packet_bytes < 1) {
-				return;
-			}
-
+		auto process_socket_message = [&](auto& socket, const netcode_address_t from, const int packet_bytes) {
 			MSR_LOG("Received packet bytes: %x", packet_bytes);
 
 			try {
@@ -296,8 +367,10 @@ void perform_masterserver(const config_lua_table& cfg) try {
 						MSR_LOG_NVPS(is_new_server, heartbeats_mismatch);
 
 						if (is_new_server || heartbeats_mismatch) {
-							reserialize_list();
+							publish(from, server_entry);
 						}
+
+						expect_heartbeat(from, server_entry);
 					}
 					else if constexpr(std::is_same_v<R, masterserver_in::tell_me_my_address>) {
 						masterserver_out::tell_me_my_address response;
@@ -386,36 +459,51 @@ void perform_masterserver(const config_lua_table& cfg) try {
 		};
 
 		for (auto& s : udp_command_sockets) {
-			process_socket_messages(s.socket);
-		}
+			auto& socket = s.socket;
 
-		const auto timeout_secs = settings.server_entry_timeout_secs;
+			while (true) {
+				netcode_address_t from;
+				const auto packet_bytes = netcode_socket_receive_packet(&socket, &from, packet_buffer, NETCODE_MAX_PACKET_BYTES);
 
-		auto process_entry_logic = [&](auto& server_entry) {
-			(void)server_entry;
-		};
-
-		auto erase_if_dead = [&](auto& server_entry) {
-			const bool timed_out = current_time - server_entry.second.time_of_last_heartbeat >= timeout_secs;
+				if (packet_bytes < 1) {
+					break;
+				}
 
-			if (timed_out) {
-				LOG("The server at %x (%x) has timed out.", ::ToString(server_entry.first), server_entry.second.last_heartbeat.server_name);
-			}
-			else {
-				process_entry_logic(server_entry);
+				process_socket_message(socket, from, packet_bytes);
 			}
+		}
 
-			return timed_out;
-		};
+		while (!expiries.empty() && expiries.top().when <= current_time) {
+			const auto address = expiries.top().address;
+			expiries.pop();
 
-		const auto previous_size = server_list.size();
-		erase_if(server_list, erase_if_dead);
+			if (const auto entry = mapped_or_nullptr(server_list, address)) {
+				const bool timed_out = current_time - entry->time_of_last_heartbeat >= timeout_secs;
 
-		if (previous_size != server_list.size()) {
-			reserialize_list();
+				if (timed_out) {
+					LOG("The server at %x (%x) has timed out.", ::ToString(address), entry->last_heartbeat.server_name);
+					remove_from_list(address);
+				}
+			}
 		}
 
+#if PLATFORM_UNIX
+		{
+			/* Sleep until a packet arrives or the earliest server is due to time out. */
+
+			const auto secs_to_next_expiry = expiries.empty() ? max_wait_secs : expiries.top().when - yojimbo_time();
+			const auto wait_secs = std::clamp(secs_to_next_expiry, 0.0, max_wait_secs);
+
+			const auto result = ::poll(polled_sockets.data(), polled_sockets.size(), static_cast<int>(wait_secs * 1000) + 1);
+
+			if (result < 0 && errno != EINTR) {
+				LOG("poll failed with errno: %x", errno);
+				yojimbo_sleep(settings.sleep_ms / 1000);
+			}
+		}
+#else
 		yojimbo_sleep(settings.sleep_ms / 1000);
+#endif
 	}
 
 	LOG("Stopping the HTTP masterserver.");
@@ -0,0 +1,211 @@
+#include <mutex>
+#include <algorithm>
+
+#include "application/masterserver/server_list_delta.h"
+#include "augs/readwrite/memory_stream.h"
+#include "augs/readwrite/byte_readwrite.h"
+
+published_server_list::published_server_list(const uint64_t epoch) : epoch(epoch) {}
+
+void published_server_list::set(const netcode_address_t& address, std::vector<std::byte> serialized_entry) {
+	std::unique_lock<std::shared_mutex> lock(mutex);
+
+	auto& e = entries[address];
+
+	if (e.bytes == serialized_entry) {
+		return;
+	}
+
+	e.version = ++version;
+	e.bytes = std::move(serialized_entry);
+}
+
+void published_server_list::erase(const netcode_address_t& address) {
+	std::unique_lock<std::shared_mutex> lock(mutex);
+
+	if (entries.erase(address) == 0) {
+		return;
+	}
+
+	removals.push_back({ ++version, address });
+
+	if (removals.size() > max_remembered_removals) {
+		/*
+			A client at the version of the forgotten removal has already seen it,
+			but any older client could miss it.
+		*/
+
+		oldest_complete_version = removals.front().version;
+		removals.pop_front();
+	}
+}
+
+std::vector<std::byte> published_server_list::write_full_list() const {
+	std::shared_lock<std::shared_mutex> lock(mutex);
+
+	std::vector<std::byte> output;
+
+	for (const auto& e : entries) {
+		output.insert(output.end(), e.second.bytes.begin(), e.second.bytes.end());
+	}
+
+	return output;
+}
+
+std::vector<std::byte> published_server_list::write_delta(const uint64_t client_epoch, const uint64_t since_version) const {
+	std::shared_lock<std::shared_mutex> lock(mutex);
+
+	std::vector<std::byte> output;
+
+	{
+		auto ss = augs::ref_memory_stream(output);
+
+		server_list_delta_header header;
+		header.epoch = epoch;
+		header.version = version;
+		header.is_full =
+			client_epoch != epoch
+			|| since_version < oldest_complete_version
+			|| since_version > version
+		;
+
+		augs::write_bytes(ss, header);
+
+		const auto since = header.is_full ? 0 : since_version;
+
+		if (!header.is_full) {
+			const auto first_unseen = std::find_if(
+				removals.begin(),
+				removals.end(),
+				[since](const auto& r) { return r.version > since; }
+			);
+
+			augs::write_bytes(ss, static_cast<uint32_t>(std::distance(first_unseen, removals.end())));
+
+			for (auto it = first_unseen; it != removals.end(); ++it) {
+				augs::write_bytes(ss, it->address);
+			}
+		}
+
+		for (const auto& e : entries) {
+			if (e.second.version > since) {
+				ss.write(e.second.bytes.data(), e.second.bytes.size());
+			}
+		}
+	}
+
+	return output;
+}
+
+uint64_t published_server_list::get_version() const {
+	std::shared_lock<std::shared_mutex> lock(mutex);
+	return version;
+}
+
+std::size_t published_server_list::size() const {
+	std::shared_lock<std::shared_mutex> lock(mutex);
+	return entries.size();
+}
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+#include "augs/readwrite/to_bytes.h"
+
+namespace {
+	netcode_address_t make_test_address(const uint8_t last_octet) {
+		netcode_address_t address {};
+		address.type = NETCODE_ADDRESS_IPV4;
+		address.data.ipv4[0] = 10;
+		address.data.ipv4[3] = last_octet;
+		address.port = 8000;
+
+		return address;
+	}
+
+	std::vector<std::byte> make_test_entry(const uint8_t tag) {
+		return std::vector<std::byte>(4, std::byte(tag));
+	}
+
+	struct read_delta {
+		server_list_delta_header header;
+		std::vector<netcode_address_t> removed;
+		std::vector<std::byte> entries;
+
+		read_delta(const std::vector<std::byte>& bytes) {
+			auto stream = augs::make_read_stream(bytes.data(), bytes.size());
+
+			augs::read_bytes(stream, header);
+
+			if (!header.is_full) {
+				uint32_t n = 0;
+				augs::read_bytes(stream, n);
+				removed.resize(n);
+
+				for (auto& r : removed) {
+					augs::read_bytes(stream, r);
+				}
+			}
+
+			entries.assign(bytes.end() - stream.get_unread_bytes(), bytes.end());
+		}
+	};
+}
+
+TEST_CASE("PublishedServerList Deltas") {
+	published_server_list list(1234);
+
+	const auto a = make_test_address(1);
+	const auto b = make_test_address(2);
+
+	list.set(a, make_test_entry(1));
+	list.set(b, make_test_entry(2));
+
+	const auto v2 = list.get_version();
+	REQUIRE(v2 == 2);
+
+	{
+		const auto full = read_delta(list.write_delta(0, 0));
+		REQUIRE(full.header.is_full);
+		REQUIRE(full.header.epoch == 1234);
+		REQUIRE(full.entries.size() == 8);
+	}
+
+	/* An identical heartbeat must not bump the version. */
+	list.set(a, make_test_entry(1));
+	REQUIRE(list.get_version() == v2);
+
+	{
+		const auto nothing = read_delta(list.write_delta(1234, v2));
+		REQUIRE(!nothing.header.is_full);
+		REQUIRE(nothing.removed.empty());
+		REQUIRE(nothing.entries.empty());
+	}
+
+	list.set(a, make_test_entry(3));
+	list.erase(b);
+
+	{
+		const auto delta = read_delta(list.write_delta(1234, v2));
+		REQUIRE(!delta.header.is_full);
+		REQUIRE(delta.header.version == 4);
+		REQUIRE(delta.removed.size() == 1);
+		REQUIRE(delta.removed[0] == b);
+		REQUIRE(delta.entries == make_test_entry(3));
+	}
+
+	/* A different epoch or a version from the future gets the full list. */
+	REQUIRE(read_delta(list.write_delta(1, v2)).header.is_full);
+	REQUIRE(read_delta(list.write_delta(1234, 100)).header.is_full);
+
+	/* Once a removal is forgotten, older clients must get the full list. */
+
+	for (std::size_t i = 0; i < published_server_list::max_remembered_removals + 1; ++i) {
+		list.set(b, make_test_entry(2));
+		list.erase(b);
+	}
+
+	REQUIRE(read_delta(list.write_delta(1234, v2)).header.is_full);
+	REQUIRE(!read_delta(list.write_delta(1234, list.get_version())).header.is_full);
+	REQUIRE(list.write_full_list() == make_test_entry(3));
+}
+#endif
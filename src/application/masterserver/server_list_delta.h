@@ -0,0 +1,78 @@
+#pragma once
+#include <deque>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "augs/pad_bytes.h"
+#include "augs/network/netcode_utils.h"
+#include "application/masterserver/netcode_address_hash.h"
+
+/*
+	Versioned server list.
+
+	Every change to the list bumps its version.
+	A client that remembers the epoch and version of its last download
+	requests only the servers that were added, removed or changed since then:
+
+		GET /server_list_delta?epoch=E&since=V
+
+	The response body consists of:
+	- server_list_delta_header,
+	- if it is not a full list: a uint32_t count followed by that many netcode_address_t of removed servers,
+	- entries until the end of the body, each serialized exactly like in /server_list_binary.
+
+	A full list is sent whenever the epoch does not match (e.g. the masterserver was restarted)
+	or the masterserver no longer remembers all removals since the requested version.
+*/
+
+inline const auto server_list_binary_path = std::string("/server_list_binary");
+inline const auto server_list_delta_path = std::string("/server_list_delta");
+
+struct server_list_delta_header {
+	uint64_t epoch = 0;
+	uint64_t version = 0;
+	bool is_full = true;
+	pad_bytes<7> pad;
+};
+
+class published_server_list {
+	struct entry {
+		uint64_t version = 0;
+		std::vector<std::byte> bytes;
+	};
+
+	struct removal {
+		uint64_t version = 0;
+		netcode_address_t address;
+	};
+
+	const uint64_t epoch;
+
+	uint64_t version = 0;
+
+	/* Deltas are complete only for clients that are at this version or newer. */
+	uint64_t oldest_complete_version = 0;
+
+	std::unordered_map<netcode_address_t, entry> entries;
+	std::deque<removal> removals;
+
+	mutable std::shared_mutex mutex;
+
+public:
+	static constexpr std::size_t max_remembered_removals = 4096;
+
+	explicit published_server_list(uint64_t epoch);
+
+	/* Adds or replaces the serialized entry of a server. */
+	void set(const netcode_address_t&, std::vector<std::byte> serialized_entry);
+	void erase(const netcode_address_t&);
+
+	std::vector<std::byte> write_full_list() const;
+	std::vector<std::byte> write_delta(uint64_t client_epoch, uint64_t since_version) const;
+
+	uint64_t get_version() const;
+	std::size_t size() const;
+};
@@ -0,0 +1,79 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "augs/misc/compress.h"
+#include "application/setups/server/rcon_level.h"
+
+/*
+	The initial arena state is serialized once per step and then compressed in independent chunks.
+
+	This way the compression can run on a worker thread,
+	the client can decompress every chunk as soon as it arrives,
+	and the same chunks can be sent to all clients that join during the same step.
+*/
+
+constexpr std::size_t initial_arena_state_chunk_size_v = 256 * 1024;
+constexpr std::size_t max_initial_arena_state_size_v = 100 * 1024 * 1024;
+
+/* 
+	At most this many chunks are queued to a client at once,
+	so that their blocks never exhaust the memory yojimbo reserves per client.
+	The next batch is queued once the previous one is acknowledged.
+*/
+
+constexpr uint32_t initial_arena_state_chunks_per_batch_v = 4;
+
+inline std::size_t num_initial_arena_state_chunks(const std::size_t uncompressed_size) {
+	return (uncompressed_size + initial_arena_state_chunk_size_v - 1) / initial_arena_state_chunk_size_v;
+}
+
+inline std::size_t initial_arena_state_chunk_offset(const std::size_t chunk_index) {
+	return chunk_index * initial_arena_state_chunk_size_v;
+}
+
+inline std::size_t initial_arena_state_chunk_length(const std::size_t uncompressed_size, const std::size_t chunk_index) {
+	return std::min(initial_arena_state_chunk_size_v, uncompressed_size - initial_arena_state_chunk_offset(chunk_index));
+}
+
+struct compressed_initial_arena_state {
+	uint32_t uncompressed_size = 0;
+	std::vector<std::vector<std::byte>> chunks;
+};
+
+inline compressed_initial_arena_state compress_initial_arena_state(const std::vector<std::byte>& serialized) {
+	compressed_initial_arena_state result;
+	result.uncompressed_size = static_cast<uint32_t>(serialized.size());
+	result.chunks.resize(num_initial_arena_state_chunks(serialized.size()));
+
+	auto state = augs::make_compression_state();
+
+	for (std::size_t i = 0; i < result.chunks.size(); ++i) {
+		augs::compress(
+			state,
+			serialized.data() + initial_arena_state_chunk_offset(i),
+			initial_arena_state_chunk_length(serialized.size(), i),
+			result.chunks[i]
+		);
+	}
+
+	return result;
+}
+
+/* Chunks of the initial arena state received so far by the client. */
+
+struct initial_arena_state_progress {
+	uint32_t uncompressed_size = 0;
+	uint32_t next_chunk = 0;
+
+	bool complete() const {
+		return next_chunk > 0 && next_chunk == num_initial_arena_state_chunks(uncompressed_size);
+	}
+};
+
+/* The part of the initial arena state that differs between clients joining at the same step. */
+
+struct initial_arena_state_for_client {
+	uint32_t client_id = 0;
+	rcon_level_type rcon = rcon_level_type::DENIED;
+};
@@ -1,11 +1,17 @@
 #pragma once
 #include "game/cosmos/entity_pools.h"
 #include "game/cosmos/pool_size_type.h"
+#include "augs/misc/constant_size_vector.h"
+#include "augs/misc/arena_sized_vector.h"
 
 template <class E, class T>
 using entity_property_vector = std::conditional_t<
 	statically_allocate_entities,
-	augs::constant_size_vector<T, E::statically_allocated_entities, true>,
+	std::conditional_t<
+		arena_sized_entity_pools,
+		augs::arena_sized_vector<T, E::statically_allocated_entities>,
+		augs::constant_size_vector<T, E::statically_allocated_entities, true>
+	>,
 	std::vector<T>
 >;
 
@@ -60,6 +60,7 @@ namespace net_messages {
 		serialize_uint32(stream, payload.net.jitter.buffer_at_least_steps);
 		serialize_uint32(stream, payload.net.jitter.buffer_at_least_ms);
 		serialize_int(stream, payload.net.jitter.max_commands_to_squash_at_once, 0, 255);
+		serialize_bool(stream, payload.as_relay);
 
 		return true;
 	}
@@ -100,6 +101,15 @@ namespace net_messages {
 		return true;
 	}
 
+	template <typename Stream>
+	bool state_hash_breakdown::Serialize(Stream& stream) {
+		if (!serialize_trivial_as_bytes(stream, payload)) {
+			return false;
+		}
+
+		return true;
+	}
+
 	template <typename Stream>
 	bool public_settings_update::Serialize(Stream& stream) {
 		if (!serialize(stream, payload.subject_id)) {
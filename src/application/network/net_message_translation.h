@@ -47,6 +47,25 @@ constexpr std::size_t max_server_step_size_v =
 	- yojimbo::ConservativeMessageHeaderBits / 8
 ;
 
+/*
+	Reads the state written by serialize_initial_arena_state.
+	Throws augs::stream_read_error if the bytes are malformed.
+*/
+
+inline void deserialize_initial_arena_state(
+	const std::vector<std::byte>& serialized,
+	const cosmos_solvable_significant& initial_signi,
+	cosmos_solvable_significant& signi,
+	online_mode_and_rules& mode
+) {
+	auto s = net_solvable_stream_cref(initial_signi, serialized);
+
+	augs::read_bytes(s, signi);
+	augs::read_bytes(s, mode);
+
+	signi.fix_entity_pool_capacities();
+}
+
 namespace net_messages {
 	template <class Stream>
 	bool serialize(Stream& s, total_mode_player_entropy& p) {
@@ -331,6 +350,38 @@ namespace net_messages {
 		return safe_write(bytes, input);
 	}
 
+	inline bool preserialize(::preserialized_server_step_entropy& output, ::networked_server_step_entropy& input) {
+		output.bytes.resize(max_server_step_size_v);
+		return safe_write(output.bytes, input);
+	}
+
+	inline bool server_step_entropy::write_payload(
+		const ::preserialized_server_step_entropy& input,
+		const ::prestep_client_context& context
+	) {
+		bytes = input.bytes;
+
+#if CONTEXTS_SEPARATE
+		(void)context;
+#else
+		/* 
+			The context is serialized first as a full 8-bit integer,
+			and yojimbo's bitpacker flushes words in little endian,
+			so num_entropies_accepted always occupies the very first byte.
+		*/
+
+		static_assert(sizeof(context.num_entropies_accepted) == 1);
+
+		if (bytes.empty()) {
+			return false;
+		}
+
+		bytes[0] = static_cast<std::byte>(context.num_entropies_accepted);
+#endif
+
+		return true;
+	}
+
 	inline bool client_entropy::read_payload(
 		total_client_entropy& output
 	) {
@@ -421,6 +472,20 @@ namespace net_messages {
 		return true;
 	}
 
+	inline bool state_hash_breakdown::write_payload(
+		const decltype(state_hash_breakdown::payload)& input
+	) {
+		payload = input;
+		return true;
+	}
+
+	inline bool state_hash_breakdown::read_payload(
+		decltype(state_hash_breakdown::payload)& output
+	) {
+		output = payload;
+		return true;
+	}
+
 	inline bool public_settings_update::write_payload(
 		const decltype(public_settings_update::payload)& input
 	) {
@@ -519,47 +584,54 @@ namespace net_messages {
 		return true;
 	}
 
-	inline bool initial_arena_state::read_payload(
+	inline bool initial_arena_state_chunk::read_payload(
 		augs::serialization_buffers& buffers,
-		const cosmos_solvable_significant& initial_signi,
-		const initial_arena_state_payload<false> in
+		::initial_arena_state_progress& progress
 	) {
 		const auto data = reinterpret_cast<const std::byte*>(GetBlockData());
 		const auto size = static_cast<std::size_t>(GetBlockSize());
 
-		NSR_LOG("RECEIVING INITIAL STATE");
-
-		NSR_LOG("Compressed stream size: %x", size);
+		constexpr auto header_size = 2 * sizeof(uint32_t);
 
-		const bool size_written_properly = size >= sizeof(uint32_t);
-
-		if (!size_written_properly) {
+		if (size < header_size) {
 			return false;
 		}
 
-		const auto uncompressed_size = *reinterpret_cast<const uint32_t*>(data);
-	
-		NSR_LOG("Uncompressed size: %x", uncompressed_size);
+		uint32_t uncompressed_size = 0;
+		uint32_t chunk_index = 0;
 
-		/*
-			TODO: validate uncompressed_size with some predefined max solvable size.
-		*/
+		std::memcpy(&uncompressed_size, data, sizeof(uint32_t));
+		std::memcpy(&chunk_index, data + sizeof(uint32_t), sizeof(uint32_t));
+
+		if (chunk_index == 0) {
+			NSR_LOG("RECEIVING INITIAL STATE");
+			NSR_LOG("Uncompressed size: %x", uncompressed_size);
+
+			if (uncompressed_size == 0 || uncompressed_size > max_initial_arena_state_size_v) {
+				return false;
+			}
+
+			progress.uncompressed_size = uncompressed_size;
+			progress.next_chunk = 0;
 
-		if (uncompressed_size > 100 * 1024 * 1024) {
+			buffers.serialization.resize(uncompressed_size);
+		}
+		else if (uncompressed_size != progress.uncompressed_size || chunk_index != progress.next_chunk) {
+			LOG("Initial state chunk %x arrived out of order (expected %x).", chunk_index, progress.next_chunk);
 			return false;
 		}
 
-		auto& uncompressed_buf = buffers.serialization;
-		uncompressed_buf.resize(uncompressed_size);
+		if (chunk_index >= num_initial_arena_state_chunks(uncompressed_size)) {
+			return false;
+		}
 
 		try {
 			augs::decompress(
-				data + sizeof(uint32_t),
-				size - sizeof(uint32_t),
-				uncompressed_buf
+				data + header_size,
+				size - header_size,
+				buffers.serialization.data() + initial_arena_state_chunk_offset(chunk_index),
+				initial_arena_state_chunk_length(uncompressed_size, chunk_index)
 			);
-
-			NSR_LOG("Successfully uncompressed the initial state.");
 		}
 		catch (const augs::decompression_error& err) {
 			LOG("Failed to decompress the initial state. Server might be malicious.");
@@ -568,75 +640,100 @@ namespace net_messages {
 			return false;
 		}
 
-		auto s = net_solvable_stream_cref(initial_signi, uncompressed_buf);
-
-		augs::read_bytes(s, in.signi);
-		augs::read_bytes(s, in.mode);
-		augs::read_bytes(s, in.client_id);
-		augs::read_bytes(s, in.rcon);
-
-		NSR_LOG_NVPS(in.client_id);
+		++progress.next_chunk;
 
 		return true;
 	}
 
 	template <class F>
-	inline bool initial_arena_state::write_payload(
+	inline bool initial_arena_state_chunk::write_payload(
 		F block_allocator,
+		const ::compressed_initial_arena_state& state,
+		const uint32_t& chunk_index
+	) {
+		const auto& chunk = state.chunks.at(chunk_index);
+
+		auto block = block_allocator(2 * sizeof(uint32_t) + chunk.size());
+
+		std::memcpy(block, &state.uncompressed_size, sizeof(uint32_t));
+		std::memcpy(block + sizeof(uint32_t), &chunk_index, sizeof(uint32_t));
+		std::memcpy(block + 2 * sizeof(uint32_t), chunk.data(), chunk.size());
+
+		return true;
+	}
+
+	inline bool initial_arena_state::read_payload(
 		augs::serialization_buffers& buffers,
+		const ::initial_arena_state_progress& progress,
 		const cosmos_solvable_significant& initial_signi,
-		const all_entity_flavours& all_flavours,
-		const initial_arena_state_payload<true> in
+		const initial_arena_state_payload<false> in
 	) {
-		auto write_all_to = [&in](auto& s) {
-			augs::write_bytes(s, in.signi);
-			augs::write_bytes(s, in.mode);
-			augs::write_bytes(s, in.client_id);
-			augs::write_bytes(s, in.rcon);
-		};
-
-		NSR_LOG("SENDING INITIAL STATE");
+		if (!progress.complete()) {
+			LOG("The initial state was completed before all of its chunks arrived. Server might be malicious.");
+			return false;
+		}
 
 		{
-			NSR_LOG("STAGE: ESTIMATION");
+			auto s = cref_net_stream(bytes);
 
-			augs::byte_counter_stream s;
-			write_all_to(s);
-			buffers.serialization.reserve(s.size());
+			augs::read_bytes(s, in.client_id);
+			augs::read_bytes(s, in.rcon);
+		}
 
-			NSR_LOG("Reserved size: %x", s.size());
+		::deserialize_initial_arena_state(buffers.serialization, initial_signi, in.signi, in.mode);
 
-			{
-				auto s = buffers.make_serialization_stream<net_solvable_stream_ref>(all_flavours, initial_signi, in.signi);
-				write_all_to(s);
-			}
+		NSR_LOG("Successfully read the initial state.");
+		NSR_LOG_NVPS(in.client_id);
 
-			NSR_LOG("Result stream length: %x", buffers.serialization.size());
-		}
+		return true;
+	}
 
-		auto& c = buffers.compressed;
+	inline bool initial_arena_state::write_payload(
+		const ::initial_arena_state_for_client& in
+	) {
+		auto s = ref_net_stream(bytes);
 
-		{
-			NSR_LOG("STAGE: COMPRESSION");
+		augs::write_bytes(s, in.client_id);
+		augs::write_bytes(s, in.rcon);
 
-			c.clear();
+		return true;
+	}
+}
 
-			{
-				auto s = augs::ref_memory_stream(c);
-				const auto uncompressed_size = static_cast<uint32_t>(buffers.serialization.size());
-				augs::write_bytes(s, uncompressed_size);
+/*
+	Serializes the part of the initial state that is common to all clients joining at this step.
+	The result is left in buffers.serialization.
+*/
+
+inline void serialize_initial_arena_state(
+	std::vector<std::byte>& serialized,
+	const cosmos_solvable_significant& initial_signi,
+	const all_entity_flavours& all_flavours,
+	const cosmos_solvable_significant& signi,
+	const online_mode_and_rules& mode
+) {
+	auto write_all_to = [&](auto& s) {
+		augs::write_bytes(s, signi);
+		augs::write_bytes(s, mode);
+	};
 
-				NSR_LOG("Uncompressed size: %x", uncompressed_size);
-			}
+	NSR_LOG("SERIALIZING INITIAL STATE");
 
-			augs::compress(buffers.compression_state, buffers.serialization, c);
+	{
+		augs::byte_counter_stream s;
+		write_all_to(s);
+		serialized.reserve(s.size());
 
-			NSR_LOG("Compressed stream size: %x", c.size());
-		}
+		NSR_LOG("Reserved size: %x", s.size());
+	}
 
-		auto block = block_allocator(c.size());
-		std::memcpy(block, c.data(), c.size());
+	{
+		serialized.clear();
 
-		return true;
+		auto s = net_solvable_stream_ref(all_flavours, initial_signi, signi, serialized);
+		write_all_to(s);
 	}
+
+	NSR_LOG("Result stream length: %x", serialized.size());
 }
+
@@ -2,6 +2,7 @@
 #include "application/network/server_adapter.h"
 #include "application/network/client_adapter.h"
 
+#include "augs/ensure.h"
 #include "augs/network/network_types.h"
 #include "augs/readwrite/memory_stream.h"
 #include "hypersomnia_version.h"
@@ -29,6 +30,10 @@ void GameAdapter::OnServerClientDisconnected(const client_id_type clientIndex) {
 }
 
 void server_adapter::stop() {
+	for (std::size_t i = 0; i < held.size(); ++i) {
+		discard_held_messages(static_cast<client_id_type>(i));
+	}
+
 	server.Stop();
 }
 
@@ -37,9 +42,79 @@ void server_adapter::client_connected(const client_id_type id) {
 }
 
 void server_adapter::client_disconnected(const client_id_type id) {
+	discard_held_messages(id);
 	pending_events.push_back({ id, false });
 }
 
+void server_adapter::discard_held_messages(const client_id_type& id) {
+	auto& h = held[id];
+
+	for (const auto& m : h.messages) {
+		server.ReleaseMessage(id, m);
+	}
+
+	h = {};
+}
+
+void server_adapter::hold_messages(const client_id_type& id, const game_channel_type& channel) {
+	auto& h = held[id];
+
+	ensure(h.channel == std::nullopt || *h.channel == channel);
+
+	if (!h.holding) {
+		/* Whatever was released before still goes out first. */
+		h.num_released = h.messages.size();
+	}
+
+	h.channel = channel;
+	h.holding = true;
+}
+
+void server_adapter::release_held_messages(const client_id_type& id) {
+	auto& h = held[id];
+
+	h.holding = false;
+	h.num_released = h.messages.size();
+}
+
+bool server_adapter::can_send_ahead_of_held(const client_id_type& id) const {
+	const auto& h = held[id];
+
+	if (!h.holding || h.num_released > 0) {
+		return false;
+	}
+
+	return can_send_message(id, *h.channel);
+}
+
+void server_adapter::send_released_messages() {
+	if (!is_running()) {
+		return;
+	}
+
+	for (std::size_t i = 0; i < held.size(); ++i) {
+		const auto id = static_cast<client_id_type>(i);
+		auto& h = held[i];
+
+		if (h.channel == std::nullopt || !is_client_connected(id)) {
+			continue;
+		}
+
+		const auto channel = *h.channel;
+
+		while (h.num_released > 0 && can_send_message(id, channel)) {
+			server.SendMessage(id, static_cast<channel_id_type>(channel), h.messages.front());
+
+			h.messages.pop_front();
+			--h.num_released;
+		}
+
+		if (!h.holding && h.messages.empty()) {
+			h.channel = std::nullopt;
+		}
+	}
+}
+
 game_connection_config::game_connection_config() {
 	numChannels = static_cast<int>(game_channel_type::COUNT);
 	timeout = 10;
@@ -104,7 +179,8 @@ game_connection_config::game_connection_config() {
 }
 
 void game_connection_config::set_max_packet_size(const unsigned s) {
-	protocolId = 8412;
+	/* Bump whenever the messages or the meaning of any networked value changes. */
+	protocolId = 8414;
 
 	maxPacketSize = s;
     maxPacketFragments = (int) ceil( maxPacketSize / packetFragmentSize );
@@ -201,11 +277,18 @@ server_adapter::server_adapter(const augs::server_listen_input& in, auxiliary_co
 	}
 }
 
+server_adapter::~server_adapter() {
+	if (server.IsRunning()) {
+		stop();
+	}
+}
+
 void server_adapter::disconnect_client(const client_id_type& id) {
 	server.DisconnectClient(id);
 }
 
 void server_adapter::send_packets() {
+	send_released_messages();
 	server.SendPackets();
 }
 
@@ -640,6 +723,18 @@ bool server_adapter::send(
 		return false;
 	}
 
+	auto& h = held[client_id];
+
+	if (h.channel == channel_id) {
+		h.messages.push_back(new_message);
+
+		if (!h.holding) {
+			++h.num_released;
+		}
+
+		return true;
+	}
+
 	const auto channel_id_int = static_cast<channel_id_type>(channel_id);
 	server.SendMessage(client_id, channel_id_int, new_message);
 
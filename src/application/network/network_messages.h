@@ -15,6 +15,8 @@
 #include "game/common_state/entity_flavours.h"
 #include "application/setups/server/public_settings_update.h"
 #include "game/modes/session_id.h"
+#include "application/network/compressed_initial_arena_state.h"
+#include "application/network/state_hash_breakdown.h"
 
 #define LOG_NET_SERIALIZATION !IS_PRODUCTION_BUILD
 
@@ -68,6 +70,16 @@ struct preserialized_message : public yojimbo::Message {
 	YOJIMBO_MESSAGE_BOILERPLATE();
 };
 
+/*
+	Server step serialized once per tick and shared by all clients.
+	Only the leading prestep_client_context differs per recipient,
+	so it is patched in place when the bytes are copied to a client's message.
+*/
+
+struct preserialized_server_step_entropy {
+	message_bytes_type bytes;
+};
+
 struct only_block_message : public yojimbo::BlockMessage {
 	static constexpr bool server_to_client = true;
 	static constexpr bool client_to_server = false;
@@ -146,21 +158,34 @@ namespace net_messages {
 		bool read_payload(server_vars&);
 	};
 
-	struct initial_arena_state : only_block_message {
+	struct initial_arena_state_chunk : only_block_message {
 		bool read_payload(
 			augs::serialization_buffers&,
-			const cosmos_solvable_significant& initial_signi,
-			initial_arena_state_payload<false>
+			::initial_arena_state_progress&
 		);
 
 		template <class F>
 		bool write_payload(
 			F block_allocator,
+			const ::compressed_initial_arena_state&,
+			const uint32_t& chunk_index
+		);
+	};
+
+	/* Sent after all chunks, completes the initial state. */
+
+	struct initial_arena_state : preserialized_message {
+		static constexpr bool server_to_client = true;
+		static constexpr bool client_to_server = false;
+
+		bool read_payload(
 			augs::serialization_buffers&,
+			const ::initial_arena_state_progress&,
 			const cosmos_solvable_significant& initial_signi,
-			const all_entity_flavours& all_flavours,
-			initial_arena_state_payload<true>
+			initial_arena_state_payload<false>
 		);
+
+		bool write_payload(const ::initial_arena_state_for_client&);
 	};
 
 	//struct initial_steps_correction : only_block_message {};
@@ -187,6 +212,7 @@ namespace net_messages {
 		static constexpr bool client_to_server = false;
 
 		bool write_payload(::networked_server_step_entropy&);
+		bool write_payload(const ::preserialized_server_step_entropy&, const ::prestep_client_context&);
 		bool read_payload(::networked_server_step_entropy&);
 	};
 
@@ -258,6 +284,21 @@ namespace net_messages {
 		YOJIMBO_MESSAGE_BOILERPLATE();
 	};
 
+	struct state_hash_breakdown : public yojimbo::Message {
+		static constexpr bool server_to_client = true;
+		static constexpr bool client_to_server = true;
+
+		template <typename Stream>
+		bool Serialize(Stream& stream);
+
+		::state_hash_breakdown payload;
+
+		bool write_payload(const ::state_hash_breakdown&);
+		bool read_payload(::state_hash_breakdown&);
+
+		YOJIMBO_MESSAGE_BOILERPLATE();
+	};
+
 	struct player_avatar_exchange : only_block_message {
 		static constexpr bool server_to_client = true;
 		static constexpr bool client_to_server = true;
@@ -280,6 +321,7 @@ namespace net_messages {
 		public_settings_update*, 
 		new_server_vars*,
 		new_server_solvable_vars*,
+		initial_arena_state_chunk*,
 		initial_arena_state*,
 		//initial_steps_correction*,
 #if CONTEXTS_SEPARATE
@@ -293,7 +335,8 @@ namespace net_messages {
 		client_requested_chat*,
 		server_broadcasted_chat*,
 		net_statistics_update*,
-		player_avatar_exchange*
+		player_avatar_exchange*,
+		state_hash_breakdown*
 	>;
 	
 	using id_t = type_in_list_id<all_t>;
@@ -19,5 +19,8 @@ struct requested_client_settings {
 
 	public_client_settings public_settings;
 	client_net_vars net;
+
+	/* Honored only along with a valid rcon password. */
+	bool as_relay = false;
 	// END GEN INTROSPECTOR
 };
@@ -1,4 +1,8 @@
 #pragma once
+#include <array>
+#include <deque>
+#include <vector>
+#include <optional>
 #include <functional>
 #include "augs/global_libraries.h"
 #include "application/network/network_adapters.h"
@@ -23,6 +27,30 @@ class server_adapter {
 
 	std::vector<connection_event> pending_events;
 
+	/*
+		Messages to a client can be held back on one of its channels,
+		e.g. until its initial state is sent.
+
+		Once released, they are sent in the original order,
+		but only as fast as the send queue of the channel has room for them.
+		Until then, whatever else is sent on that channel is queued after them.
+	*/
+
+	struct held_messages {
+		std::optional<game_channel_type> channel;
+		bool holding = false;
+
+		/* The leading messages that are already released and wait only for room in the send queue. */
+		std::size_t num_released = 0;
+
+		std::deque<translated_payload_id> messages;
+	};
+
+	std::array<held_messages, max_incoming_connections_v> held;
+
+	void discard_held_messages(const client_id_type&);
+	void send_released_messages();
+
 	friend GameAdapter;
 
 	void client_connected(client_id_type id);
@@ -39,6 +67,7 @@ class server_adapter {
 
 public:
 	server_adapter(const augs::server_listen_input&, auxiliary_command_callback_type);
+	~server_adapter();
 
 	template <class H>
 	void advance(
@@ -72,6 +101,25 @@ public:
 		const translated_payload_id&
 	);
 
+	void hold_messages(const client_id_type&, const game_channel_type&);
+
+	/*
+		Whether a message can be sent on the held channel right away,
+		so that it arrives before the held messages.
+		False while the messages released earlier are still waiting for room in the send queue.
+	*/
+
+	bool can_send_ahead_of_held(const client_id_type&) const;
+
+	template <class... Args>
+	bool send_payload_ahead_of_held(
+		const client_id_type& client_id, 
+		Args&&... args
+	);
+
+	/* The held messages will be sent with the next packets, as fast as the send queue allows. */
+	void release_held_messages(const client_id_type&);
+
 	bool is_client_connected(const client_id_type& id) const;
 
 	void disconnect_client(const client_id_type& id);
@@ -171,3 +171,23 @@ bool server_adapter::send_payload(
 	return send(client_id, channel_id, translate_payload(client_id, std::forward<Args>(args)...));
 }
 
+template <class... Args>
+bool server_adapter::send_payload_ahead_of_held(
+	const client_id_type& client_id, 
+	Args&&... args
+) {
+	const auto& h = held[client_id];
+
+	if (!can_send_ahead_of_held(client_id)) {
+		return false;
+	}
+
+	const auto new_message = translate_payload(client_id, std::forward<Args>(args)...);
+
+	if (!is_valid(new_message)) {
+		return false;
+	}
+
+	server.SendMessage(client_id, static_cast<channel_id_type>(*h.channel), new_message);
+	return true;
+}
@@ -59,12 +59,13 @@ void simulation_receiver::predict_intents_of_remote_entities(
 #endif
 }
 
-std::vector<misprediction_candidate_entry> simulation_receiver::acquire_potential_mispredictions(
+void simulation_receiver::acquire_potential_mispredictions(
+	std::vector<misprediction_candidate_entry>& potential_mispredictions,
 	const std::unordered_set<entity_id>& unpredictables_infected, 
 	const cosmos& predicted_cosmos_before_reconciliation
 ) const {
-	std::vector<misprediction_candidate_entry> potential_mispredictions;
-	
+	potential_mispredictions.clear();
+
 	const auto& cosmos = predicted_cosmos_before_reconciliation;
 	
 	potential_mispredictions.reserve(
@@ -87,8 +88,6 @@ std::vector<misprediction_candidate_entry> simulation_receiver::acquire_potentia
 			);
 		}
 	}
-
-	return potential_mispredictions;
 }
 
 void simulation_receiver::drag_mispredictions_into_past(
@@ -1,4 +1,5 @@
 #pragma once
+#include <optional>
 #include <unordered_set>
 
 #include "augs/log.h"
@@ -14,6 +15,7 @@
 #include "application/network/simulation_receiver_settings.h"
 
 #include "application/network/interpolation_transfer.h"
+#include "application/network/state_hash_breakdown.h"
 
 /* Prediction is too costly in debug builds. */
 #define USE_CLIENT_PREDICTION NDEBUG
@@ -28,7 +30,12 @@ struct steps_unpacking_result {
 	bool should_repredict = false;
 	bool malicious_server = false;
 	bool desync = false;
+
+	/* Reported to the server so that it can tell which parts of the state diverged. */
+	std::optional<state_hash_breakdown> desync_breakdown;
+
 	std::size_t total_accepted = static_cast<std::size_t>(-1);
+	std::size_t num_resimulated_steps = 0;
 };
 
 class simulation_receiver {
@@ -50,7 +57,14 @@ private:
 		return candidate;
 	}
 	
-	std::vector<misprediction_candidate_entry> acquire_potential_mispredictions(
+	/* Kept between repredictions so that acquiring candidates does not reallocate every time. */
+	std::vector<misprediction_candidate_entry> potential_mispredictions;
+
+	/* Hashes at the last step confirmed by the server, to tell which parts diverged on a desync. */
+	solvable_signi_hashes last_synced_hashes;
+
+	void acquire_potential_mispredictions(
+		std::vector<misprediction_candidate_entry>& output,
 		const std::unordered_set<entity_id>&, 
 		const cosmos& predicted_cosmos_before_reconciliation
 	) const;
@@ -186,19 +200,29 @@ public:
 						}
 #endif
 
-						const auto client_state_hash = 
-							referential_cosmos.template calculate_solvable_signi_hash<uint32_t>()
-						;
+						const auto client_state_hashes = referential_cosmos.calculate_solvable_signi_hashes();
+						const auto client_state_hash = client_state_hashes.combined();
 
 						if (*received_hash != client_state_hash) {
 							LOG(
-								"Client desynchronized at step: %x. Hashes differ.\nExpected: %x\nActual: %x\n",
+								"Client desynchronized at step: %x. Hashes differ.\nExpected: %x\nActual: %x\nParts changed since the last synced step are marked with *:\n%x",
 								referential_cosmos.get_total_steps_passed(),
 							   	*received_hash,
-							   	client_state_hash
+							   	client_state_hash,
+								client_state_hashes.describe(std::addressof(last_synced_hashes))
 							);
 
 							result.desync = true;
+
+							if (result.desync_breakdown == std::nullopt) {
+								auto& breakdown = result.desync_breakdown.emplace();
+
+								breakdown.step = static_cast<uint32_t>(referential_cosmos.get_total_steps_passed());
+								breakdown.hashes = client_state_hashes;
+							}
+						}
+						else {
+							last_synced_hashes = client_state_hashes;
 						}
 					}
 				}
@@ -263,7 +287,8 @@ public:
 		if (repredict) {
 			auto& predicted_cosmos = predicted_arena.get_cosmos();
 
-			const auto potential_mispredictions = acquire_potential_mispredictions(
+			acquire_potential_mispredictions(
+				potential_mispredictions,
 				past.infected_entities, 
 				predicted_cosmos
 			);
@@ -282,6 +307,8 @@ public:
 				advance_predicted(predicted_step_entropy);
 			}
 
+			result.num_resimulated_steps = predicted_entropies.size();
+
 			::restore_interpolations(transfer_caches, predicted_cosmos);
 
 			drag_mispredictions_into_past(
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+#include "game/cosmos/solvable_signi_hashes.h"
+
+/*
+	Exchanged once a client detects a desync.
+	The client reports the hashes of every part of its state at the step of the mismatch,
+	and the server replies with its own hashes at that step,
+	so that both sides can log which parts diverged.
+*/
+
+struct state_hash_breakdown {
+	uint32_t step = 0;
+	uint32_t pad = 0;
+	solvable_signi_hashes hashes;
+};
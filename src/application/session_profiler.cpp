@@ -1,6 +1,7 @@
 #include "augs/templates/introspect.h"
 #include "application/session_profiler.h"
 #include "application/setups/server/server_profiler.h"
+#include "augs/graphics/null_renderer_backend.h"
 
 /* So that we don't have to include generated/introspectors with the header */
 
@@ -14,4 +15,24 @@ network_profiler::network_profiler() {
 
 server_profiler::server_profiler() {
 	setup_names_of_measurements();
+
+	/* Averages hide the spikes, so the dedicated server also logs the tail of tick times. */
+
+	step.enable_percentiles(1e-6, 10.0);
+	solve_simulation.enable_percentiles(1e-6, 10.0);
+}
+
+render_commands_profiler::render_commands_profiler() {
+	setup_names_of_measurements();
+}
+
+void render_commands_profiler::measure(const augs::graphics::renderer_frame_stats& stats) {
+	commands.measure(stats.commands);
+	draw_calls.measure(stats.draw_calls);
+	triangles.measure(stats.triangles);
+	lines.measure(stats.lines);
+	imgui_draw_calls.measure(stats.imgui_draw_calls);
+	state_changes.measure(stats.state_changes);
+	uploaded_vertex_bytes.measure(stats.uploaded_vertex_bytes);
+	uploaded_texture_bytes.measure(stats.uploaded_texture_bytes);
 }
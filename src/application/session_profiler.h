@@ -2,6 +2,12 @@
 #include "augs/misc/profiler_mixin.h"
 #include "augs/texture_atlas/atlas_profiler.h"
 
+namespace augs {
+	namespace graphics {
+		struct renderer_frame_stats;
+	}
+}
+
 struct session_profiler : public augs::profiler_mixin<session_profiler> {
 	session_profiler();
 
@@ -21,6 +27,7 @@ struct network_profiler : public augs::profiler_mixin<network_profiler> {
 	// GEN INTROSPECTOR struct network_profiler
 	augs::amount_measurements<std::size_t> predicted_steps = 1;
 	augs::amount_measurements<std::size_t> accepted_commands = 1;
+	augs::amount_measurements<std::size_t> resimulated_steps = 1;
 
 	augs::time_measurements unpacking_remote_steps;
 	augs::time_measurements stepping_forward;
@@ -28,4 +35,21 @@ struct network_profiler : public augs::profiler_mixin<network_profiler> {
 	augs::time_measurements sending_packets;
 	augs::time_measurements receiving_messages;
 	// END GEN INTROSPECTOR
-};
\ No newline at end of file
+};
+
+struct render_commands_profiler : public augs::profiler_mixin<render_commands_profiler> {
+	render_commands_profiler();
+
+	// GEN INTROSPECTOR struct render_commands_profiler
+	augs::amount_measurements<std::size_t> commands = 1;
+	augs::amount_measurements<std::size_t> draw_calls = 1;
+	augs::amount_measurements<std::size_t> triangles = 1;
+	augs::amount_measurements<std::size_t> lines = 1;
+	augs::amount_measurements<std::size_t> imgui_draw_calls = 1;
+	augs::amount_measurements<std::size_t> state_changes = 1;
+	augs::amount_measurements<std::size_t> uploaded_vertex_bytes = 1;
+	augs::amount_measurements<std::size_t> uploaded_texture_bytes = 1;
+	// END GEN INTROSPECTOR
+
+	void measure(const augs::graphics::renderer_frame_stats&);
+};
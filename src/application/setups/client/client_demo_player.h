@@ -1,6 +1,7 @@
 #pragma once
 #include "application/gui/client/demo_player_gui.h"
 #include "augs/misc/timing/fixed_delta_timer.h"
+#include "application/setups/client/demo_container.h"
 
 struct client_demo_player {
 	int additional_steps = 0;
@@ -12,9 +13,21 @@ struct client_demo_player {
 	demo_step default_step;
 
 	std::optional<demo_step_num_type> requested_seek;
-	std::vector<demo_step> demo_steps;
 	demo_step_num_type current_step = 0;
 
+	/*
+		Indexed demos are decompressed one chunk at a time, as playback reaches it.
+		Legacy demos are read whole into loaded_steps.
+	*/
+
+	std::optional<demo_container_reader> indexed_source;
+	std::vector<demo_step> loaded_steps;
+	std::vector<std::byte> loaded_chunk_bytes;
+	demo_step_num_type loaded_first_step = 0;
+	demo_step_num_type total_steps = 0;
+
+	void load_chunk_with(demo_step_num_type n);
+
 	double speed = 1.0;
 	double current_secs = 0.0;
 
@@ -31,7 +44,7 @@ struct client_demo_player {
 	}
 
 	bool all_steps_played() const {
-		return current_step >= demo_steps.size();
+		return current_step >= total_steps;
 	}
 
 	bool is_paused() const {
@@ -43,7 +56,7 @@ struct client_demo_player {
 	}
 
 	auto get_total_steps() const {
-		return demo_steps.size();
+		return total_steps;
 	}
 
 	auto get_current_secs() const {
@@ -60,12 +73,16 @@ struct client_demo_player {
 		return is_paused() ? 0.0 : speed;
 	}
 
-	const auto& get_nth_step(const demo_step_num_type n) const {
-		if (all_steps_played()) {
+	const demo_step& get_nth_step(const demo_step_num_type n) {
+		if (n >= total_steps) {
 			return default_step;
 		}
 
-		return demo_steps[n];
+		if (n < loaded_first_step || n - loaded_first_step >= loaded_steps.size()) {
+			load_chunk_with(n);
+		}
+
+		return loaded_steps[n - loaded_first_step];
 	}
 
 	void seek_backward(const demo_step_num_type offset) {
@@ -127,7 +144,7 @@ struct client_demo_player {
 		while (steps--) {
 			advance_player(step_state);
 
-			if (current_step == demo_steps.size()) {
+			if (current_step == total_steps) {
 				pause();
 			}
 		}
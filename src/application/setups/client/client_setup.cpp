@@ -14,6 +14,7 @@
 #include "game/cosmos/change_solvable_significant.h"
 
 #include "augs/readwrite/memory_stream.h"
+#include "augs/readwrite/to_bytes.h"
 
 #include "application/arena/choose_arena.h"
 
@@ -47,14 +48,49 @@
 
 void client_demo_player::play_demo_from(const augs::path_type& p) {
 	source_path = p;
-	auto source = augs::open_binary_input_stream(source_path);
 
-	augs::read_bytes(source, meta);
-	augs::read_vector_until_eof(source, demo_steps);
+	indexed_source.reset();
+	loaded_steps.clear();
+	loaded_first_step = 0;
+
+	if (demo_container_reader::is_container(source_path)) {
+		indexed_source.emplace(source_path);
+		augs::from_bytes(indexed_source->get_meta(), meta);
+
+		total_steps = static_cast<demo_step_num_type>(indexed_source->get_total_steps());
+	}
+	else {
+		auto source = augs::open_binary_input_stream(source_path);
+
+		augs::read_bytes(source, meta);
+		augs::read_vector_until_eof(source, loaded_steps);
+
+		total_steps = static_cast<demo_step_num_type>(loaded_steps.size());
+	}
 
 	gui.open();
 }
 
+void client_demo_player::load_chunk_with(const demo_step_num_type n) {
+	ensure(indexed_source.has_value());
+
+	const auto chunk_index = indexed_source->find_chunk(n);
+	ensure(chunk_index.has_value());
+
+	indexed_source->read_chunk(*chunk_index, loaded_chunk_bytes);
+
+	loaded_steps.clear();
+	loaded_first_step = static_cast<demo_step_num_type>(indexed_source->get_chunk(*chunk_index).first_step);
+
+	auto source = augs::cref_memory_stream(loaded_chunk_bytes);
+
+	while (source.has_unread_bytes()) {
+		augs::read_bytes(source, loaded_steps.emplace_back());
+	}
+
+	ensure_eq(loaded_steps.size(), static_cast<std::size_t>(indexed_source->get_chunk(*chunk_index).num_steps));
+}
+
 bool client_demo_player::control(const handle_input_before_game_input in) {
 	using namespace augs::event;
 	using namespace augs::event::keys;
@@ -152,26 +188,28 @@ void client_setup::flush_demo_steps() {
 
 	future_flushed_demo = launch_async(
 		[&]() {
-			auto out = augs::with_exceptions<std::ofstream>();
-			out.open(recorded_demo_path, std::ios::out | std::ios::binary | std::ios::app);
-
-			if (!was_demo_meta_written) {
+			if (!demo_writer.has_value()) {
 				demo_file_meta meta;
 				meta.server_address = last_addr.address;
 				meta.version = hypersomnia_version();
-				augs::write_bytes(out, meta);
+
+				demo_writer.emplace(recorded_demo_path, augs::to_bytes(meta));
 
 				const auto version_info_path = augs::path_type(recorded_demo_path).replace_extension(".version.txt");
 				augs::save_as_text(version_info_path, meta.version.get_summary());
-
-				was_demo_meta_written = true;
 			}
 
-			for (const auto& s : demo_steps_being_flushed) {
-				augs::write_bytes(out, s);
+			std::vector<std::byte> serialized_steps;
+
+			{
+				auto out = augs::ref_memory_stream(serialized_steps);
+
+				for (const auto& s : demo_steps_being_flushed) {
+					augs::write_bytes(out, s);
+				}
 			}
 
-			out.flush();
+			demo_writer->write_steps(serialized_steps, static_cast<uint32_t>(demo_steps_being_flushed.size()));
 			demo_steps_being_flushed.clear();
 		}
 	);
@@ -302,6 +340,17 @@ client_setup::~client_setup() {
 	wait_for_demo_flush();
 	flush_demo_steps();
 	wait_for_demo_flush();
+
+	if (demo_writer.has_value()) {
+		/* Must not throw out of the destructor, e.g. when the disk is full. */
+
+		try {
+			demo_writer->finish();
+		}
+		catch (const augs::file_open_error& err) {
+			LOG("Failed to finish the demo file %x: %x", recorded_demo_path, err.what());
+		}
+	}
 }
 
 net_time_t client_setup::get_current_time() {
@@ -699,6 +748,17 @@ void client_setup::send_pending_commands() {
 		}
 	}
 
+	if (pending_desync_report && reported_desync.has_value()) {
+		/* Goes first on the same channel, so the server still has its hashes of that step when it reads it. */
+
+		send_payload(
+			game_channel_type::CLIENT_COMMANDS,
+			std::as_const(*reported_desync)
+		);
+
+		pending_desync_report = false;
+	}
+
 	if (pending_request == special_client_request::RESYNC) {
 		LOG("Sending the request resync command.");
 
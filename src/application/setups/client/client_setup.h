@@ -38,6 +38,7 @@
 
 #include "view/client_arena_type.h"
 #include "application/network/special_client_request.h"
+#include "application/network/compressed_initial_arena_state.h"
 #include "application/gui/client/rcon_gui.h"
 #include "application/gui/client/chat_gui.h"
 #include "application/gui/client/client_gui_state.h"
@@ -68,7 +69,7 @@ class client_setup :
 
 	/* This is loaded from the arena folder */
 	intercosm scene;
-	cosmos_solvable_significant initial_signi;
+	cosmos initial_cosm;
 
 	predefined_rulesets rulesets;
 
@@ -85,6 +86,11 @@ class client_setup :
 	special_client_request pending_request = special_client_request::NONE;
 	bool now_resyncing = false;
 
+	/* Our hashes at the step of the last desync, sent along the resync request and compared with the server's reply. */
+	std::optional<state_hash_breakdown> reported_desync;
+	bool pending_desync_report = false;
+	initial_arena_state_progress initial_state_progress;
+
 	arena_player_metas player_metas;
 
 	/* The rest is client-specific */
@@ -133,7 +139,7 @@ class client_setup :
 	std::vector<demo_step> unflushed_demo_steps;
 	std::vector<demo_step> demo_steps_being_flushed;
 	std::future<void> future_flushed_demo;
-	bool was_demo_meta_written = false;
+	std::optional<demo_container_writer> demo_writer;
 
 	client_demo_player demo_player;
 	/* No client state follows later in code. */
@@ -166,7 +172,7 @@ class client_setup :
 				self.scene,
 				self.predicted_cosmos,
 				self.rulesets,
-				self.initial_signi
+				self.initial_cosm
 			};
 		}
 		else {
@@ -177,7 +183,7 @@ class client_setup :
 				self.scene,
 				self.scene.world,
 				self.rulesets,
-				self.initial_signi
+				self.initial_cosm
 			};
 		}
 	}
@@ -445,6 +451,7 @@ class client_setup :
 				);
 
 				performance.accepted_commands.measure(result.total_accepted);
+				performance.resimulated_steps.measure(result.num_resimulated_steps);
 
 				if (result.malicious_server) {
 					LOG("There was a problem unpacking steps from the server. Disconnecting.");
@@ -456,6 +463,11 @@ class client_setup :
 					pending_request = special_client_request::RESYNC;
 					now_resyncing = true;
 
+					if (result.desync_breakdown.has_value()) {
+						reported_desync = result.desync_breakdown;
+						pending_desync_report = true;
+					}
+
 #if DUMP_BEFORE_AND_AFTER_ROUND_START
 					const auto preffix = typesafe_sprintf("%x_desync%x_", augs::getpid(), referential_arena.get_round_num());
 
@@ -0,0 +1,406 @@
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+
+#include "augs/filesystem/file.h"
+#include "augs/misc/compress.h"
+#include "augs/readwrite/stream_read_error.h"
+#include "application/setups/client/demo_container.h"
+
+namespace {
+	template <class S, class T>
+	void write_raw(S& out, const T& object) {
+		out.write(reinterpret_cast<const char*>(&object), sizeof(T));
+	}
+
+	template <class S, class T>
+	bool try_read_raw(S& in, T& object) {
+		return static_cast<bool>(in.read(reinterpret_cast<char*>(&object), sizeof(T)));
+	}
+
+	auto open_demo_for_reading(const augs::path_type& path) {
+		auto in = std::ifstream(path, std::ios::in | std::ios::binary);
+
+		if (!in) {
+			throw augs::file_open_error("Failed to open " + path.string());
+		}
+
+		return in;
+	}
+}
+
+demo_container_writer::demo_container_writer(
+	const augs::path_type& path,
+	const std::vector<std::byte>& serialized_meta
+) :
+	path(path),
+	compression_state(augs::make_compression_state())
+{
+	auto out = augs::open_binary_output_stream(path);
+
+	const auto meta_size = static_cast<uint32_t>(serialized_meta.size());
+
+	write_raw(out, demo_container_header());
+	write_raw(out, meta_size);
+	out.write(reinterpret_cast<const char*>(serialized_meta.data()), serialized_meta.size());
+
+	file_size = sizeof(demo_container_header) + sizeof(meta_size) + serialized_meta.size();
+}
+
+void demo_container_writer::write_record(
+	const demo_record_type type,
+	const uint64_t first_step,
+	const uint32_t num_steps,
+	const std::vector<std::byte>& payload
+) {
+	const bool compressed_payload = type != demo_record_type::INDEX;
+
+	compressed.clear();
+
+	if (compressed_payload) {
+		augs::compress(compression_state, payload, compressed);
+	}
+
+	const auto& written = compressed_payload ? compressed : payload;
+
+	demo_record_header header;
+	header.type = type;
+	header.compressed_size = static_cast<uint32_t>(written.size());
+	header.uncompressed_size = static_cast<uint32_t>(payload.size());
+	header.num_steps = num_steps;
+	header.first_step = first_step;
+
+	auto out = augs::with_exceptions<std::ofstream>();
+	out.open(path, std::ios::out | std::ios::binary | std::ios::app);
+
+	write_raw(out, header);
+	out.write(reinterpret_cast<const char*>(written.data()), written.size());
+	out.flush();
+
+	if (type != demo_record_type::INDEX) {
+		index.push_back({ type, num_steps, first_step, file_size });
+	}
+
+	file_size += sizeof(header) + written.size();
+}
+
+void demo_container_writer::write_steps(const std::vector<std::byte>& serialized_steps, const uint32_t num_steps) {
+	if (num_steps == 0) {
+		return;
+	}
+
+	write_record(demo_record_type::STEPS, next_step, num_steps, serialized_steps);
+	next_step += num_steps;
+}
+
+void demo_container_writer::write_keyframe(const std::vector<std::byte>& snapshot) {
+	write_record(demo_record_type::KEYFRAME, next_step, 0, snapshot);
+}
+
+void demo_container_writer::finish() {
+	const auto index_offset = file_size;
+
+	std::vector<std::byte> serialized_index(index.size() * sizeof(demo_record_location));
+
+	if (index.size() > 0) {
+		std::memcpy(serialized_index.data(), index.data(), serialized_index.size());
+	}
+
+	write_record(demo_record_type::INDEX, 0, 0, serialized_index);
+
+	demo_container_trailer trailer;
+	trailer.index_offset = index_offset;
+
+	auto out = augs::with_exceptions<std::ofstream>();
+	out.open(path, std::ios::out | std::ios::binary | std::ios::app);
+	write_raw(out, trailer);
+}
+
+bool demo_container_reader::is_container(const augs::path_type& path) {
+	auto in = std::ifstream(path, std::ios::in | std::ios::binary);
+
+	demo_container_header header;
+	return try_read_raw(in, header) && header.magic == demo_container_header::current_magic;
+}
+
+demo_container_reader::demo_container_reader(const augs::path_type& path) : path(path) {
+	auto in = open_demo_for_reading(path);
+
+	in.seekg(0, std::ios::end);
+	const auto file_size = static_cast<uint64_t>(in.tellg());
+	in.seekg(0, std::ios::beg);
+
+	demo_container_header header;
+	uint32_t meta_size = 0;
+
+	if (!try_read_raw(in, header) || header.magic != demo_container_header::current_magic) {
+		throw augs::stream_read_error("%x is not an indexed demo.", path);
+	}
+
+	if (header.format_version != demo_container_header().format_version) {
+		throw augs::stream_read_error("%x has an unsupported demo format version: %x.", path, header.format_version);
+	}
+
+	if (!try_read_raw(in, meta_size) || meta_size > file_size) {
+		throw augs::stream_read_error("Failed to read the demo meta from %x.", path);
+	}
+
+	meta.resize(meta_size);
+
+	if (!in.read(reinterpret_cast<char*>(meta.data()), meta_size)) {
+		throw augs::stream_read_error("Failed to read the demo meta from %x.", path);
+	}
+
+	const auto first_record_offset = static_cast<uint64_t>(in.tellg());
+
+	auto add_location = [&](const demo_record_location& location) {
+		if (location.type == demo_record_type::STEPS) {
+			if (location.first_step != get_total_steps()) {
+				throw augs::stream_read_error("Steps in %x are not contiguous at step %x.", path, location.first_step);
+			}
+
+			steps.push_back(location);
+		}
+		else if (location.type == demo_record_type::KEYFRAME) {
+			keyframes.push_back(location);
+		}
+	};
+
+	auto read_index = [&]() {
+		demo_container_trailer trailer;
+
+		if (file_size < first_record_offset + sizeof(trailer)) {
+			return false;
+		}
+
+		in.seekg(file_size - sizeof(trailer));
+
+		if (!try_read_raw(in, trailer) || trailer.magic != demo_container_trailer::current_magic) {
+			return false;
+		}
+
+		in.seekg(trailer.index_offset);
+
+		demo_record_header index_header;
+
+		if (!try_read_raw(in, index_header) || index_header.type != demo_record_type::INDEX) {
+			return false;
+		}
+
+		if (index_header.compressed_size % sizeof(demo_record_location) != 0) {
+			return false;
+		}
+
+		std::vector<demo_record_location> locations(index_header.compressed_size / sizeof(demo_record_location));
+
+		if (!in.read(reinterpret_cast<char*>(locations.data()), index_header.compressed_size)) {
+			return false;
+		}
+
+		for (const auto& l : locations) {
+			add_location(l);
+		}
+
+		return true;
+	};
+
+	if (!read_index()) {
+		/* The recording was interrupted. Rebuild the index by walking the records. */
+
+		steps.clear();
+		keyframes.clear();
+
+		in.clear();
+		in.seekg(first_record_offset);
+
+		auto offset = first_record_offset;
+
+		while (offset + sizeof(demo_record_header) <= file_size) {
+			demo_record_header record;
+
+			if (!try_read_raw(in, record)) {
+				break;
+			}
+
+			const auto record_end = offset + sizeof(record) + record.compressed_size;
+
+			if (record_end > file_size) {
+				break;
+			}
+
+			add_location({ record.type, record.num_steps, record.first_step, offset });
+
+			offset = record_end;
+			in.seekg(offset);
+		}
+	}
+}
+
+uint64_t demo_container_reader::get_total_steps() const {
+	if (steps.empty()) {
+		return 0;
+	}
+
+	const auto& last = steps.back();
+	return last.first_step + last.num_steps;
+}
+
+std::optional<std::size_t> demo_container_reader::find_chunk(const uint64_t step) const {
+	if (step >= get_total_steps()) {
+		return std::nullopt;
+	}
+
+	const auto it = std::upper_bound(
+		steps.begin(),
+		steps.end(),
+		step,
+		[](const uint64_t s, const demo_record_location& l) { return s < l.first_step; }
+	);
+
+	return static_cast<std::size_t>(std::distance(steps.begin(), it) - 1);
+}
+
+std::optional<std::size_t> demo_container_reader::find_keyframe(const uint64_t step) const {
+	const auto it = std::upper_bound(
+		keyframes.begin(),
+		keyframes.end(),
+		step,
+		[](const uint64_t s, const demo_record_location& l) { return s < l.first_step; }
+	);
+
+	if (it == keyframes.begin()) {
+		return std::nullopt;
+	}
+
+	return static_cast<std::size_t>(std::distance(keyframes.begin(), it) - 1);
+}
+
+void demo_container_reader::read_payload(const demo_record_location& location, std::vector<std::byte>& output) const {
+	auto in = open_demo_for_reading(path);
+	in.seekg(location.offset);
+
+	demo_record_header header;
+
+	if (!try_read_raw(in, header) || header.type != location.type || header.first_step != location.first_step) {
+		throw augs::stream_read_error("Corrupt demo record at offset %x in %x.", location.offset, path);
+	}
+
+	thread_local std::vector<std::byte> compressed;
+	compressed.resize(header.compressed_size);
+
+	if (!in.read(reinterpret_cast<char*>(compressed.data()), header.compressed_size)) {
+		throw augs::stream_read_error("Truncated demo record at offset %x in %x.", location.offset, path);
+	}
+
+	output.resize(header.uncompressed_size);
+
+	try {
+		augs::decompress(compressed.data(), compressed.size(), output.data(), output.size());
+	}
+	catch (const augs::decompression_error& err) {
+		throw augs::stream_read_error("Failed to decompress the demo record at offset %x in %x: %x", location.offset, path, err.what());
+	}
+}
+
+std::ifstream open_demo_at_meta(const augs::path_type& path) {
+	const bool indexed = demo_container_reader::is_container(path);
+
+	auto in = augs::open_binary_input_stream(path);
+
+	if (indexed) {
+		in.seekg(sizeof(demo_container_header) + sizeof(uint32_t));
+	}
+
+	return in;
+}
+
+void demo_container_reader::read_chunk(const std::size_t i, std::vector<std::byte>& output) const {
+	read_payload(steps[i], output);
+}
+
+void demo_container_reader::read_keyframe(const std::size_t i, std::vector<std::byte>& output) const {
+	read_payload(keyframes[i], output);
+}
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+
+namespace {
+	std::vector<std::byte> make_test_steps(const uint64_t first_step, const uint32_t num_steps) {
+		std::vector<std::byte> bytes;
+
+		for (uint64_t s = first_step; s < first_step + num_steps; ++s) {
+			for (int i = 0; i < 16; ++i) {
+				bytes.push_back(static_cast<std::byte>(s));
+			}
+		}
+
+		return bytes;
+	}
+}
+
+TEST_CASE("DemoContainer IndexedAndInterrupted") {
+	const auto path = augs::path_type(GENERATED_FILES_DIR) / "test_demo_container.dem";
+	const auto meta = std::vector<std::byte>(5, std::byte(7));
+
+	const std::vector<uint32_t> chunk_sizes = { 3, 100, 1, 42 };
+
+	{
+		demo_container_writer writer(path, meta);
+
+		for (const auto n : chunk_sizes) {
+			if (writer.get_num_steps() == 103) {
+				writer.write_keyframe(std::vector<std::byte>(1000, std::byte(9)));
+			}
+
+			writer.write_steps(make_test_steps(writer.get_num_steps(), n), n);
+		}
+
+		REQUIRE(demo_container_reader::is_container(path));
+
+		/* Read before finish() - as if the game crashed while recording. */
+
+		const auto interrupted = demo_container_reader(path);
+		REQUIRE(interrupted.get_total_steps() == 146);
+		REQUIRE(interrupted.get_num_chunks() == 4);
+
+		writer.finish();
+	}
+
+	const auto reader = demo_container_reader(path);
+
+	REQUIRE(reader.get_meta() == meta);
+
+	{
+		auto meta_stream = open_demo_at_meta(path);
+		std::byte first_meta_byte;
+		REQUIRE(try_read_raw(meta_stream, first_meta_byte));
+		REQUIRE(first_meta_byte == std::byte(7));
+	}
+	REQUIRE(reader.get_total_steps() == 146);
+	REQUIRE(reader.get_num_chunks() == 4);
+
+	REQUIRE(reader.find_chunk(0) == std::size_t(0));
+	REQUIRE(reader.find_chunk(2) == std::size_t(0));
+	REQUIRE(reader.find_chunk(3) == std::size_t(1));
+	REQUIRE(reader.find_chunk(102) == std::size_t(1));
+	REQUIRE(reader.find_chunk(103) == std::size_t(2));
+	REQUIRE(reader.find_chunk(145) == std::size_t(3));
+	REQUIRE(reader.find_chunk(146) == std::nullopt);
+
+	std::vector<std::byte> chunk;
+	reader.read_chunk(1, chunk);
+	REQUIRE(chunk == make_test_steps(3, 100));
+
+	REQUIRE(reader.find_keyframe(102) == std::nullopt);
+	REQUIRE(reader.find_keyframe(200) == std::size_t(0));
+	REQUIRE(reader.get_keyframe(0).first_step == 103);
+
+	std::vector<std::byte> keyframe;
+	reader.read_keyframe(0, keyframe);
+	REQUIRE(keyframe == std::vector<std::byte>(1000, std::byte(9)));
+
+	augs::remove_file(path);
+	REQUIRE(!demo_container_reader::is_container(path));
+}
+#endif
@@ -0,0 +1,142 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <optional>
+
+#include "augs/filesystem/path.h"
+#include "augs/pad_bytes.h"
+
+/*
+	Demo file layout:
+
+	- demo_container_header,
+	- uint32_t size of the serialized demo_file_meta, followed by the meta itself,
+	- records, each being demo_record_header followed by its LZ4-compressed payload:
+		- STEPS: serialized demo steps, one record per flush,
+		- KEYFRAME: an optional snapshot from which playback may resume at first_step,
+		- INDEX: an uncompressed array of demo_record_location, written once the recording ends,
+	- demo_container_trailer pointing at the INDEX record.
+
+	A demo whose recording was interrupted has no INDEX record.
+	Such a demo is still readable - the reader then walks the record headers to rebuild the index,
+	skipping over the payloads and ignoring a partially written last record.
+
+	The reader never holds more than the index in memory.
+	A chunk of steps is decompressed only when playback reaches it,
+	and the chunk containing a given step is found with a binary search.
+*/
+
+enum class demo_record_type : uint32_t {
+	STEPS,
+	KEYFRAME,
+	INDEX
+};
+
+struct demo_container_header {
+	static constexpr uint64_t current_magic = 0x314f4d4544505948; /* "HYPDEMO1" */
+
+	uint64_t magic = current_magic;
+	uint32_t format_version = 1;
+	pad_bytes<4> pad;
+};
+
+struct demo_record_header {
+	demo_record_type type = demo_record_type::STEPS;
+	uint32_t compressed_size = 0;
+	uint32_t uncompressed_size = 0;
+	uint32_t num_steps = 0;
+	uint64_t first_step = 0;
+};
+
+struct demo_record_location {
+	demo_record_type type = demo_record_type::STEPS;
+	uint32_t num_steps = 0;
+	uint64_t first_step = 0;
+	uint64_t offset = 0;
+};
+
+struct demo_container_trailer {
+	static constexpr uint64_t current_magic = 0x3158444944505948; /* "HYPDIDX1" */
+
+	uint64_t index_offset = 0;
+	uint64_t magic = current_magic;
+};
+
+class demo_container_writer {
+	augs::path_type path;
+	std::vector<std::byte> compression_state;
+	std::vector<std::byte> compressed;
+
+	std::vector<demo_record_location> index;
+	uint64_t next_step = 0;
+	uint64_t file_size = 0;
+
+	void write_record(demo_record_type, uint64_t first_step, uint32_t num_steps, const std::vector<std::byte>& payload);
+
+public:
+	/* Creates the file, overwriting any existing one. */
+	demo_container_writer(const augs::path_type& path, const std::vector<std::byte>& serialized_meta);
+
+	void write_steps(const std::vector<std::byte>& serialized_steps, uint32_t num_steps);
+	void write_keyframe(const std::vector<std::byte>& snapshot);
+
+	/* Writes the index. No more records may be written afterwards. */
+	void finish();
+
+	uint64_t get_num_steps() const {
+		return next_step;
+	}
+};
+
+class demo_container_reader {
+	augs::path_type path;
+	std::vector<std::byte> meta;
+
+	std::vector<demo_record_location> steps;
+	std::vector<demo_record_location> keyframes;
+
+	void read_payload(const demo_record_location&, std::vector<std::byte>& output) const;
+
+public:
+	static bool is_container(const augs::path_type& path);
+
+	/* Throws augs::stream_read_error or augs::file_open_error. */
+	explicit demo_container_reader(const augs::path_type& path);
+
+	const auto& get_meta() const {
+		return meta;
+	}
+
+	uint64_t get_total_steps() const;
+
+	/* Returns the index of the chunk containing the step, or std::nullopt if it is past the end. */
+	std::optional<std::size_t> find_chunk(uint64_t step) const;
+
+	const demo_record_location& get_chunk(const std::size_t i) const {
+		return steps[i];
+	}
+
+	std::size_t get_num_chunks() const {
+		return steps.size();
+	}
+
+	void read_chunk(std::size_t i, std::vector<std::byte>& output) const;
+
+	/* Returns the index of the latest keyframe at or before the step. */
+	std::optional<std::size_t> find_keyframe(uint64_t step) const;
+
+	const demo_record_location& get_keyframe(const std::size_t i) const {
+		return keyframes[i];
+	}
+
+	void read_keyframe(std::size_t i, std::vector<std::byte>& output) const;
+};
+
+/*
+	Opens either an indexed or a legacy demo (meta followed by raw steps)
+	with the read position at the serialized demo_file_meta.
+*/
+
+std::ifstream open_demo_at_meta(const augs::path_type& path);
@@ -46,7 +46,7 @@ message_handler_result client_setup::handle_server_payload(
 					lua,
 					referential_arena,
 					new_vars,
-					initial_signi
+					initial_cosm
 				);
 
 				arena_gui.reset();
@@ -155,6 +155,17 @@ message_handler_result client_setup::handle_server_payload(
 			return abort_v;
 		}	
 	}
+	else if constexpr (std::is_same_v<T, initial_arena_state_progress>) {
+		if (!now_resyncing && state != client_state_type::RECEIVING_INITIAL_STATE) {
+			LOG("The server has sent initial state early (state: %x). Disconnecting.", state);
+			log_malicious_server();
+			return abort_v;
+		}
+
+		if (!read_payload(buffers, initial_state_progress)) {
+			return abort_v;
+		}
+	}
 	else if constexpr (std::is_same_v<T, initial_payload>) {
 		if (!now_resyncing && state != client_state_type::RECEIVING_INITIAL_STATE) {
 			LOG("The server has sent initial state early (state: %x). Disconnecting.", state);
@@ -167,14 +178,16 @@ message_handler_result client_setup::handle_server_payload(
 		now_resyncing = false;
 
 		uint32_t read_client_id;
+		bool read_successfully = false;
 
 		cosmic::change_solvable_significant(
 			scene.world, 
 			[&](cosmos_solvable_significant& signi) {
-				read_payload(
+				read_successfully = read_payload(
 					buffers,
 
-					initial_signi,
+					std::as_const(initial_state_progress),
+					initial_cosm.get_solvable().significant,
 
 					initial_payload {
 						signi,
@@ -188,6 +201,12 @@ message_handler_result client_setup::handle_server_payload(
 			}
 		);
 
+		initial_state_progress = {};
+
+		if (!read_successfully) {
+			return abort_v;
+		}
+
 		client_player_id = static_cast<mode_player_id>(read_client_id);
 
 		LOG("Received initial state from the server at step: %x.", scene.world.get_timestamp().step);
@@ -294,6 +313,20 @@ message_handler_result client_setup::handle_server_payload(
 		);
 
 	}
+	else if constexpr (std::is_same_v<T, state_hash_breakdown>) {
+		const auto& server_breakdown = payload;
+
+		if (reported_desync.has_value() && reported_desync->step == server_breakdown.step) {
+			LOG(
+				"Parts of the state that diverged from the server at step %x are marked with *:\n%x",
+				server_breakdown.step,
+				server_breakdown.hashes.describe(std::addressof(reported_desync->hashes))
+			);
+		}
+		else {
+			LOG("The server has sent its state hashes of step %x, for which no desync was reported.", server_breakdown.step);
+		}
+	}
 	else if constexpr (std::is_same_v<T, arena_player_avatar_payload>) {
 		session_id_type session_id;
 		arena_player_avatar_payload new_avatar;
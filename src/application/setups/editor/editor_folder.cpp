@@ -11,14 +11,22 @@
 #include "game/cosmos/entity_handle.h"
 
 #include "application/arena/arena_utils.h"
+#include "application/arena/shared_arena_cache.h"
 #include "hypersomnia_version.h"
 
 void load_arena_from(
 	const arena_paths& paths,
 	intercosm& scene,
-	predefined_rulesets& rulesets
+	predefined_rulesets& rulesets,
+	shared_arena_cache* const shared
 ) {
-	scene.load_from_bytes(paths.int_paths);
+	if (shared != nullptr) {
+		scene = *shared->load(paths.int_paths);
+		scene.world.request_resample();
+	}
+	else {
+		scene.load_from_bytes(paths.int_paths);
+	}
 
 	try {
 		augs::load_from_bytes(rulesets, paths.rulesets_file);
@@ -97,7 +97,7 @@ private:
 			folder.commanded->work,
 			folder.commanded->work.world,
 			folder.commanded->rulesets,
-			self.before_start.commanded->work.world.get_solvable().significant
+			self.before_start.commanded->work.world
 		};
 	}
 
@@ -57,7 +57,7 @@ void editor_summary_gui::perform(editor_setup& setup) {
 				compressed_buf.clear();
 
 				{
-					const auto& initial_signi = setup.is_gameplay_on() ? setup.get_arena_handle().initial_signi : solvable;
+					const auto& initial_signi = setup.is_gameplay_on() ? setup.get_arena_handle().initial_cosm.get_solvable().significant : solvable;
 
 					auto s = net_solvable_stream_ref(cosm.get_common_significant().flavours, initial_signi, solvable, input_buf);
 					augs::write_bytes(s, solvable);
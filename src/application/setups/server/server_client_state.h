@@ -19,12 +19,19 @@ struct server_client_state {
 	net_time_t last_keyboard_activity_time = -1.0;
 	requested_client_settings settings;
 	bool rebroadcast_public_settings = false;
+	bool awaits_initial_state = false;
+
+	/* A relay receives the match like a spectator, but is never added to the mode. */
+	bool authorized_relay = false;
 
 	client_pending_entropies pending_entropies;
 	uint8_t num_entropies_accepted = 0;
 
 	unsigned resyncs_counter = 0;
 	net_time_t last_resync_counter_reset_at = 0;
+
+	/* Only one desync report is answered per resync, so that a client can't flood the logs. */
+	bool desync_reported = false;
 	unsigned unauthorized_rcon_commands = 0;
 	std::optional<net_time_t> when_kicked;
 
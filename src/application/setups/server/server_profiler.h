@@ -10,6 +10,7 @@ struct server_profiler : public augs::profiler_mixin<server_profiler> {
 	augs::time_measurements advance_clients_state;
 	augs::time_measurements solve_simulation;
 	augs::time_measurements send_entropies;
+	augs::time_measurements serialize_initial_state;
 	augs::time_measurements send_packets;
 	// END GEN INTROSPECTOR
 };
@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <utility>
+
+#include "application/setups/server/server_relay.h"
+#include "application/network/client_adapter.hpp"
+#include "application/network/net_message_translation.h"
+#include "application/network/net_message_serializers.h"
+#include "application/network/payload_easily_movable.h"
+#include "application/network/resolve_address_result.h"
+#include "application/network/special_client_request.h"
+#include "game/modes/mode_entropy.h"
+
+server_relay::server_relay(const server_relay_settings& settings) :
+	settings(settings),
+	adapter(std::make_unique<client_adapter>(std::nullopt))
+{
+	LOG(
+		"Relaying the server at %x with a broadcast delay of %x seconds.",
+		settings.upstream.address,
+		std::max(settings.broadcast_delay_secs, 0.f)
+	);
+
+	const auto resolution = adapter->connect(settings.upstream);
+
+	if (resolution.result != resolve_result_type::OK) {
+		LOG("Failed to resolve the upstream server address: %x", settings.upstream.address);
+	}
+}
+
+server_relay::~server_relay() {
+	disconnect();
+}
+
+void server_relay::disconnect() {
+	adapter->disconnect();
+}
+
+void server_relay::log_malicious_server() {
+	LOG("The upstream server has sent invalid data. It might be out of date or malicious.");
+}
+
+template <class T>
+void server_relay::push(T&& event) {
+	events.push(relay_time, relayed_server_event(std::forward<T>(event)));
+}
+
+void server_relay::advance(const net_time_t new_relay_time) {
+	relay_time = new_relay_time;
+
+	if (state == client_state_type::INITIATING_CONNECTION && adapter->is_connected()) {
+		requested_client_settings requested;
+
+		requested.chosen_nickname = settings.nickname;
+		requested.rcon_password = settings.upstream_rcon_password;
+		requested.as_relay = true;
+
+		adapter->send_payload(
+			game_channel_type::CLIENT_COMMANDS,
+			std::as_const(requested)
+		);
+
+		LOG("Connected to the upstream server. Sent the relay configuration.");
+		state = client_state_type::PENDING_WELCOME;
+	}
+
+	auto& message_handler = *this;
+	adapter->advance(relay_time, message_handler);
+}
+
+void server_relay::send_packets() {
+	adapter->send_packets();
+}
+
+template <class T, class F>
+message_handler_result server_relay::handle_server_payload(
+	F&& read_payload
+) {
+	constexpr auto abort_v = message_handler_result::ABORT_AND_DISCONNECT;
+	constexpr auto continue_v = message_handler_result::CONTINUE;
+	constexpr bool is_easy_v = payload_easily_movable_v<T>;
+
+	using S = client_state_type;
+
+	std::conditional_t<is_easy_v, T, std::monostate> payload;
+
+	if constexpr(is_easy_v) {
+		if (!read_payload(payload)) {
+			return abort_v;
+		}
+	}
+
+	if constexpr (std::is_same_v<T, server_solvable_vars>) {
+		if (state == S::PENDING_WELCOME) {
+			LOG("Received initial vars from the upstream server.");
+			state = S::RECEIVING_INITIAL_STATE;
+		}
+
+		push(std::move(payload));
+	}
+	else if constexpr (std::is_same_v<T, server_vars>) {
+		/* Sent only because the relay authorizes with rcon. Of no interest to spectators. */
+	}
+	else if constexpr (std::is_same_v<T, server_broadcasted_chat>) {
+		const bool kicked =
+			payload.recipient_shall_kindly_leave
+			&& payload.target != chat_target_type::SERVER_SHUTTING_DOWN
+		;
+
+		if (kicked) {
+			LOG("The relay was kicked from the upstream server. Reason: %x", std::string(payload.message));
+			return abort_v;
+		}
+
+		push(std::move(payload));
+	}
+	else if constexpr (std::is_same_v<T, initial_arena_state_progress>) {
+		if (state < S::RECEIVING_INITIAL_STATE) {
+			LOG("The upstream server has sent initial state early (state: %x). Disconnecting.", state);
+			log_malicious_server();
+			return abort_v;
+		}
+
+		if (!read_payload(buffers, initial_state_progress)) {
+			return abort_v;
+		}
+	}
+	else if constexpr (std::is_same_v<T, initial_arena_state_payload<false>>) {
+		if (state < S::RECEIVING_INITIAL_STATE || !initial_state_progress.complete()) {
+			LOG("The upstream server has sent an incomplete initial state (state: %x). Disconnecting.", state);
+			log_malicious_server();
+			return abort_v;
+		}
+
+		LOG("Received initial state from the upstream server (%x bytes).", buffers.serialization.size());
+
+		push(relayed_initial_state { std::move(buffers.serialization) });
+
+		buffers.serialization = {};
+		initial_state_progress = {};
+
+		state = S::IN_GAME;
+	}
+	else if constexpr (std::is_same_v<T, networked_server_step_entropy>) {
+		if (state != S::IN_GAME) {
+			LOG("The upstream server has sent entropy too early (state: %x). Disconnecting.", state);
+			log_malicious_server();
+			return abort_v;
+		}
+
+		push(std::move(payload));
+
+		/*
+			Acknowledge every step with an empty command, just like an idle client would.
+			This also keeps the relay from being kicked for inactivity.
+		*/
+
+		auto idle_entropy = total_client_entropy();
+
+		adapter->send_payload(
+			game_channel_type::CLIENT_COMMANDS,
+			idle_entropy
+		);
+	}
+	else if constexpr (std::is_same_v<T, public_settings_update>) {
+		push(std::move(payload));
+	}
+	else if constexpr (std::is_same_v<T, net_statistics_update>) {
+		push(std::move(payload));
+	}
+	else if constexpr (std::is_same_v<T, state_hash_breakdown>) {
+		/*
+			Only ever sent in reply to a desync report.
+			The relay never reports one - by the time it verifies a step against the upstream hash,
+			the broadcast delay has long passed and the upstream no longer remembers its hashes of that step.
+		*/
+	}
+	else if constexpr (std::is_same_v<T, arena_player_avatar_payload>) {
+		relayed_avatar avatar;
+
+		if (!read_payload(avatar.session_id, avatar.avatar)) {
+			return abort_v;
+		}
+
+		push(std::move(avatar));
+	}
+	else {
+		static_assert(always_false_v<T>, "Unhandled payload type.");
+	}
+
+	return continue_v;
+}
+
+std::optional<relayed_server_event> server_relay::pop_released(const net_time_t now) {
+	auto released = events.pop_released(now, settings.broadcast_delay_secs);
+
+	if (released && std::holds_alternative<relayed_initial_state>(*released)) {
+		/* Whatever was requested has now arrived. */
+		resync_requested = false;
+	}
+
+	return released;
+}
+
+void server_relay::request_resync() {
+	if (resync_requested) {
+		return;
+	}
+
+	LOG("Requesting a resync from the upstream server.");
+
+	resync_requested = true;
+
+	const auto request = special_client_request::RESYNC;
+
+	adapter->send_payload(
+		game_channel_type::CLIENT_COMMANDS,
+		request
+	);
+}
+
+bool server_relay::has_finished() const {
+	const bool upstream_gone = adapter->is_disconnected() || adapter->has_connection_failed();
+	return upstream_gone && events.empty();
+}
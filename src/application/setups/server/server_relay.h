@@ -0,0 +1,89 @@
+#pragma once
+#include <memory>
+#include <optional>
+
+#include "augs/templates/propagate_const.h"
+#include "augs/misc/serialization_buffers.h"
+#include "augs/network/network_types.h"
+
+#include "application/network/client_state_type.h"
+#include "application/network/compressed_initial_arena_state.h"
+#include "application/setups/server/server_relay_events.h"
+#include "application/setups/server/server_relay_settings.h"
+
+class client_adapter;
+
+/*
+	A relay connects to a game server as a single privileged client
+	and re-serves the server's broadcast to spectators of its own.
+
+	Everything the upstream server sends is queued here in the order of arrival,
+	and released only once the broadcast delay has passed.
+	server_setup then applies the released events to its own referential cosmos
+	and forwards them downstream exactly as if it generated them itself.
+
+	Since the downstream protocol is identical to that of a game server,
+	a relay can just as well be connected to another relay.
+*/
+
+class server_relay {
+	server_relay_settings settings;
+	augs::propagate_const<std::unique_ptr<client_adapter>> adapter;
+
+	client_state_type state = client_state_type::INITIATING_CONNECTION;
+	net_time_t relay_time = 0.0;
+	bool resync_requested = false;
+
+	augs::serialization_buffers buffers;
+	initial_arena_state_progress initial_state_progress;
+
+	relayed_event_queue events;
+
+	/* Reflects the released events only. */
+	relayed_players players;
+
+	friend client_adapter;
+
+	template <class T>
+	void handle_server_message(T&) {}
+
+	template <class T, class F>
+	message_handler_result handle_server_payload(F&& read_payload);
+
+	void log_malicious_server();
+
+	template <class T>
+	void push(T&& event);
+
+public:
+	server_relay(const server_relay_settings&);
+	~server_relay();
+
+	void advance(net_time_t relay_time);
+	void send_packets();
+	void disconnect();
+
+	/* Pops the oldest event received at least broadcast_delay_secs before now. */
+	std::optional<relayed_server_event> pop_released(net_time_t now);
+
+	void request_resync();
+
+	bool is_resync_requested() const {
+		return resync_requested;
+	}
+
+	/* True once the upstream is gone and nothing more is left to release. */
+	bool has_finished() const;
+
+	auto& get_players() {
+		return players;
+	}
+
+	const auto& get_players() const {
+		return players;
+	}
+
+	const auto& get_settings() const {
+		return settings;
+	}
+};
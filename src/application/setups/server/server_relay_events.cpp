@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <utility>
+
+#include "application/setups/server/server_relay_events.h"
+
+void relayed_event_queue::push(const net_time_t received_at, relayed_server_event&& event) {
+	events.push_back({ received_at, std::move(event) });
+}
+
+std::optional<relayed_server_event> relayed_event_queue::pop_released(const net_time_t now, const float delay_secs) {
+	if (events.empty()) {
+		return std::nullopt;
+	}
+
+	auto& oldest = events.front();
+	const auto delay = std::max(delay_secs, 0.f);
+
+	if (now < oldest.received_at + delay) {
+		return std::nullopt;
+	}
+
+	auto released = std::make_optional(std::move(oldest.event));
+	events.pop_front();
+
+	return released;
+}
+
+void relayed_players::set(const public_settings_update& update) {
+	const auto i = static_cast<std::size_t>(update.subject_id.value);
+
+	if (i < public_settings.size()) {
+		public_settings[i] = update.new_settings;
+	}
+}
+
+per_character_input_settings relayed_players::get_character_input(const mode_player_id& id) const {
+	const auto i = static_cast<std::size_t>(id.value);
+
+	if (i < public_settings.size() && public_settings[i]) {
+		return public_settings[i]->character_input;
+	}
+
+	return {};
+}
+
+void relayed_players::remember(const relayed_avatar& new_avatar) {
+	for (auto& a : avatars) {
+		if (a.session_id == new_avatar.session_id) {
+			a.avatar = new_avatar.avatar;
+			return;
+		}
+	}
+
+	avatars.push_back(new_avatar);
+}
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+
+TEST_CASE("ServerRelay ReleasesEventsInOrderAfterTheDelay") {
+	relayed_event_queue queue;
+
+	auto step_with_hash = [](const uint32_t hash) {
+		networked_server_step_entropy step;
+		step.meta.state_hash = hash;
+		return relayed_server_event(step);
+	};
+
+	auto hash_of = [](const std::optional<relayed_server_event>& released) {
+		REQUIRE(released.has_value());
+		REQUIRE(std::holds_alternative<networked_server_step_entropy>(*released));
+
+		return *std::get<networked_server_step_entropy>(*released).meta.state_hash;
+	};
+
+	const auto delay = 2.f;
+
+	queue.push(0.0, step_with_hash(1));
+	queue.push(0.5, relayed_server_event(server_broadcasted_chat()));
+	queue.push(1.0, step_with_hash(2));
+
+	REQUIRE(!queue.pop_released(1.9, delay).has_value());
+	REQUIRE(hash_of(queue.pop_released(2.0, delay)) == 1);
+
+	/* The chat is due, the second step is not yet. */
+
+	{
+		const auto released = queue.pop_released(2.6, delay);
+		REQUIRE(released.has_value());
+		REQUIRE(std::holds_alternative<server_broadcasted_chat>(*released));
+	}
+
+	REQUIRE(!queue.pop_released(2.6, delay).has_value());
+	REQUIRE(queue.size() == 1);
+
+	REQUIRE(hash_of(queue.pop_released(3.0, delay)) == 2);
+	REQUIRE(queue.empty());
+}
+
+TEST_CASE("ServerRelay NegativeDelayReleasesImmediately") {
+	relayed_event_queue queue;
+
+	queue.push(5.0, relayed_server_event(net_statistics_update()));
+	queue.push(5.0, relayed_server_event(net_statistics_update()));
+
+	REQUIRE(queue.pop_released(5.0, -10.f).has_value());
+	REQUIRE(queue.pop_released(5.0, -10.f).has_value());
+	REQUIRE(queue.empty());
+}
+
+TEST_CASE("ServerRelay RemembersUpstreamPlayers") {
+	relayed_players players;
+
+	const auto first = mode_player_id(static_cast<mode_player_id::id_value_type>(1));
+	const auto other = mode_player_id(static_cast<mode_player_id::id_value_type>(2));
+
+	public_settings_update update;
+	update.subject_id = first;
+	update.new_settings.character_input.keep_movement_forces_relative_to_crosshair = true;
+
+	players.set(update);
+
+	REQUIRE(players.get_character_input(first).keep_movement_forces_relative_to_crosshair);
+	REQUIRE(players.get_character_input(other) == per_character_input_settings());
+	REQUIRE(players.get_character_input(mode_player_id::dead()) == per_character_input_settings());
+
+	std::size_t num_settings = 0;
+
+	players.for_each_public_settings([&](const public_settings_update& u) {
+		REQUIRE(u.subject_id == first);
+		++num_settings;
+	});
+
+	REQUIRE(num_settings == 1);
+
+	relayed_avatar avatar;
+	avatar.session_id = session_id_type(7);
+	avatar.avatar.image_bytes = { std::byte(1) };
+
+	players.remember(avatar);
+
+	avatar.avatar.image_bytes = { std::byte(2) };
+	players.remember(avatar);
+
+	REQUIRE(players.get_avatars().size() == 1);
+	REQUIRE(players.get_avatars()[0].avatar.image_bytes == std::vector<std::byte> { std::byte(2) });
+
+	players.erase_avatars_if([](const relayed_avatar& a) { return a.session_id == session_id_type(7); });
+	REQUIRE(players.get_avatars().empty());
+}
+#endif
@@ -0,0 +1,102 @@
+#pragma once
+#include <deque>
+#include <array>
+#include <vector>
+#include <variant>
+#include <optional>
+
+#include "augs/templates/container_templates.h"
+#include "augs/network/network_types.h"
+
+#include "application/network/server_step_entropy.h"
+#include "application/setups/server/server_vars.h"
+#include "application/setups/server/chat_structs.h"
+#include "application/setups/server/public_settings_update.h"
+#include "application/setups/server/net_statistics_update.h"
+#include "view/mode_gui/arena/arena_player_meta.h"
+
+/*
+	The part of server_relay that does not touch the network,
+	kept apart so that it can be tested without a connection.
+*/
+
+/* The decompressed initial state, decoded only once released - the arena it refers to might not be loaded yet. */
+
+struct relayed_initial_state {
+	std::vector<std::byte> serialized;
+};
+
+struct relayed_avatar {
+	session_id_type session_id;
+	arena_player_avatar_payload avatar;
+};
+
+using relayed_server_event = std::variant<
+	server_solvable_vars,
+	relayed_initial_state,
+	networked_server_step_entropy,
+	public_settings_update,
+	server_broadcasted_chat,
+	net_statistics_update,
+	relayed_avatar
+>;
+
+struct timed_relayed_event {
+	net_time_t received_at = 0.0;
+	relayed_server_event event;
+};
+
+/*
+	Upstream events in the order of arrival.
+	An event is released only once it is at least the broadcast delay old,
+	and never ahead of an older one.
+*/
+
+class relayed_event_queue {
+	std::deque<timed_relayed_event> events;
+
+public:
+	void push(net_time_t received_at, relayed_server_event&& event);
+
+	/* Pops the oldest event received at least delay_secs before now. A negative delay counts as none. */
+	std::optional<relayed_server_event> pop_released(net_time_t now, float delay_secs);
+
+	bool empty() const {
+		return events.empty();
+	}
+
+	std::size_t size() const {
+		return events.size();
+	}
+};
+
+/* What a relay remembers of the upstream players, to re-serve to its clients as they connect. */
+
+class relayed_players {
+	std::array<std::optional<public_client_settings>, max_mode_players_v> public_settings;
+	std::vector<relayed_avatar> avatars;
+
+public:
+	void set(const public_settings_update&);
+	per_character_input_settings get_character_input(const mode_player_id&) const;
+
+	void remember(const relayed_avatar&);
+
+	template <class F>
+	void erase_avatars_if(F&& predicate) {
+		erase_if(avatars, std::forward<F>(predicate));
+	}
+
+	template <class F>
+	void for_each_public_settings(F&& callback) const {
+		for (std::size_t i = 0; i < public_settings.size(); ++i) {
+			if (public_settings[i]) {
+				callback(public_settings_update { mode_player_id(static_cast<mode_player_id::id_value_type>(i)), *public_settings[i] });
+			}
+		}
+	}
+
+	const auto& get_avatars() const {
+		return avatars;
+	}
+};
@@ -0,0 +1,16 @@
+#pragma once
+#include <string>
+#include "application/network/address_and_port.h"
+#include "application/setups/client/client_vars.h"
+
+struct server_relay_settings {
+	// GEN INTROSPECTOR struct server_relay_settings
+	bool enabled = false;
+	address_and_port upstream;
+
+	client_nickname_type nickname = "Relay";
+	std::string upstream_rcon_password = "";
+
+	float broadcast_delay_secs = 0.f;
+	// END GEN INTROSPECTOR
+};
@@ -35,6 +35,8 @@
 #include "application/nat/stun_session.h"
 #include "augs/templates/bit_cast.h"
 #include "application/masterserver/gameserver_command_readwrite.h"
+#include "application/setups/server/server_relay.h"
+#include "game/cosmos/change_solvable_significant.h"
 
 const auto connected_and_integrated_v = server_setup::for_each_flags { server_setup::for_each_flag::WITH_INTEGRATED, server_setup::for_each_flag::ONLY_CONNECTED };
 const auto only_connected_v = server_setup::for_each_flags { server_setup::for_each_flag::ONLY_CONNECTED };
@@ -118,12 +120,15 @@ server_setup::server_setup(
 	const client_vars& integrated_client_vars,
 	const private_server_vars& private_initial_vars,
 	const std::optional<augs::dedicated_server_input> dedicated,
-	const server_nat_traversal_input& nat_traversal_input
+	const std::optional<server_relay_settings> relay_settings,
+	const server_nat_traversal_input& nat_traversal_input,
+	shared_arena_cache* const shared_arenas
 ) : 
 	integrated_client_vars(integrated_client_vars),
 	lua(lua),
 	last_start(in),
 	dedicated(dedicated),
+	shared_arenas(shared_arenas),
 	server(
 		std::make_unique<server_adapter>(
 			in,
@@ -136,6 +141,11 @@ server_setup::server_setup(
 			}
 		)
 	),
+	relay(
+		relay_settings != std::nullopt
+		? std::make_unique<server_relay>(*relay_settings)
+		: nullptr
+	),
 	server_time(yojimbo_time()),
 	nat_traversal(nat_traversal_input, resolved_server_list_addr)
 {
@@ -290,8 +300,17 @@ bool server_setup::server_list_enabled() const {
 	return server->is_running() && vars.notified_server_list.address.size() > 0;
 }
 
+void server_setup::use_server_list_address(const std::optional<netcode_address_t> new_addr) {
+	server_list_resolved_elsewhere = true;
+
+	if (new_addr != std::nullopt && new_addr != resolved_server_list_addr) {
+		request_immediate_heartbeat();
+		resolved_server_list_addr = new_addr;
+	}
+}
+
 void server_setup::resolve_heartbeat_host_if_its_time() {
-	if (!server_list_enabled()) {
+	if (!server_list_enabled() || server_list_resolved_elsewhere) {
 		return;
 	}
 
@@ -429,6 +448,11 @@ mode_player_id server_setup::to_mode_player_id(const client_id_type& id) {
 }
 
 std::optional<session_id_type> server_setup::find_session_id(const client_id_type& id) {
+	if (is_relay()) {
+		/* Our clients never join the relayed mode - whoever has this id in there is an upstream player. */
+		return std::nullopt;
+	}
+
 	return get_arena_handle().on_mode(
 		[&](const auto& mode) -> std::optional<session_id_type> {
 			if (const auto entry = mode.find(to_mode_player_id(id))) {
@@ -638,6 +662,9 @@ void server_setup::apply(const config_lua_table& cfg) {
 void server_setup::choose_arena(const std::string& name) {
 	LOG("Choosing arena: %x", name);
 
+	/* They still read the reference solvable and the flavours of the current arena. */
+	finish_initial_state_jobs();
+
 	solvable_vars.current_arena = name;
 
 	const auto& arena = get_arena_handle();
@@ -646,7 +673,8 @@ void server_setup::choose_arena(const std::string& name) {
 		lua,
 		arena,
 		solvable_vars,
-		initial_signi
+		initial_cosm,
+		shared_arenas
 	);
 
 	arena_gui.reset();
@@ -686,6 +714,398 @@ void server_setup::init_client(const client_id_type& id) {
 void server_setup::unset_client(const client_id_type& id) {
 	LOG("Client disconnected. Details:\n%x", describe_client(id));
 	clients[id].unset();
+
+	for (auto& t : initial_state_transfers) {
+		erase_if(t.recipients, [id](const initial_arena_state_recipient& r) {
+			return r.client_id == id;
+		});
+	}
+}
+
+void server_setup::send_initial_arena_state(const client_id_type& client_id) {
+	auto& c = clients[client_id];
+
+	if (c.awaits_initial_state) {
+		/* The state being sent is recent enough. */
+		return;
+	}
+
+	c.awaits_initial_state = true;
+
+	/* 
+		Everything sent later on this channel, e.g. the steps, 
+		must arrive after the state, so hold it until the state is sent.
+	*/
+
+	server->hold_messages(client_id, game_channel_type::SERVER_SOLVABLE_AND_STEPS);
+
+	const auto step = current_simulation_step;
+
+	if (!initial_state_transfers.empty() && initial_state_transfers.back().step == step) {
+		initial_state_transfers.back().recipients.push_back({ client_id });
+		return;
+	}
+
+	/*
+		Only copying the state happens on the tick.
+		Serialization and compression both run on a worker thread.
+
+		The reference solvable and the flavours are only ever changed by choose_arena,
+		which waits for the pending jobs first.
+	*/
+
+	auto snapshot = [&]() {
+		auto scope = measure_scope(profiler.serialize_initial_state);
+
+		return std::make_unique<const std::pair<cosmos_solvable_significant, online_mode_and_rules>>(
+			scene.world.get_solvable().significant,
+			current_mode
+		);
+	}();
+
+	auto serialization_buffer = std::move(spare_serialization_buffer);
+	spare_serialization_buffer.clear();
+
+	initial_arena_state_transfer new_transfer;
+	new_transfer.step = step;
+	new_transfer.recipients.push_back({ client_id });
+
+	new_transfer.job = launch_async(
+		[
+			snapshot = std::move(snapshot),
+			serialized = std::move(serialization_buffer),
+			&initial_signi = std::as_const(initial_cosm.get_solvable().significant),
+			&flavours = std::as_const(scene.world.get_common_significant().flavours)
+		]() mutable {
+			::serialize_initial_arena_state(
+				serialized,
+				initial_signi,
+				flavours,
+				snapshot->first,
+				snapshot->second
+			);
+
+			initial_arena_state_job_result result;
+			result.compressed = ::compress_initial_arena_state(serialized);
+			result.serialization_buffer = std::move(serialized);
+
+			return result;
+		}
+	);
+
+	initial_state_transfers.emplace_back(std::move(new_transfer));
+}
+
+void server_setup::finish_initial_state_jobs() {
+	for (auto& t : initial_state_transfers) {
+		if (t.job.valid()) {
+			t.job.wait();
+		}
+	}
+}
+
+bool server_setup::stream_initial_arena_state(
+	const initial_arena_state_transfer& t,
+	initial_arena_state_recipient& r
+) {
+	const auto client_id = r.client_id;
+	const auto& compressed = *t.compressed;
+	const auto num_chunks = static_cast<uint32_t>(compressed.chunks.size());
+
+	if (!server->is_client_connected(client_id)) {
+		clients[client_id].awaits_initial_state = false;
+		return true;
+	}
+
+	/*
+		Chunks are sent ahead of the held messages in small batches,
+		never more than the send queue of the channel has room for.
+		The rest is sent with the following ticks.
+	*/
+
+	const bool previous_batch_acked = !server->has_messages_to_send(client_id, game_channel_type::SERVER_SOLVABLE_AND_STEPS);
+
+	if (r.next_chunk < num_chunks && previous_batch_acked) {
+		const auto batch_end = std::min(num_chunks, r.next_chunk + initial_arena_state_chunks_per_batch_v);
+
+		while (r.next_chunk < batch_end) {
+			const bool sent = server->send_payload_ahead_of_held(
+				client_id, 
+
+				compressed,
+				r.next_chunk
+			);
+
+			if (!sent) {
+				break;
+			}
+
+			++r.next_chunk;
+		}
+	}
+
+	if (r.next_chunk < num_chunks) {
+		return false;
+	}
+
+	/* Spectators of a relay get an id that no upstream player could have. */
+
+	const auto id_for_client = is_relay() ? mode_player_id::dead().value : static_cast<uint32_t>(client_id);
+
+	const auto for_client = initial_arena_state_for_client { 
+		id_for_client,
+		get_rcon_level(client_id)
+	};
+
+	const bool sent = server->send_payload_ahead_of_held(
+		client_id, 
+
+		for_client
+	);
+
+	if (!sent) {
+		return false;
+	}
+
+	server->release_held_messages(client_id);
+	clients[client_id].awaits_initial_state = false;
+
+	LOG(
+		"Sent initial state of step %x to %x in %x chunks (%x bytes uncompressed).", 
+		t.step, 
+		client_id, 
+		num_chunks, 
+		compressed.uncompressed_size
+	);
+
+	return true;
+}
+
+void server_setup::advance_initial_state_transfers() {
+	erase_if(initial_state_transfers, [&](initial_arena_state_transfer& t) {
+		if (t.compressed == std::nullopt) {
+			if (!valid_and_is_ready(t.job)) {
+				return false;
+			}
+
+			auto result = t.job.get();
+
+			t.compressed.emplace(std::move(result.compressed));
+
+			if (result.serialization_buffer.capacity() > spare_serialization_buffer.capacity()) {
+				spare_serialization_buffer = std::move(result.serialization_buffer);
+			}
+		}
+
+		erase_if(t.recipients, [&](initial_arena_state_recipient& r) {
+			return stream_initial_arena_state(t, r);
+		});
+
+		return t.recipients.empty();
+	});
+}
+
+void server_setup::advance_relay_upstream() {
+	relay->advance(server_time);
+	relay->send_packets();
+
+	if (relay->has_finished() && !schedule_shutdown) {
+		LOG("Lost the connection to the upstream server. Shutting down the relay.");
+
+		server_broadcasted_chat message;
+		message.target = chat_target_type::SERVER_SHUTTING_DOWN;
+		message.recipient_shall_kindly_leave = true;
+
+		broadcast(message);
+
+		schedule_shutdown = true;
+	}
+}
+
+std::optional<networked_server_step_entropy> server_setup::release_relayed_events() {
+	while (auto released = relay->pop_released(server_time)) {
+		if (auto* const step = std::get_if<networked_server_step_entropy>(std::addressof(*released))) {
+			return std::move(*step);
+		}
+
+		std::visit(
+			[this](auto& event) {
+				handle_relayed_event(event);
+			},
+			*released
+		);
+	}
+
+	return std::nullopt;
+}
+
+template <class T>
+void server_setup::handle_relayed_event(T& event) {
+	if constexpr(std::is_same_v<T, server_solvable_vars>) {
+		/* Until the first state arrives, whatever arena we have loaded comes from our own config. */
+		const bool force = !relay_ready;
+
+		apply(event, force);
+	}
+	else if constexpr(std::is_same_v<T, relayed_initial_state>) {
+		try {
+			cosmic::change_solvable_significant(
+				scene.world, 
+				[&](cosmos_solvable_significant& signi) {
+					::deserialize_initial_arena_state(
+						event.serialized,
+						initial_cosm.get_solvable().significant,
+						signi,
+						current_mode
+					);
+
+					return changer_callback_result::REFRESH;
+				}
+			);
+		}
+		catch (const augs::stream_read_error& err) {
+			LOG("Failed to read the initial state relayed from the upstream server: %x", err.what());
+			relay->disconnect();
+
+			return;
+		}
+
+		/* 
+			If this corrects our state, our clients will notice with the next state hash
+			and ask us for a resync themselves.
+		*/
+
+		LOG("Applied the relayed initial state at step: %x.", scene.world.get_total_steps_passed());
+
+		relay_ready = true;
+	}
+	else if constexpr(std::is_same_v<T, public_settings_update>) {
+		relay->get_players().set(event);
+
+		auto forward_update = [this, &event](const auto recipient_client_id, auto&) {
+			server->send_payload(
+				recipient_client_id, 
+				game_channel_type::SERVER_SOLVABLE_AND_STEPS,
+
+				event
+			);
+		};
+
+		for_each_id_and_client(forward_update, only_connected_v);
+	}
+	else if constexpr(std::is_same_v<T, server_broadcasted_chat>) {
+		broadcast(event);
+
+		if (event.target == chat_target_type::SERVER_SHUTTING_DOWN) {
+			LOG("The upstream server is shutting down. Shutting down the relay.");
+			schedule_shutdown = true;
+		}
+	}
+	else if constexpr(std::is_same_v<T, net_statistics_update>) {
+		auto forward_stats = [this, &event](const auto recipient_client_id, const auto& c) {
+			if (c.state != client_state_type::IN_GAME) {
+				return;
+			}
+
+			server->send_payload(
+				recipient_client_id,
+				game_channel_type::VOLATILE_STATISTICS,
+
+				event
+			);
+		};
+
+		for_each_id_and_client(forward_stats, only_connected_v);
+	}
+	else if constexpr(std::is_same_v<T, relayed_avatar>) {
+		relay->get_players().remember(event);
+
+		auto forward_avatar = [this, &event](const auto recipient_client_id, auto&) {
+			server->send_payload(
+				recipient_client_id,
+				game_channel_type::COMMUNICATIONS,
+
+				event.session_id,
+				event.avatar
+			);
+		};
+
+		for_each_id_and_client(forward_avatar, only_connected_v);
+	}
+	else {
+		static_assert(always_false_v<T>, "Unhandled relayed event type.");
+	}
+}
+
+void server_setup::verify_relayed_step(const server_step_entropy_meta& meta) {
+	if (meta.reinference_necessary) {
+		/* Reinfer along with the upstream and pass it on to our clients. */
+		reinference_necessary = true;
+	}
+
+	if (meta.state_hash == std::nullopt || relay->is_resync_requested()) {
+		return;
+	}
+
+	const auto calculated_hash = get_arena_handle().get_cosmos().calculate_solvable_signi_hash<uint32_t>();
+
+	if (calculated_hash != *meta.state_hash) {
+		LOG("The relayed state diverged from the upstream server at step: %x.", scene.world.get_total_steps_passed());
+		relay->request_resync();
+	}
+}
+
+uint32_t server_setup::calculate_and_remember_state_hash() {
+	const auto& cosm = get_arena_handle().get_cosmos();
+
+	state_hash_breakdown breakdown;
+	breakdown.step = static_cast<uint32_t>(cosm.get_total_steps_passed());
+	breakdown.hashes = cosm.calculate_solvable_signi_hashes();
+
+	recent_hash_breakdowns[breakdown.step % recent_hash_breakdowns.size()] = breakdown;
+
+	return breakdown.hashes.combined();
+}
+
+const state_hash_breakdown* server_setup::find_recent_hash_breakdown(const uint32_t step) const {
+	const auto& entry = recent_hash_breakdowns[step % recent_hash_breakdowns.size()];
+
+	if (entry.has_value() && entry->step == step) {
+		return std::addressof(*entry);
+	}
+
+	return nullptr;
+}
+
+void server_setup::send_relayed_metas(const client_id_type& recipient_client_id) {
+	/* Sessions that left in the meantime will never need their avatars again. */
+
+	relay->get_players().erase_avatars_if([this](const relayed_avatar& a) {
+		return get_arena_handle().on_mode(
+			[&](const auto& typed_mode) {
+				return typed_mode.find(a.session_id) == nullptr;
+			}
+		);
+	});
+
+	for (const auto& a : relay->get_players().get_avatars()) {
+		server->send_payload(
+			recipient_client_id,
+			game_channel_type::COMMUNICATIONS,
+
+			a.session_id,
+			a.avatar
+		);
+	}
+
+	relay->get_players().for_each_public_settings([&](const public_settings_update& update) {
+		server->send_payload(
+			recipient_client_id,
+			game_channel_type::SERVER_SOLVABLE_AND_STEPS,
+
+			update
+		);
+	});
 }
 
 void server_setup::disconnect_and_unset(const client_id_type& id) {
@@ -697,6 +1117,11 @@ void server_setup::accept_entropy_of_client(
 	const mode_player_id mode_id,
 	const total_client_entropy& entropy
 ) {
+	if (is_relay()) {
+		/* The commands are only acknowledged. Spectators of a relay can't affect the relayed match. */
+		return;
+	}
+
 	if (!entropy.empty()) {
 		step_collected += { mode_id, entropy };
 	}
@@ -740,7 +1165,7 @@ void server_setup::advance_clients_state() {
 		}
 
 		if (!c.is_set()) {
-			if (!removed_someone_already) {
+			if (!removed_someone_already && !is_relay()) {
 				if (player_added_to_mode(mode_id)) {
 					ensure(!removed_someone_already);
 
@@ -841,8 +1266,6 @@ void server_setup::advance_clients_state() {
 		};
 
 		auto send_state_for_the_first_time = [&]() {
-			const auto sent_client_id = static_cast<uint32_t>(client_id);
-
 			server->send_payload(
 				client_id, 
 				game_channel_type::SERVER_SOLVABLE_AND_STEPS, 
@@ -861,24 +1284,12 @@ void server_setup::advance_clients_state() {
 				);
 			}
 
-			server->send_payload(
-				client_id, 
-				game_channel_type::SERVER_SOLVABLE_AND_STEPS, 
-
-				buffers,
+			send_initial_arena_state(client_id);
 
-				initial_signi,
-				scene.world.get_common_significant().flavours,
-
-				initial_arena_state_payload<true> {
-					scene.world.get_solvable().significant,
-					current_mode,
-					sent_client_id,
-					rcon_level
-				}
-			);
-
-			{
+			if (is_relay()) {
+				send_relayed_metas(client_id);
+			}
+			else {
 				auto download_existing_avatar = [this, recipient_client_id = client_id](const auto client_id_of_avatar, auto& cc) {
 					const auto session_id_of_avatar = find_session_id(client_id_of_avatar);
 
@@ -894,9 +1305,7 @@ void server_setup::advance_clients_state() {
 				};
 
 				for_each_id_and_client(download_existing_avatar, connected_and_integrated_v);
-			}
 
-			{
 				auto download_existing_public_settings  = [this, recipient_client_id = client_id](const auto client_id_of_settings, auto& cc) {
 					const auto downloaded_settings = make_public_settings_update_from(cc, client_id_of_settings);
 
@@ -914,7 +1323,25 @@ void server_setup::advance_clients_state() {
 			LOG("Sending initial payload for %x at step: %x", client_id, scene.world.get_total_steps_passed());
 		};
 
-		if (!added_someone_already) {
+		const bool stays_out_of_mode = is_relay() || c.authorized_relay;
+
+		if (stays_out_of_mode) {
+			/* A relay has nothing to serve until the upstream sends its state. */
+			const bool can_serve = !is_relay() || relay_ready;
+
+			if (c.state == S::WELCOME_ARRIVED) {
+				if (can_serve) {
+					send_state_for_the_first_time();
+
+					c.state = S::RECEIVING_INITIAL_STATE;
+				}
+				else {
+					/* Don't time out the clients that wait for the broadcast delay to pass. */
+					c.last_valid_message_time = server_time;
+				}
+			}
+		}
+		else if (!added_someone_already) {
 			if (c.state > client_state_type::PENDING_WELCOME) {
 				if (!player_added_to_mode(mode_id)) {
 					if (add_client_to_mode()) {
@@ -932,7 +1359,7 @@ void server_setup::advance_clients_state() {
 			}
 		}
 
-		if (c.state == client_state_type::IN_GAME) {
+		if (c.state == client_state_type::IN_GAME && !stays_out_of_mode) {
 			if (c.should_kick_due_to_afk(vars, server_time)) {
 				kick(client_id, "AFK!");
 			}
@@ -969,6 +1396,11 @@ message_handler_result server_setup::handle_rcon_payload(
 	constexpr auto continue_v = message_handler_result::CONTINUE;
 
 	if constexpr(std::is_same_v<P, match_command>) {
+		if (is_relay()) {
+			LOG("Ignoring the match command. The match is controlled by the upstream server.");
+			return continue_v;
+		}
+
 		local_collected.mode_general.special_command = typed_payload;
 
 		return continue_v;
@@ -1001,6 +1433,11 @@ message_handler_result server_setup::handle_rcon_payload(
 		return continue_v;
 	}
 	else if constexpr(std::is_same_v<P, server_solvable_vars>) {
+		if (is_relay()) {
+			LOG("Ignoring new solvable vars. They are controlled by the upstream server.");
+			return continue_v;
+		}
+
 		LOG("New server solvable vars from the client (%x).", typed_payload.current_arena);
 
 		apply(typed_payload, true);
@@ -1050,9 +1487,21 @@ message_handler_result server_setup::handle_client_message(
 		if (c.state == S::PENDING_WELCOME) {
 			LOG("Client %x requested nickname: %x", client_id, std::string(c.settings.chosen_nickname));
 			c.state = S::WELCOME_ARRIVED;
+
+			if (c.settings.as_relay) {
+				c.authorized_relay = get_rcon_level(client_id) >= rcon_level_type::BASIC;
+
+				if (c.authorized_relay) {
+					LOG("Client %x will relay the match.", client_id);
+				}
+				else {
+					LOG("Client %x wants to relay the match, but is not authorized. Treating it as a regular client.", client_id);
+				}
+			}
 		}
 
-		c.rebroadcast_public_settings = true;
+		/* Neither a relay nor a relay's spectator is a player whose settings could matter. */
+		c.rebroadcast_public_settings = !is_relay() && !c.authorized_relay;
 		c.last_keyboard_activity_time = server_time;
 	}
 	else if constexpr (std::is_same_v<T, rcon_command_variant>) {
@@ -1137,41 +1586,56 @@ message_handler_result server_setup::handle_client_message(
 
 				LOG("Client has asked for a resync no %x.", c.resyncs_counter);
 
+				c.desync_reported = false;
+
 				if (c.resyncs_counter > vars.max_client_resyncs) {
 					LOG("Client is asking for a resync too often! Kicking.");
 					return abort_v;
 				}
 
-				{
-					const auto rcon_level = get_rcon_level(client_id);
+				send_initial_arena_state(client_id);
 
-					server->send_payload(
-						client_id, 
-						game_channel_type::SERVER_SOLVABLE_AND_STEPS, 
+				reinference_necessary = true;
 
-						buffers,
+				break;
 
-						initial_signi,
-						scene.world.get_common_significant().flavours,
+			default: return abort_v;
+		}
+	}
+	else if constexpr (std::is_same_v<T, state_hash_breakdown>) {
+		const auto& client_breakdown = payload;
 
-						initial_arena_state_payload<true> {
-							scene.world.get_solvable().significant,
-							current_mode,
-							client_id,
-							rcon_level
-						}
-					);
-				}
+		if (c.desync_reported) {
+			LOG("Client %x has reported a desync again before asking for a resync. Ignoring.", client_id);
+		}
+		else if (const auto our_breakdown = find_recent_hash_breakdown(client_breakdown.step)) {
+			c.desync_reported = true;
+
+			LOG(
+				"Client %x desynchronized at step %x. Parts of its state that differ from ours are marked with *:\n%x",
+				client_id,
+				client_breakdown.step,
+				our_breakdown->hashes.describe(std::addressof(client_breakdown.hashes))
+			);
 
-				reinference_necessary = true;
+			server->send_payload(
+				client_id,
+				game_channel_type::COMMUNICATIONS,
 
-				break;
+				*our_breakdown
+			);
+		}
+		else {
+			c.desync_reported = true;
 
-			default: return abort_v;
+			LOG("Client %x reported a desync at step %x, which is too old to compare.", client_id, client_breakdown.step);
 		}
 	}
 	else if constexpr (std::is_same_v<T, arena_player_avatar_payload>) {
-		{
+		if (is_relay()) {
+			/* Spectators of a relay have no sessions to show the avatars with. */
+		}
+		else {
 			session_id_type dummy_id;
 			arena_player_avatar_payload payload;
 
@@ -1277,13 +1741,25 @@ void server_setup::send_server_step_entropies(const compact_server_step_entropy&
 			ticks_remaining = vars.state_hash_once_every_tick;
 			--ticks_remaining;
 
-			const auto calculated_hash = get_arena_handle().get_cosmos().calculate_solvable_signi_hash<uint32_t>();
-			return calculated_hash;
+			return calculate_and_remember_state_hash();
 		}
 
 		return std::nullopt;
 	}();
 
+	/* 
+		Serialize the step only once. 
+		Every client receives a copy of the same bytes with only the leading context patched.
+	*/
+
+	preserialized_server_step_entropy preserialized;
+
+	const bool step_serialized = net_messages::preserialize(preserialized, total);
+
+	if (!step_serialized) {
+		LOG("WARNING! Failed to serialize the server step entropy.");
+	}
+
 	auto process_client = [&](const auto client_id, auto& c) {
 		const bool its_time_already = 
 			c.state >= client_state_type::RECEIVING_INITIAL_STATE
@@ -1293,34 +1769,30 @@ void server_setup::send_server_step_entropies(const compact_server_step_entropy&
 			return;
 		}
 
-		{
-			{
-				prestep_client_context context;
-				context.num_entropies_accepted = c.num_entropies_accepted;
+		prestep_client_context context;
+		context.num_entropies_accepted = c.num_entropies_accepted;
 
 #if CONTEXTS_SEPARATE
-				server->send_payload(
-					client_id, 
-					game_channel_type::SERVER_SOLVABLE_AND_STEPS,
+		server->send_payload(
+			client_id, 
+			game_channel_type::SERVER_SOLVABLE_AND_STEPS,
 
-					context
-				);
-#else
-				total.context = context;
+			context
+		);
 #endif
-			}
 
-			/* Reset the counter */
-			c.num_entropies_accepted = 0;
-		}
+		/* Reset the counter */
+		c.num_entropies_accepted = 0;
 
-		/* TODO PERFORMANCE: only serialize the message once and multicast the same buffer to all clients! */
-		server->send_payload(
-			client_id,
-			game_channel_type::SERVER_SOLVABLE_AND_STEPS,
+		if (step_serialized) {
+			server->send_payload(
+				client_id,
+				game_channel_type::SERVER_SOLVABLE_AND_STEPS,
 
-			total
-		);
+				preserialized,
+				context
+			);
+		}
 	};
 
 	for_each_id_and_client(process_client, only_connected_v);
@@ -1328,11 +1800,13 @@ void server_setup::send_server_step_entropies(const compact_server_step_entropy&
 	{
 		const auto& interval = vars.send_net_statistics_update_once_every_secs;
 
-		if (interval > 0 && server_time - when_last_sent_net_statistics > std::max(interval, 0.5f)) {
+		/* A relay forwards the statistics of the upstream players instead. */
+
+		if (!is_relay() && interval > 0 && server_time - when_last_sent_net_statistics > std::max(interval, 0.5f)) {
 			net_statistics_update update;
 
 			auto gather_stats = [&](const auto client_id, const auto& c) {
-				if (c.state != client_state_type::IN_GAME) {
+				if (c.state != client_state_type::IN_GAME || c.authorized_relay) {
 					return;
 				}
 
@@ -1491,15 +1965,20 @@ bool server_setup::should_have_admin_character() const {
 	return is_integrated();
 }
 
-void server_setup::sleep_until_next_tick() {
+double server_setup::get_sleep_secs_until_next_tick() const {
 	const auto sleep_dt = server_time - get_current_time();
 
 	if (sleep_dt > 0.0) {
 		const auto mult = std::clamp(vars.sleep_mult, 0.f, 0.9f);
+		return static_cast<float>(sleep_dt) * mult;
+	}
 
-		if (mult > 0.f) {
-			yojimbo_sleep(static_cast<float>(sleep_dt) * mult);
-		}
+	return 0.0;
+}
+
+void server_setup::sleep_until_next_tick() {
+	if (const auto secs = get_sleep_secs_until_next_tick(); secs > 0.0) {
+		yojimbo_sleep(secs);
 	}
 }
 
@@ -1517,6 +1996,10 @@ server_step_entropy server_setup::unpack(const compact_server_step_entropy& n) c
 	};
 
 	auto get_settings_for = [&](const mode_player_id& mode_id) {
+		if (is_relay()) {
+			return relay->get_players().get_character_input(mode_id);
+		}
+
 		if (mode_id == mode_player_id::machine_admin()) {
 			return integrated_client.settings.public_settings.character_input;
 		}
@@ -1625,7 +2108,7 @@ void server_setup::broadcast(const ::server_broadcasted_chat& payload, const std
 		}
 
 		if (payload.target == chat_target_type::TEAM_ONLY) {
-			const auto recipient_player = get_arena_handle().on_mode(
+			const auto recipient_player = is_relay() ? nullptr : get_arena_handle().on_mode(
 				[&](const auto& typed_mode) {
 					return typed_mode.find(to_mode_player_id(recipient_client_id));
 				}
@@ -1774,6 +2257,10 @@ bool server_setup::is_dedicated() const {
 	return dedicated != std::nullopt;
 }
 
+bool server_setup::is_relay() const {
+	return relay.get() != nullptr;
+}
+
 void server_setup::handle_new_session(const add_player_input&) {
 	rebuild_player_meta_viewables = true;
 }
@@ -1789,15 +2276,22 @@ void server_setup::log_performance() {
 				profiler.prepare_summary_info();
 
 				const auto summary = typesafe_sprintf(
-					"S: %3f, SS: %3f, AA: %3f, ACS: %3f, SE: %3f, SP: %3f",
+					"S: %3f (p50: %3f, p99: %3f), SS: %3f (p50: %3f, p99: %3f), AA: %3f, ACS: %3f, SE: %3f, SP: %3f",
 					1000 * profiler.step.get_summary_info().value,
+					1000 * profiler.step.get_percentile_units(0.5),
+					1000 * profiler.step.get_percentile_units(0.99),
 					1000 * profiler.solve_simulation.get_summary_info().value,
+					1000 * profiler.solve_simulation.get_percentile_units(0.5),
+					1000 * profiler.solve_simulation.get_percentile_units(0.99),
 					1000 * profiler.advance_adapter.get_summary_info().value,
 					1000 * profiler.advance_clients_state.get_summary_info().value,
 					1000 * profiler.send_entropies.get_summary_info().value,
 					1000 * profiler.send_packets.get_summary_info().value
 				);
 
+				profiler.step.reset_percentiles();
+				profiler.solve_simulation.reset_percentiles();
+
 				last_logged_at = server_time;
 				LOG(summary);
 			}
@@ -1824,6 +2318,8 @@ const netcode_socket_t* server_setup::find_underlying_socket() const {
 #include "augs/misc/lua/lua_utils.h"
 #include <sol2/sol.hpp>
 #include "augs/readwrite/lua_file.h"
+#include "augs/network/netcode_socket_raii.h"
+#include "application/nat/stun_server_provider.h"
 
 TEST_CASE("NetSerialization EmptyEntropies") {
 	{
@@ -1964,6 +2460,43 @@ TEST_CASE("NetSerialization ServerEntropy") {
 	REQUIRE(naive_bytes_of_received == naive_bytes);
 }
 
+TEST_CASE("NetSerialization PreserializedServerEntropy") {
+	networked_server_step_entropy sent;
+	sent.meta.state_hash = 0xdeadbeef;
+
+	total_mode_player_entropy t;
+	t.cosmic.motions[game_motion_type::MOVE_CROSSHAIR] = { -127, 128 };
+	t.cosmic.intents.push_back({ game_intent_type::USE, intent_change::PRESSED });
+
+	sent.payload.players.push_back({ mode_player_id::first(), t });
+
+	preserialized_server_step_entropy preserialized;
+	REQUIRE(net_messages::preserialize(preserialized, sent));
+
+	for (const uint8_t accepted : { 0, 1, 7, 255 }) {
+		prestep_client_context context;
+		context.num_entropies_accepted = accepted;
+
+		net_messages::server_step_entropy from_preserialized;
+		from_preserialized.Release();
+		REQUIRE(from_preserialized.write_payload(preserialized, context));
+
+#if !CONTEXTS_SEPARATE
+		sent.context = context;
+
+		net_messages::server_step_entropy serialized_separately;
+		serialized_separately.Release();
+		REQUIRE(serialized_separately.write_payload(sent));
+
+		REQUIRE(from_preserialized.bytes == serialized_separately.bytes);
+#endif
+
+		networked_server_step_entropy received;
+		REQUIRE(from_preserialized.read_payload(received));
+		REQUIRE(received == sent);
+	}
+}
+
 TEST_CASE("NetSerialization ServerEntropySecond") {
 	net_messages::server_step_entropy ss;
 	ss.Release();
@@ -2027,4 +2560,114 @@ TEST_CASE("NetSerialization ServerEntropySecond") {
 	REQUIRE(received == sent);
 }
 
+TEST_CASE("ServerRelay UpstreamToRelayToSpectator") {
+	/*
+		Everything on the loopback:
+		a dedicated server, a relay of it,
+		and a server_relay connected to the relay, standing in for a spectator.
+	*/
+
+	auto reserve_free_port = [](const port_type after) {
+		for (uint32_t candidate = after + 1; candidate <= std::numeric_limits<port_type>::max(); ++candidate) {
+			try {
+				const auto probe = netcode_socket_raii(static_cast<port_type>(candidate));
+				(void)probe;
+
+				return static_cast<port_type>(candidate);
+			}
+			catch (const netcode_socket_raii_error&) {}
+		}
+
+		FAIL("No free port for the loopback test.");
+		return port_type(0);
+	};
+
+	auto stun_provider = stun_server_provider(nat_detection_settings().stun_server_list);
+	const auto nat_input = server_nat_traversal_input { nat_detection_settings(), nat_traversal_settings(), stun_provider };
+
+	auto vars = server_vars();
+	vars.allow_nat_traversal = false;
+	vars.notified_server_list.address = "";
+
+	const auto solvable_vars = server_solvable_vars();
+	const auto dedicated = augs::dedicated_server_input();
+
+	auto upstream_start = augs::server_listen_input();
+	upstream_start.port = reserve_free_port(32000);
+
+	auto relay_start = augs::server_listen_input();
+	relay_start.port = reserve_free_port(upstream_start.port);
+
+	auto to_localhost = [](const port_type port) {
+		server_relay_settings settings;
+
+		settings.enabled = true;
+		settings.upstream.address = typesafe_sprintf("127.0.0.1:%x", port);
+		settings.broadcast_delay_secs = 0.f;
+
+		return settings;
+	};
+
+	auto upstream_lua = augs::create_lua_state();
+	auto relay_lua = augs::create_lua_state();
+
+	server_setup upstream(upstream_lua, upstream_start, vars, solvable_vars, client_vars(), private_server_vars(), dedicated, std::nullopt, nat_input);
+	server_setup relay(relay_lua, relay_start, vars, solvable_vars, client_vars(), private_server_vars(), dedicated, to_localhost(upstream_start.port), nat_input);
+	server_relay spectator(to_localhost(relay_start.port));
+
+	REQUIRE(upstream.is_running());
+	REQUIRE(relay.is_running());
+
+	network_profiler upstream_performance;
+	network_profiler relay_performance;
+	server_network_info upstream_stats;
+	server_network_info relay_stats;
+
+	bool received_vars = false;
+	bool received_initial_state = false;
+	std::size_t received_steps = 0;
+
+	const auto zoom = 1.f;
+	const auto give_up_at = yojimbo_time() + 15.0;
+
+	while (yojimbo_time() < give_up_at && received_steps < 10) {
+		upstream.advance({ vec2i(), input_settings(), zoom, nat_detection_result(), upstream_performance, upstream_stats }, solver_callbacks());
+		relay.advance({ vec2i(), input_settings(), zoom, nat_detection_result(), relay_performance, relay_stats }, solver_callbacks());
+
+		const auto now = yojimbo_time();
+
+		spectator.advance(now);
+		spectator.send_packets();
+
+		while (const auto released = spectator.pop_released(now)) {
+			std::visit(
+				[&](const auto& event) {
+					using E = remove_cref<decltype(event)>;
+
+					if constexpr(std::is_same_v<E, server_solvable_vars>) {
+						received_vars = true;
+					}
+					else if constexpr(std::is_same_v<E, relayed_initial_state>) {
+						REQUIRE(received_vars);
+						REQUIRE(!event.serialized.empty());
+
+						received_initial_state = true;
+					}
+					else if constexpr(std::is_same_v<E, networked_server_step_entropy>) {
+						REQUIRE(received_initial_state);
+						++received_steps;
+					}
+				},
+				*released
+			);
+		}
+
+		yojimbo_sleep(1.0 / 1000);
+	}
+
+	REQUIRE(received_vars);
+	REQUIRE(received_initial_state);
+	REQUIRE(received_steps >= 10);
+}
+
 #endif
@@ -22,11 +22,12 @@
 #include "application/predefined_rulesets.h"
 #include "application/arena/mode_and_rules.h"
 #include "augs/readwrite/memory_stream_declaration.h"
-#include "augs/misc/serialization_buffers.h"
 
 #include "application/network/server_step_entropy.h"
+#include "application/network/state_hash_breakdown.h"
 #include "view/mode_gui/arena/arena_gui_mixin.h"
 #include "application/network/network_common.h"
+#include "application/network/compressed_initial_arena_state.h"
 
 #include "augs/build_settings/setting_dump.h"
 #include "application/setups/server/chat_structs.h"
@@ -35,6 +36,7 @@
 #include "3rdparty/yojimbo/netcode.io/netcode.h"
 #include "application/nat/nat_type.h"
 #include "application/setups/server/server_nat_traversal.h"
+#include "application/setups/server/server_relay_settings.h"
 
 #if DUMP_BEFORE_AND_AFTER_ROUND_START
 #include "game/modes/dump_for_debugging.h"
@@ -58,6 +60,34 @@ struct add_to_arena_input {
 };
 
 class server_adapter;
+class server_relay;
+class shared_arena_cache;
+
+/*
+	A copy of the state at the given step, being serialized and compressed on a worker thread.
+	Every client that joins or resyncs during that step receives the same chunks.
+
+	Once compressed, the chunks are queued to each recipient only as fast as its send queue has room for them.
+*/
+
+struct initial_arena_state_job_result {
+	compressed_initial_arena_state compressed;
+
+	/* Handed back so that the next job can serialize into it without reallocating. */
+	std::vector<std::byte> serialization_buffer;
+};
+
+struct initial_arena_state_recipient {
+	client_id_type client_id = 0;
+	uint32_t next_chunk = 0;
+};
+
+struct initial_arena_state_transfer {
+	server_step_type step = 0;
+	std::future<initial_arena_state_job_result> job;
+	std::optional<compressed_initial_arena_state> compressed;
+	std::vector<initial_arena_state_recipient> recipients;
+};
 
 struct resolve_address_result;
 
@@ -69,7 +99,7 @@ class server_setup :
 
 	/* This is loaded from the arena folder */
 	intercosm scene;
-	cosmos_solvable_significant initial_signi;
+	cosmos initial_cosm;
 
 	predefined_rulesets rulesets;
 
@@ -87,9 +117,10 @@ class server_setup :
 	augs::server_listen_input last_start;
 	std::optional<augs::dedicated_server_input> dedicated;
 
-	server_step_type current_simulation_step = 0;
+	/* Set if other instances in this process host arenas too - they then load each arena only once. */
+	shared_arena_cache* const shared_arenas;
 
-	augs::serialization_buffers buffers;
+	server_step_type current_simulation_step = 0;
 
 	entropy_accumulator local_collected;
 	compact_server_step_entropy step_collected;
@@ -99,8 +130,15 @@ class server_setup :
 	std::array<server_client_state, max_incoming_connections_v> clients;
 	server_client_state integrated_client;
 
+	/* Set only if we re-serve another server's match instead of hosting our own. */
+	augs::propagate_const<std::unique_ptr<server_relay>> relay;
+	bool relay_ready = false;
+
 	unsigned ticks_until_sending_packets = 0;
 	unsigned ticks_until_sending_hash = 0;
+
+	/* Per-part hashes of the last hashed steps, to answer the clients that report a desync. */
+	std::array<std::optional<state_hash_breakdown>, 128> recent_hash_breakdowns;
 	net_time_t when_last_sent_net_statistics = 0;
 	net_time_t when_last_sent_admin_public_settings = 0;
 	net_time_t when_last_sent_heartbeat_to_server_list = 0;
@@ -110,6 +148,7 @@ class server_setup :
 	std::vector<std::byte> heartbeat_buffer;
 	std::future<resolve_address_result> future_resolved_server_list_addr;
 	std::optional<netcode_address_t> resolved_server_list_addr;
+	bool server_list_resolved_elsewhere = false;
 
 	std::future<std::optional<netcode_address_t>> future_internal_address;
 	std::optional<netcode_address_t> internal_address;
@@ -125,6 +164,9 @@ class server_setup :
 
 	server_nat_traversal nat_traversal;
 
+	std::vector<initial_arena_state_transfer> initial_state_transfers;
+	std::vector<std::byte> spare_serialization_buffer;
+
 public:
 	net_time_t last_logged_at = 0;
 	server_profiler profiler;
@@ -140,7 +182,7 @@ private:
 			self.scene,
 			self.scene.world,
 			self.rulesets,
-			self.initial_signi
+			self.initial_cosm
 		};
 	}
 
@@ -182,6 +224,22 @@ private:
 	mode_player_id get_admin_player_id() const;
 
 	void reinfer_if_necessary_for(const compact_server_step_entropy& entropy);
+
+	void send_initial_arena_state(const client_id_type&);
+	bool stream_initial_arena_state(const initial_arena_state_transfer&, initial_arena_state_recipient&);
+	void finish_initial_state_jobs();
+	void advance_initial_state_transfers();
+
+	void advance_relay_upstream();
+	std::optional<networked_server_step_entropy> release_relayed_events();
+	void verify_relayed_step(const server_step_entropy_meta&);
+
+	uint32_t calculate_and_remember_state_hash();
+	const state_hash_breakdown* find_recent_hash_breakdown(uint32_t step) const;
+	void send_relayed_metas(const client_id_type&);
+
+	template <class T>
+	void handle_relayed_event(T&);
 	bool server_list_enabled() const;
 	bool has_sent_any_heartbeats() const;
 	void shutdown();
@@ -205,8 +263,10 @@ public:
 		const client_vars& integrated_client_vars,
 		const private_server_vars&,
 		std::optional<augs::dedicated_server_input>,
+		std::optional<server_relay_settings>,
 
-		const server_nat_traversal_input& nat_traversal_input
+		const server_nat_traversal_input& nat_traversal_input,
+		shared_arena_cache* shared_arenas = nullptr
 	);
 
 	~server_setup();
@@ -248,6 +308,82 @@ public:
 	double get_audiovisual_speed() const;
 	double get_inv_tickrate() const;
 
+	template <class C>
+	void advance_as_relay(
+		const server_advance_input& in,
+		const C& callbacks
+	) {
+		const auto current_time = get_current_time();
+
+		while (server_time <= current_time) {
+			auto scope = measure_scope(profiler.step);
+
+			step_collected.clear();
+
+			{
+				auto scope = measure_scope(profiler.advance_adapter);
+				handle_client_messages();
+				advance_relay_upstream();
+			}
+
+			{
+				auto scope = measure_scope(profiler.advance_clients_state);
+				advance_clients_state();
+			}
+
+			/*
+				Our own clients never contribute to the step.
+				Every released upstream step is re-sent and simulated right away,
+				so the relayed world keeps the pace of the upstream server and not our own clock.
+			*/
+
+			while (const auto relayed = release_relayed_events()) {
+				step_collected = relayed->payload;
+
+				{
+					auto scope = measure_scope(profiler.send_entropies);
+
+					verify_relayed_step(relayed->meta);
+					send_server_step_entropies(step_collected);
+				}
+
+				reinfer_if_necessary_for(step_collected);
+
+				{
+					auto scope = measure_scope(profiler.solve_simulation);
+
+					const auto unpacked = unpack(step_collected);
+
+					get_arena_handle().advance(
+						unpacked, 
+						callbacks, 
+						solve_settings()
+					);
+				}
+
+				++current_simulation_step;
+			}
+
+			advance_initial_state_transfers();
+
+			{
+				auto scope = measure_scope(profiler.send_packets);
+				send_packets_if_its_time();
+
+				resolve_internal_address_if_its_time();
+				resolve_heartbeat_host_if_its_time();
+				send_heartbeat_to_server_list_if_its_time();
+			}
+
+			server_time += get_inv_tickrate();
+
+			update_stats(in.server_stats);
+			step_collected.clear();
+		}
+
+		log_performance();
+	}
+
 	template <class C>
 	void advance(
 		const server_advance_input& in,
@@ -272,6 +408,11 @@ public:
 			nat_traversal.last_detected_nat = nat_detection_result();
 		}
 
+		if (is_relay()) {
+			advance_as_relay(in, callbacks);
+			return;
+		}
+
 		const auto current_time = get_current_time();
 
 		while (server_time <= current_time) {
@@ -317,6 +458,8 @@ public:
 				send_server_step_entropies(step_collected);
 			}
 
+			advance_initial_state_transfers();
+
 			{
 				auto scope = measure_scope(profiler.send_packets);
 				send_packets_if_its_time();
@@ -437,6 +580,15 @@ public:
 	bool should_have_admin_character() const;
 
 	void sleep_until_next_tick();
+	double get_sleep_secs_until_next_tick() const;
+
+	/*
+		For when several instances in a process resolve the server list address only once, for all of them.
+		Every instance still sends its heartbeats through its own socket,
+		as the server list tells the servers apart by the address they send from.
+	*/
+
+	void use_server_list_address(std::optional<netcode_address_t>);
 
 	void update_stats(server_network_info&) const;
 
@@ -483,6 +635,7 @@ public:
 
 	bool is_integrated() const;
 	bool is_dedicated() const;
+	bool is_relay() const;
 
 	void handle_new_session(const add_player_input& in);
 	void log_performance();
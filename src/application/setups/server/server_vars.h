@@ -5,6 +5,7 @@
 #include "augs/network/network_types.h"
 #include "augs/misc/constant_size_vector.h"
 #include "application/network/address_and_port.h"
+#include "game/cosmos/entity_pool_headroom.h"
 
 using arena_pool_type = augs::constant_size_vector<arena_identifier, max_arenas_in_pool_v, true>;
 
@@ -23,6 +24,8 @@ struct server_solvable_vars {
 
 	arena_identifier current_arena = "";
 	augs::constant_size_string<max_ruleset_name_length_v> override_default_ruleset = "";
+
+	entity_pool_headroom pool_headroom;
 	// END GEN INTROSPECTOR
 };
 
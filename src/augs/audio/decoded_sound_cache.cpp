@@ -0,0 +1,241 @@
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <functional>
+
+#include "augs/filesystem/file.h"
+#include "augs/filesystem/directory.h"
+#include "augs/audio/decoded_sound_cache.h"
+
+namespace augs {
+	namespace {
+		struct decoded_sound_header {
+			static constexpr uint32_t current_magic = 0x314d4350; /* "PCM1" */
+
+			uint32_t magic = current_magic;
+			uint32_t bytes_per_sample = sizeof(sound_sample_type);
+			int64_t source_write_time = 0;
+			uint64_t source_size = 0;
+			int32_t frequency = 0;
+			int32_t channels = 0;
+			uint64_t num_samples = 0;
+
+			bool matches_source_of(const decoded_sound_header& b) const {
+				return 
+					magic == b.magic
+					&& bytes_per_sample == b.bytes_per_sample
+					&& source_write_time == b.source_write_time
+					&& source_size == b.source_size
+				;
+			}
+		};
+
+		auto make_source_stamp(const path_type& source_path) {
+			decoded_sound_header stamp;
+			stamp.source_write_time = static_cast<int64_t>(augs::last_write_time(source_path).time_since_epoch().count());
+			stamp.source_size = static_cast<uint64_t>(std::filesystem::file_size(source_path));
+
+			return stamp;
+		}
+	}
+
+	path_type get_decoded_sound_cache_path(const path_type& cache_root, const path_type& source_path) {
+		/*
+			Normalized first, so that no ".." walks out of the cache root.
+			A relative source that still starts with ".." lies outside of the working directory,
+			so its cache is named after the hash of the whole path instead.
+		*/
+
+		const auto normalized = source_path.lexically_normal().relative_path();
+
+		if (normalized.empty() || *normalized.begin() == "..") {
+			const auto path_hash = std::hash<std::string>()(normalized.generic_string());
+			const auto name = std::to_string(path_hash) + "_" + source_path.filename().string() + ".pcm";
+
+			return cache_root / "outside" / name;
+		}
+
+		return cache_root / (normalized.string() + ".pcm");
+	}
+
+	std::optional<sound_data> load_decoded_sound(const path_type& cache_path, const path_type& source_path) {
+		const auto expected = make_source_stamp(source_path);
+
+		auto in = std::ifstream(cache_path, std::ios::in | std::ios::binary);
+
+		if (!in) {
+			return std::nullopt;
+		}
+
+		decoded_sound_header header;
+
+		if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || !header.matches_source_of(expected)) {
+			return std::nullopt;
+		}
+
+		sound_data result;
+		result.frequency = header.frequency;
+		result.channels = header.channels;
+		result.samples.resize(static_cast<std::size_t>(header.num_samples));
+
+		/* The samples are read in one go, straight into their final buffer. */
+
+		const auto num_bytes = static_cast<std::streamsize>(result.samples.size() * sizeof(sound_sample_type));
+
+		if (!in.read(reinterpret_cast<char*>(result.samples.data()), num_bytes)) {
+			return std::nullopt;
+		}
+
+		return result;
+	}
+
+	void save_decoded_sound(const path_type& cache_path, const path_type& source_path, const sound_data& data) {
+		auto header = make_source_stamp(source_path);
+		header.frequency = data.frequency;
+		header.channels = data.channels;
+		header.num_samples = data.samples.size();
+
+		augs::create_directories_for(cache_path);
+
+		/* 
+			Write to a temporary file first so that a concurrent reader 
+			never sees a partially written cache.
+		*/
+
+		auto temporary_path = cache_path;
+		temporary_path += ".tmp";
+
+		{
+			auto out = augs::open_binary_output_stream(temporary_path);
+
+			out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			out.write(reinterpret_cast<const char*>(data.samples.data()), static_cast<std::streamsize>(data.samples.size() * sizeof(sound_sample_type)));
+		}
+
+		std::filesystem::rename(temporary_path, cache_path);
+	}
+
+	sound_data decode_sound_cached(const path_type& source_path, const path_type& cache_root) {
+		const auto cache_path = get_decoded_sound_cache_path(cache_root, source_path);
+
+		try {
+			if (auto cached = load_decoded_sound(cache_path, source_path)) {
+				return std::move(*cached);
+			}
+		}
+		catch (const filesystem_error&) {
+			/* The source is missing - let the decoder report it. */
+		}
+
+		auto decoded = sound_data(source_path);
+
+		try {
+			save_decoded_sound(cache_path, source_path, decoded);
+		}
+		catch (...) {
+			/* Failing to cache is not an error - the sound will just be decoded again next time. */
+		}
+
+		return decoded;
+	}
+}
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+
+TEST_CASE("DecodedSoundCache PathsStayInsideTheRoot") {
+	const auto cache_root = augs::path_type("cache") / "sounds";
+
+	auto is_inside_root = [&](const augs::path_type& source) {
+		const auto relative = augs::get_decoded_sound_cache_path(cache_root, source).lexically_normal().lexically_relative(cache_root);
+		return !relative.empty() && *relative.begin() != "..";
+	};
+
+	REQUIRE(augs::get_decoded_sound_cache_path(cache_root, "content/a/../b/c.ogg") == cache_root / "content/b/c.ogg.pcm");
+	REQUIRE(augs::get_decoded_sound_cache_path(cache_root, "/content/c.ogg") == cache_root / "content/c.ogg.pcm");
+
+	REQUIRE(is_inside_root("content/../../../etc/c.ogg"));
+	REQUIRE(is_inside_root("../c.ogg"));
+	REQUIRE(is_inside_root("/../../c.ogg"));
+	REQUIRE(is_inside_root("content/c.ogg"));
+
+	/* Sources outside of the working directory must not share a cache file. */
+
+	REQUIRE(augs::get_decoded_sound_cache_path(cache_root, "../a/c.ogg") != augs::get_decoded_sound_cache_path(cache_root, "../b/c.ogg"));
+	REQUIRE(augs::get_decoded_sound_cache_path(cache_root, "../a/c.ogg") == augs::get_decoded_sound_cache_path(cache_root, "../a/./c.ogg"));
+}
+
+#if BUILD_SOUND_FORMAT_DECODERS
+
+namespace {
+	void write_test_wav(const augs::path_type& path, const std::vector<int16_t>& samples) {
+		auto out = augs::open_binary_output_stream(path);
+
+		auto u32 = [&](const uint32_t v) { out.write(reinterpret_cast<const char*>(&v), 4); };
+		auto u16 = [&](const uint16_t v) { out.write(reinterpret_cast<const char*>(&v), 2); };
+
+		const auto data_bytes = static_cast<uint32_t>(samples.size() * 2);
+
+		out.write("RIFF", 4);
+		u32(36 + data_bytes);
+		out.write("WAVE", 4);
+		out.write("fmt ", 4);
+		u32(16);
+		u16(1);
+		u16(2);
+		u32(22050);
+		u32(22050 * 4);
+		u16(4);
+		u16(16);
+		out.write("data", 4);
+		u32(data_bytes);
+		out.write(reinterpret_cast<const char*>(samples.data()), data_bytes);
+	}
+}
+
+TEST_CASE("DecodedSoundCache RoundTripAndInvalidation") {
+	const auto cache_root = augs::path_type(GENERATED_FILES_DIR) / "test_decoded_sounds";
+	const auto source = augs::path_type(GENERATED_FILES_DIR) / "test_decoded_sound.wav";
+	const auto cache_path = augs::get_decoded_sound_cache_path(cache_root, source);
+
+	augs::remove_file(cache_path);
+
+	std::vector<int16_t> samples;
+
+	for (int i = 0; i < 1000; ++i) {
+		samples.push_back(static_cast<int16_t>(i * 31 - 15000));
+	}
+
+	write_test_wav(source, samples);
+
+	REQUIRE(augs::load_decoded_sound(cache_path, source) == std::nullopt);
+
+	const auto decoded = augs::decode_sound_cached(source, cache_root);
+	REQUIRE(decoded.samples == samples);
+	REQUIRE(decoded.channels == 2);
+	REQUIRE(decoded.frequency == 22050);
+
+	{
+		const auto cached = augs::load_decoded_sound(cache_path, source);
+
+		REQUIRE(cached.has_value());
+		REQUIRE(cached->samples == samples);
+		REQUIRE(cached->channels == 2);
+		REQUIRE(cached->frequency == 22050);
+	}
+
+	/* A source of a different size must invalidate the cache. */
+
+	samples.resize(500);
+	write_test_wav(source, samples);
+
+	REQUIRE(augs::load_decoded_sound(cache_path, source) == std::nullopt);
+	REQUIRE(augs::decode_sound_cached(source, cache_root).samples == samples);
+	REQUIRE(augs::load_decoded_sound(cache_path, source).has_value());
+
+	augs::remove_file(cache_path);
+	augs::remove_file(source);
+}
+#endif
+#endif
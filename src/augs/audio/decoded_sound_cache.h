@@ -0,0 +1,29 @@
+#pragma once
+#include <optional>
+#include "augs/filesystem/path.h"
+#include "augs/audio/sound_data.h"
+
+namespace augs {
+	/*
+		Decoded samples of sound files, kept on disk so that a sound is decoded only once.
+
+		Each cached file starts with a header holding the write time and size of its source,
+		followed by the samples exactly as they would be passed to the audio backend.
+		A cached file whose header does not match its source is ignored and rewritten.
+	*/
+
+	path_type get_decoded_sound_cache_path(const path_type& cache_root, const path_type& source_path);
+
+	/* Returns std::nullopt if there is no cached file or it is outdated. Throws if the source does not exist. */
+	std::optional<sound_data> load_decoded_sound(const path_type& cache_path, const path_type& source_path);
+
+	void save_decoded_sound(const path_type& cache_path, const path_type& source_path, const sound_data&);
+
+	/*
+		Loads the sound from the cache under cache_root if it is still valid,
+		otherwise decodes the source and refreshes the cache.
+		Throws just like the sound_data constructor.
+	*/
+
+	sound_data decode_sound_cached(const path_type& source_path, const path_type& cache_root);
+}
@@ -11,6 +11,7 @@
 #include "augs/filesystem/file.h"
 
 #include "augs/audio/sound_data.h"
+#include "augs/audio/decoded_sound_cache.h"
 #include "augs/audio/sound_buffer.h"
 
 #include "augs/string/string_templates.h"
@@ -128,13 +129,19 @@ namespace augs {
 		return meta.computed_length_in_seconds;
 	}
 
-	sound_buffer::sound_buffer(const sound_buffer_loading_input input) {
-		from_file(input);
-	}
+	std::vector<sound_data> decode_sound_variations(const sound_buffer_loading_input& input, const path_type& cache_root) {
+		std::vector<sound_data> result;
+
+		auto decode = [&](const augs::path_type& path) {
+			if (cache_root.empty()) {
+				return sound_data(path);
+			}
+
+			return decode_sound_cached(path, cache_root);
+		};
 
-	void sound_buffer::from_file(const sound_buffer_loading_input input) {
 		const auto& path = input.source_sound;
-		variations.emplace_back(path, input.settings);
+		result.emplace_back(decode(path));
 
 		const auto ext = augs::path_type(path).extension();
 		const auto without_ext = augs::path_type(path).replace_extension("").string();
@@ -145,14 +152,38 @@ namespace augs {
 			for (size_t i = 2;; ++i) {
 				const auto next_path = augs::path_type(typesafe_sprintf("%x_%x%x", without_num, i, ext));
 
+				if (!augs::exists(next_path)) {
+					break;
+				}
+
 				try {
-					variations.emplace_back(next_path, input.settings);
+					result.emplace_back(decode(next_path));
 				}
 				catch (...) {
 					break;
 				}
 			}
 		}
+
+		return result;
+	}
+
+	sound_buffer::sound_buffer(const sound_buffer_loading_input input) {
+		from_file(input);
+	}
+
+	sound_buffer::sound_buffer(const std::vector<sound_data>& decoded_variations, const sound_buffer_loading_settings settings) {
+		variations.reserve(decoded_variations.size());
+
+		for (const auto& d : decoded_variations) {
+			variations.emplace_back(d, settings);
+		}
+	}
+
+	void sound_buffer::from_file(const sound_buffer_loading_input input) {
+		for (const auto& d : decode_sound_variations(input)) {
+			variations.emplace_back(d, input.settings);
+		}
 	}
 
 	const single_sound_buffer& sound_buffer::get_buffer(const std::size_t variation_index) const {
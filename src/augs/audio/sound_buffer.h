@@ -42,12 +42,21 @@ namespace augs {
 		}
 	};
 
+	/*
+		Decodes the sound along with all of its numbered variations (name_1, name_2, ...).
+		If cache_root is not empty, decoded samples are read from and saved to a cache under it.
+		Touches nothing but the filesystem, so it is safe to call from any thread.
+	*/
+
+	std::vector<sound_data> decode_sound_variations(const sound_buffer_loading_input&, const path_type& cache_root = {});
+
 	class sound_buffer {
 		void from_file(const sound_buffer_loading_input);
 
 		std::vector<single_sound_buffer> variations;
 	public:
 		sound_buffer(const sound_buffer_loading_input);
+		sound_buffer(const std::vector<sound_data>& decoded_variations, sound_buffer_loading_settings);
 
 		const single_sound_buffer& get_buffer(std::size_t variation_index) const;
 
@@ -4,6 +4,7 @@
 #endif
 
 #include <cstring>
+#include <algorithm>
 
 #if BUILD_SOUND_FORMAT_DECODERS
 #include <ogg/ogg.h>
@@ -36,13 +37,11 @@ namespace augs {
 		const auto path_str = path.string();
 
 		if (extension == ".ogg") {
-			std::vector<char> buffer;
 			// TODO: throw if the file fails to load as OGG
 			// TODO: detect endianess
 			int endian = 0;             // 0 for Little-Endian, 1 for Big-Endian
 			int bitStream = 0xdeadbeef;
 			long bytes = 0xdeadbeef;
-			char array[OGG_BUFFER_SIZE]; 
 
 			OggVorbis_File oggFile;
 
@@ -58,13 +57,44 @@ namespace augs {
 			channels = pInfo->channels;
 			frequency = pInfo->rate;
 
+			/* 
+				Decode straight into the samples. 
+				The total length is usually known up front, so there is typically a single allocation.
+			*/
+
+			if (const auto total_frames = ov_pcm_total(&oggFile, -1); total_frames > 0) {
+				samples.resize(static_cast<std::size_t>(total_frames) * channels);
+			}
+
+			std::size_t written_bytes = 0;
+			char overflow[OGG_BUFFER_SIZE];
+
 			do {
-				bytes = ov_read(&oggFile, array, OGG_BUFFER_SIZE, endian, 2, 1, &bitStream);
-				buffer.insert(buffer.end(), array, array + bytes);
+				const auto free_bytes = samples.size() * sizeof(sound_sample_type) - written_bytes;
+
+				if (free_bytes > 0) {
+					auto* const target = reinterpret_cast<char*>(samples.data()) + written_bytes;
+					const auto max_bytes = static_cast<int>(std::min(free_bytes, std::size_t(OGG_BUFFER_SIZE)));
+
+					bytes = ov_read(&oggFile, target, max_bytes, endian, 2, 1, &bitStream);
+
+					if (bytes > 0) {
+						written_bytes += bytes;
+					}
+				}
+				else {
+					/* The length was unknown or the stream turned out longer than reported. */
+					bytes = ov_read(&oggFile, overflow, OGG_BUFFER_SIZE, endian, 2, 1, &bitStream);
+
+					if (bytes > 0) {
+						samples.resize((written_bytes + bytes) / sizeof(sound_sample_type));
+						std::memcpy(reinterpret_cast<char*>(samples.data()) + written_bytes, overflow, bytes);
+						written_bytes += bytes;
+					}
+				}
 			} while (bytes > 0);
 
-			samples.resize(buffer.size() / sizeof(sound_sample_type));
-			std::memcpy(samples.data(), buffer.data(), buffer.size());
+			samples.resize(written_bytes / sizeof(sound_sample_type));
 		}
 		else if (extension == ".wav") {
 			auto wav_file = fclosed_unique(fopen(path_str.c_str(), "rb"));
@@ -15,6 +15,7 @@ namespace augs {
 		int frequency = 0;
 		int channels = 0;
 
+		sound_data() = default;
 		sound_data(const path_type& path);
 
 		double compute_length_in_seconds() const;
@@ -0,0 +1,7 @@
+#pragma once
+
+/* Set by CMake for benchmark builds, see the COUNT_ALLOCATIONS option. */
+
+#ifndef COUNT_ALLOCATIONS
+#define COUNT_ALLOCATIONS 0
+#endif
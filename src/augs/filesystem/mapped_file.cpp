@@ -0,0 +1,154 @@
+#include <utility>
+
+#include "augs/filesystem/file.h"
+#include "augs/filesystem/mapped_file.h"
+
+#if PLATFORM_WINDOWS
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace augs {
+	static auto mapping_error(const path_type& path) {
+		return file_open_error("Failed to map " + path.string());
+	}
+
+#if PLATFORM_WINDOWS
+	mapped_file::mapped_file(const path_type& path) {
+		const auto file = CreateFileW(
+			path.wstring().c_str(),
+			GENERIC_READ,
+			FILE_SHARE_READ,
+			nullptr,
+			OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+			nullptr
+		);
+
+		if (file == INVALID_HANDLE_VALUE) {
+			throw mapping_error(path);
+		}
+
+		file_handle = file;
+
+		LARGE_INTEGER file_size;
+
+		if (!GetFileSizeEx(file, &file_size)) {
+			unmap();
+			throw mapping_error(path);
+		}
+
+		mapped_size = static_cast<std::size_t>(file_size.QuadPart);
+
+		if (mapped_size == 0) {
+			/* Mapping an empty file is an error on Windows. An empty view is enough. */
+			return;
+		}
+
+		mapping_handle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+		if (mapping_handle == nullptr) {
+			unmap();
+			throw mapping_error(path);
+		}
+
+		mapping = static_cast<const std::byte*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+
+		if (mapping == nullptr) {
+			unmap();
+			throw mapping_error(path);
+		}
+	}
+
+	void mapped_file::unmap() {
+		if (mapping != nullptr) {
+			UnmapViewOfFile(mapping);
+		}
+
+		if (mapping_handle != nullptr) {
+			CloseHandle(mapping_handle);
+		}
+
+		if (file_handle != nullptr) {
+			CloseHandle(file_handle);
+		}
+
+		mapping = nullptr;
+		mapping_handle = nullptr;
+		file_handle = nullptr;
+		mapped_size = 0;
+	}
+#else
+	mapped_file::mapped_file(const path_type& path) {
+		const auto fd = ::open(path.string().c_str(), O_RDONLY);
+
+		if (fd == -1) {
+			throw mapping_error(path);
+		}
+
+		struct stat file_stat;
+
+		if (::fstat(fd, &file_stat) == -1) {
+			::close(fd);
+			throw mapping_error(path);
+		}
+
+		mapped_size = static_cast<std::size_t>(file_stat.st_size);
+
+		if (mapped_size > 0) {
+			void* const result = ::mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+			if (result == MAP_FAILED) {
+				::close(fd);
+				mapped_size = 0;
+				throw mapping_error(path);
+			}
+
+			/* The whole file is about to be read front to back. */
+			::madvise(result, mapped_size, MADV_SEQUENTIAL);
+
+			mapping = static_cast<const std::byte*>(result);
+		}
+
+		/* The mapping stays valid after the descriptor is closed. */
+		::close(fd);
+	}
+
+	void mapped_file::unmap() {
+		if (mapping != nullptr) {
+			::munmap(const_cast<std::byte*>(mapping), mapped_size);
+		}
+
+		mapping = nullptr;
+		mapped_size = 0;
+	}
+#endif
+
+	mapped_file::~mapped_file() {
+		unmap();
+	}
+
+	mapped_file::mapped_file(mapped_file&& b) noexcept {
+		*this = std::move(b);
+	}
+
+	mapped_file& mapped_file::operator=(mapped_file&& b) noexcept {
+		if (this != &b) {
+			unmap();
+
+			std::swap(mapping, b.mapping);
+			std::swap(mapped_size, b.mapped_size);
+
+#if PLATFORM_WINDOWS
+			std::swap(file_handle, b.file_handle);
+			std::swap(mapping_handle, b.mapping_handle);
+#endif
+		}
+
+		return *this;
+	}
+}
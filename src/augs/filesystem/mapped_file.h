@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include "augs/filesystem/path.h"
+#include "augs/readwrite/pointer_to_buffer.h"
+
+namespace augs {
+	/*
+		A read-only view of the whole file, mapped into memory.
+		Pages are only read from the disk when they are first touched,
+		and are shared with every other process that maps the same file.
+
+		Throws augs::file_open_error if the file can't be opened or mapped.
+	*/
+
+	class mapped_file {
+		const std::byte* mapping = nullptr;
+		std::size_t mapped_size = 0;
+
+#if PLATFORM_WINDOWS
+		void* file_handle = nullptr;
+		void* mapping_handle = nullptr;
+#endif
+
+		void unmap();
+
+	public:
+		explicit mapped_file(const path_type& path);
+		~mapped_file();
+
+		mapped_file(const mapped_file&) = delete;
+		mapped_file& operator=(const mapped_file&) = delete;
+
+		mapped_file(mapped_file&&) noexcept;
+		mapped_file& operator=(mapped_file&&) noexcept;
+
+		const std::byte* data() const {
+			return mapping;
+		}
+
+		std::size_t size() const {
+			return mapped_size;
+		}
+
+		/* For use with augs::cptr_memory_stream. */
+		cpointer_to_buffer subspan(const std::size_t offset, const std::size_t count) const {
+			return { mapping + offset, count };
+		}
+
+		cpointer_to_buffer whole() const {
+			return subspan(0, mapped_size);
+		}
+	};
+}
@@ -0,0 +1,215 @@
+#include "augs/ensure.h"
+#include "augs/filesystem/file.h"
+#include "augs/graphics/null_renderer_backend.h"
+#include "augs/graphics/vertex.h"
+#include "augs/graphics/dedicated_buffers.h"
+#include "3rdparty/imgui/imgui.h"
+#include "augs/graphics/renderer_command.h"
+#include "augs/templates/remove_cref.h"
+
+namespace augs {
+	namespace graphics {
+		null_renderer_backend::null_renderer_backend(const augs::path_type& dump_path) {
+			if (!dump_path.empty()) {
+				dump.emplace(augs::open_binary_output_stream(dump_path));
+
+				*dump << "frame,commands,draw_calls,triangles,lines,imgui_draw_calls,state_changes,uploaded_vertex_bytes,uploaded_texture_bytes\n";
+			}
+		}
+
+		void null_renderer_backend::perform(const drawcall_command& cmd) {
+			const auto cnt = static_cast<std::size_t>(cmd.count);
+
+			if (cmd.specials) {
+				current.uploaded_vertex_bytes += sizeof(special) * cnt * 3;
+			}
+
+			if (cmd.triangles) {
+				++current.draw_calls;
+				current.triangles += cnt;
+				current.uploaded_vertex_bytes += sizeof(vertex_triangle) * cnt;
+			}
+
+			if (cmd.lines) {
+				++current.draw_calls;
+				current.lines += cnt;
+				current.uploaded_vertex_bytes += sizeof(vertex_line) * cnt;
+			}
+		}
+
+		void null_renderer_backend::perform(
+			renderer_backend::result_info& output,
+			const renderer_command* const c,
+			const std::size_t n,
+			const dedicated_buffers& dedicated
+		) {
+			auto& lists_to_delete = output.imgui_lists_to_delete;
+
+			ImDrawList* cmd_list = nullptr;
+			std::size_t cmd_i = 0;
+
+			current.commands += n;
+
+			for (std::size_t i = 0; i < n; ++i) {
+				const auto& cmd = c[i];
+
+				auto command_handler = [&](const auto& typed_cmd) {
+					using C = remove_cref<decltype(typed_cmd)>;
+
+					auto perform_drawcall_for = [&](const auto& buffers) {
+						if (const auto lines_n = buffers.lines.size(); lines_n > 0) {
+							drawcall_command translated_cmd;
+
+							translated_cmd.lines = buffers.lines.data();
+							translated_cmd.count = lines_n;
+
+							perform(translated_cmd);
+						}
+
+						if (const auto triangles_n = buffers.triangles.size(); triangles_n > 0) {
+							drawcall_command translated_cmd;
+
+							translated_cmd.triangles = buffers.triangles.data();
+							translated_cmd.count = triangles_n;
+
+							if (buffers.specials.size() > 0) {
+								translated_cmd.specials = buffers.specials.data();
+							}
+
+							perform(translated_cmd);
+						}
+					};
+
+					if constexpr(std::is_same_v<C, object_command<texture, texImage2D_command>>) {
+						const auto size = typed_cmd.payload.size;
+						current.uploaded_texture_bytes += static_cast<std::size_t>(size.x) * size.y * 4;
+					}
+					else if constexpr(std::is_same_v<C, drawcall_command>) {
+						perform(typed_cmd);
+					}
+					else if constexpr(std::is_same_v<C, drawcall_dedicated_command>) {
+						perform_drawcall_for(dedicated[typed_cmd.type]);
+					}
+					else if constexpr(std::is_same_v<C, drawcall_dedicated_vector_command>) {
+						perform_drawcall_for(dedicated[typed_cmd.type][typed_cmd.index]);
+					}
+					else if constexpr(std::is_same_v<C, setup_imgui_list>) {
+						cmd_list = typed_cmd.cmd_list;
+
+						current.uploaded_vertex_bytes +=
+							static_cast<std::size_t>(cmd_list->VtxBuffer.Size) * sizeof(ImDrawVert)
+							+ static_cast<std::size_t>(cmd_list->IdxBuffer.Size) * sizeof(ImDrawIdx)
+						;
+
+						/* The lists are still owned by us, exactly as with the OpenGL backend. */
+						lists_to_delete.emplace_back(cmd_list);
+						cmd_i = 0;
+					}
+					else if constexpr(std::is_same_v<C, no_arg_command>) {
+						using N = no_arg_command;
+
+						if (typed_cmd == N::IMGUI_CMD) {
+							ensure(cmd_list != nullptr);
+							const auto& cc = cmd_list->CmdBuffer[cmd_i++];
+
+							++current.draw_calls;
+							++current.imgui_draw_calls;
+							current.triangles += cc.ElemCount / 3;
+						}
+						else if (typed_cmd == N::FULLSCREEN_QUAD) {
+							++current.draw_calls;
+							current.triangles += 2;
+							current.uploaded_vertex_bytes += sizeof(float) * 12;
+						}
+						else {
+							++current.state_changes;
+						}
+					}
+					else {
+						/* Binds, uniforms, toggles, viewports and the like. */
+						++current.state_changes;
+					}
+				};
+
+				std::visit(command_handler, cmd.payload);
+			}
+		}
+
+		void null_renderer_backend::finish_frame() {
+			if (dump) {
+				*dump
+					<< num_frames << ','
+					<< current.commands << ','
+					<< current.draw_calls << ','
+					<< current.triangles << ','
+					<< current.lines << ','
+					<< current.imgui_draw_calls << ','
+					<< current.state_changes << ','
+					<< current.uploaded_vertex_bytes << ','
+					<< current.uploaded_texture_bytes << '\n'
+				;
+			}
+
+			last = current;
+			current.clear();
+
+			++num_frames;
+		}
+	}
+}
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+
+TEST_CASE("NullRendererBackend CountsCommands") {
+	using namespace augs;
+	using namespace augs::graphics;
+
+	std::vector<vertex_triangle> triangles(10);
+	std::vector<vertex_line> lines(3);
+
+	dedicated_buffers dedicated;
+	dedicated[dedicated_buffer::NICKNAMES].triangles.resize(4);
+	dedicated[dedicated_buffer::NICKNAMES].lines.resize(2);
+
+	std::vector<renderer_command> commands;
+
+	{
+		drawcall_command cmd;
+		cmd.triangles = triangles.data();
+		cmd.count = static_cast<uint32_t>(triangles.size());
+		commands.push_back({ cmd });
+	}
+
+	{
+		drawcall_command cmd;
+		cmd.lines = lines.data();
+		cmd.count = static_cast<uint32_t>(lines.size());
+		commands.push_back({ cmd });
+	}
+
+	commands.push_back({ drawcall_dedicated_command { dedicated_buffer::NICKNAMES } });
+	commands.push_back({ toggle_command { toggle_command_type::BLENDING, true } });
+	commands.push_back({ no_arg_command::FULLSCREEN_QUAD });
+
+	null_renderer_backend backend;
+	renderer_backend::result_info result;
+
+	backend.perform(result, commands.data(), commands.size(), dedicated);
+	backend.finish_frame();
+
+	const auto& stats = backend.get_last_frame();
+
+	REQUIRE(backend.get_num_frames() == 1);
+	REQUIRE(stats.commands == 5);
+	REQUIRE(stats.draw_calls == 5);
+	REQUIRE(stats.triangles == 10 + 4 + 2);
+	REQUIRE(stats.lines == 3 + 2);
+	REQUIRE(stats.state_changes == 1);
+	REQUIRE(stats.uploaded_vertex_bytes == sizeof(vertex_triangle) * 14 + sizeof(vertex_line) * 5 + sizeof(float) * 12);
+	REQUIRE(result.imgui_lists_to_delete.empty());
+
+	backend.finish_frame();
+	REQUIRE(backend.get_last_frame().commands == 0);
+}
+#endif
@@ -0,0 +1,75 @@
+#pragma once
+#include <fstream>
+#include <optional>
+
+#include "augs/filesystem/path.h"
+#include "augs/graphics/renderer_backend.h"
+
+namespace augs {
+	namespace graphics {
+		struct renderer_frame_stats {
+			std::size_t commands = 0;
+			std::size_t draw_calls = 0;
+			std::size_t triangles = 0;
+			std::size_t lines = 0;
+			std::size_t imgui_draw_calls = 0;
+			std::size_t state_changes = 0;
+			std::size_t uploaded_vertex_bytes = 0;
+			std::size_t uploaded_texture_bytes = 0;
+
+			void clear() {
+				*this = {};
+			}
+		};
+
+		/*
+			Consumes the same command stream as renderer_backend,
+			but instead of issuing any OpenGL calls, it only counts what the GPU would be asked to do.
+
+			Used by the headless client to measure the client-side cost of a frame
+			in environments with no GPU.
+
+			Object commands (texture uploads, binds of textures, shaders and fbos, uniforms)
+			are never executed - only counted - so no GL objects are ever touched.
+			Optionally, the counts of every frame are appended as a CSV row to a dump file.
+		*/
+
+		class null_renderer_backend {
+			renderer_frame_stats current;
+			renderer_frame_stats last;
+			std::size_t num_frames = 0;
+
+			std::optional<std::ofstream> dump;
+
+			void perform(const drawcall_command&);
+
+		public:
+			static constexpr unsigned max_texture_size_v = 16384;
+
+			/* Throws augs::file_open_error if a dump path was given and can't be opened. */
+			explicit null_renderer_backend(const augs::path_type& dump_path = {});
+
+			unsigned get_max_texture_size() const {
+				return max_texture_size_v;
+			}
+
+			void perform(
+				renderer_backend::result_info& output,
+				const renderer_command*,
+				std::size_t n,
+				const dedicated_buffers&
+			);
+
+			/* Call once all renderers of a frame were performed. */
+			void finish_frame();
+
+			const auto& get_last_frame() const {
+				return last;
+			}
+
+			auto get_num_frames() const {
+				return num_frames;
+			}
+		};
+	}
+}
@@ -1,4 +1,3 @@
-#include <mutex>
 #include "augs/log.h"
 
 #include "augs/string/string_templates.h"
@@ -8,7 +7,6 @@
 
 int ImTextCharFromUtf8(unsigned int* out_char, const char* in_text, const char* in_text_end);
 
-extern std::mutex log_mutex;
 
 namespace augs {
 	namespace gui {
@@ -46,17 +44,9 @@ namespace augs {
 			) {
 				formatted_string result;
 
-				std::unique_lock<std::mutex> lock(log_mutex);
-
-				auto& entries = program_log::get_current().all_entries;
-
-				lines_remaining = std::min(lines_remaining, entries.size());
-
-				for (auto it = entries.end() - lines_remaining; it != entries.end(); ++it) {
-					const auto str = (*it).text + "\n";
-					concatenate(result, formatted_string{ str, { f, white /* rgba((*it).color) */ } });
-
-					--lines_remaining;
+				for (const auto& e : program_log::get_current().get_recent(lines_remaining)) {
+					const auto str = e.text + "\n";
+					concatenate(result, formatted_string{ str, { f, white /* rgba(e.color) */ } });
 				}
 
 				return result;
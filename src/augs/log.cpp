@@ -1,6 +1,11 @@
+#include <array>
 #include <string>
 #include <thread>
 #include <mutex>
+#include <atomic>
+#include <fstream>
+#include <algorithm>
+#include <condition_variable>
 
 #include "augs/log.h"
 #include "augs/math/vec2.h"
@@ -8,6 +13,7 @@
 
 #include "augs/filesystem/file.h"
 #include "augs/string/string_templates.h"
+#include "augs/templates/container_templates.h"
 #include "augs/log_path_getters.h"
 
 #define ENABLE_LOG 1
@@ -16,9 +22,7 @@
 #include <iostream>
 #endif
 
-std::mutex log_mutex;
-
-extern bool log_to_live_file;
+extern std::atomic<bool> log_to_live_file;
 app_type current_app_type;
 
 std::string get_path_in_log_files(const std::string& name) {
@@ -94,48 +98,322 @@ std::string get_dumped_log_path() {
 	return get_path_in_log_files("dumped_debug_log.txt");
 }
 
+/*
+	Lines logged by a single thread and not yet drained by the writer.
+	Only the owning thread pushes, and only whoever holds the consumer lock pops,
+	so the ring itself needs no locks.
+*/
+
+struct thread_log_ring {
+	static constexpr std::size_t capacity = 1024;
+
+	struct queued_line {
+		uint64_t sequence = 0;
+		std::string text;
+	};
+
+	std::array<queued_line, capacity> lines;
+
+	std::atomic<std::size_t> head = 0;
+	std::atomic<std::size_t> tail = 0;
+};
+
+struct program_log::backend {
+	static inline std::atomic<uint64_t> next_id = 1;
+
+	const uint64_t id = next_id.fetch_add(1);
+	const std::size_t max_entries;
+
+	std::atomic<uint64_t> next_sequence = 0;
+
+	/* Only taken once per thread, to register its ring. */
+	std::mutex rings_mutex;
+	std::vector<std::shared_ptr<thread_log_ring>> rings;
+
+	/* Guards everything the writer touches. Producers never take it. */
+	mutable std::mutex consumer_mutex;
+	std::vector<std::shared_ptr<thread_log_ring>> drained_rings;
+	std::vector<thread_log_ring::queued_line> batch;
+
+	std::vector<log_entry> history;
+	std::size_t history_first = 0;
+
+	std::ofstream live_file;
+
+	std::mutex sleep_mutex;
+	std::condition_variable wake_writer;
+	std::atomic<bool> running = false;
+	std::once_flag writer_started;
+	std::thread writer;
+
+	backend(const std::size_t max_entries) : max_entries(max_entries) {
+		history.reserve(max_entries);
+	}
+
+	~backend() {
+		if (running.exchange(false)) {
+			wake_writer.notify_one();
+			writer.join();
+		}
+
+		auto lock = std::unique_lock<std::mutex>(consumer_mutex);
+		drain();
+	}
+
+	thread_log_ring& get_ring_of_this_thread() {
+		thread_local std::shared_ptr<thread_log_ring> ring;
+		thread_local uint64_t ring_owner = 0;
+
+		if (ring_owner != id) {
+			ring = std::make_shared<thread_log_ring>();
+			ring_owner = id;
+
+			auto lock = std::unique_lock<std::mutex>(rings_mutex);
+			rings.push_back(ring);
+		}
+
+		return *ring;
+	}
+
+	void start_writer() {
+		std::call_once(writer_started, [this]() {
+			running = true;
+
+			writer = std::thread([this]() {
+				while (running.load()) {
+					{
+						auto lock = std::unique_lock<std::mutex>(sleep_mutex);
+						wake_writer.wait_for(lock, std::chrono::milliseconds(10));
+					}
+
+					auto lock = std::unique_lock<std::mutex>(consumer_mutex);
+					drain();
+				}
+			});
+		});
+	}
+
+	void push(std::string&& text) {
+		start_writer();
+
+		auto& ring = get_ring_of_this_thread();
+		const auto tail = ring.tail.load(std::memory_order_relaxed);
+
+		while (tail - ring.head.load(std::memory_order_acquire) >= thread_log_ring::capacity) {
+			if (!running.load()) {
+				auto lock = std::unique_lock<std::mutex>(consumer_mutex);
+				drain();
+			}
+			else {
+				wake_writer.notify_one();
+				std::this_thread::yield();
+			}
+		}
+
+		auto& slot = ring.lines[tail % thread_log_ring::capacity];
+		slot.sequence = next_sequence.fetch_add(1, std::memory_order_relaxed);
+		slot.text = std::move(text);
+
+		ring.tail.store(tail + 1, std::memory_order_release);
+
+		/* Otherwise the writer just picks it up on its next round. */
+
+		if (tail + 1 - ring.head.load(std::memory_order_relaxed) >= thread_log_ring::capacity / 2) {
+			wake_writer.notify_one();
+		}
+	}
+
+	void push_to_history(std::string&& text) {
+		if (history.size() < max_entries) {
+			history.push_back({ std::move(text) });
+		}
+		else {
+			history[history_first].text = std::move(text);
+			history_first = (history_first + 1) % max_entries;
+		}
+	}
+
+	template <class F>
+	void for_each_in_history(F callback) const {
+		for (std::size_t i = 0; i < history.size(); ++i) {
+			callback(history[(history_first + i) % history.size()]);
+		}
+	}
+
+	/* Requires the consumer lock. */
+
+	void drain() {
+		{
+			auto lock = std::unique_lock<std::mutex>(rings_mutex);
+			drained_rings = rings;
+		}
+
+		batch.clear();
+
+		for (const auto& r : drained_rings) {
+			auto& ring = *r;
+
+			const auto head = ring.head.load(std::memory_order_relaxed);
+			const auto tail = ring.tail.load(std::memory_order_acquire);
+
+			for (auto i = head; i < tail; ++i) {
+				batch.push_back(std::move(ring.lines[i % thread_log_ring::capacity]));
+			}
+
+			ring.head.store(tail, std::memory_order_release);
+		}
+
+		drained_rings.clear();
+
+		{
+			/* Forget the rings of threads that have exited. */
+
+			auto lock = std::unique_lock<std::mutex>(rings_mutex);
+
+			erase_if(rings, [](const auto& r) {
+				return r.use_count() == 1 && r->head.load() == r->tail.load();
+			});
+		}
+
+		if (batch.empty()) {
+			return;
+		}
+
+		std::sort(batch.begin(), batch.end(), [](const auto& a, const auto& b) { return a.sequence < b.sequence; });
+
+		const bool to_live_file = log_to_live_file.load();
+
+		if (to_live_file && !live_file.is_open()) {
+			live_file.open(get_path_in_log_files("live_debug.txt"), std::ios::out | std::ios::app);
+		}
+
+		for (auto& l : batch) {
+#if BUILD_IN_CONSOLE_MODE
+			std::cout << l.text << '\n';
+#endif
+
+			if (to_live_file) {
+				live_file << l.text << '\n';
+			}
+
+			push_to_history(std::move(l.text));
+		}
+
+#if BUILD_IN_CONSOLE_MODE
+		std::cout << std::flush;
+#endif
+
+		if (to_live_file) {
+			live_file.flush();
+		}
+	}
+};
+
 program_log program_log::global_instance = 10000;
 
 program_log::program_log(const unsigned max_all_entries) 
-	: max_all_entries(max_all_entries) 
+	: impl(std::make_unique<backend>(max_all_entries)) 
 {
 }
 
-void program_log::push_entry(const log_entry& new_entry) {
-	all_entries.push_back(new_entry);
+program_log::~program_log() = default;
 
-	if (all_entries.size() > max_all_entries) {
-		all_entries.erase(all_entries.begin(), all_entries.begin() + max_all_entries/5);
-	}
+void program_log::push_entry(std::string&& new_entry) {
+	impl->push(std::move(new_entry));
+}
+
+void program_log::flush() {
+	auto lock = std::unique_lock<std::mutex>(impl->consumer_mutex);
+	impl->drain();
+}
+
+std::vector<log_entry> program_log::get_recent(const std::size_t max_entries) const {
+	auto lock = std::unique_lock<std::mutex>(impl->consumer_mutex);
+	impl->drain();
+
+	std::vector<log_entry> result;
+
+	const auto skipped = impl->history.size() - std::min(max_entries, impl->history.size());
+	std::size_t i = 0;
+
+	impl->for_each_in_history([&](const log_entry& e) {
+		if (i++ >= skipped) {
+			result.push_back(e);
+		}
+	});
+
+	return result;
 }
 
 std::string program_log::get_complete() const {
-	std::unique_lock<std::mutex> lock(log_mutex);
+	auto lock = std::unique_lock<std::mutex>(impl->consumer_mutex);
+	impl->drain();
 
 	auto logs = std::string();
 
-	for (const auto& e : all_entries) {
+	impl->for_each_in_history([&](const log_entry& e) {
 		logs += e.text + '\n';
-	}
+	});
 
 	return logs;
 }
 
 void LOG_DIRECT(const std::string& f) {
 #if ENABLE_LOG 
-	std::unique_lock<std::mutex> lock(log_mutex);
+	program_log::get_current().push_entry(std::string(f));
+#else
+	(void)f;
+#endif
+}
 
-	program_log::get_current().push_entry({ f });
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
 
-#if BUILD_IN_CONSOLE_MODE
-	std::cout << f << std::endl;
-#endif
+TEST_CASE("ProgramLog ConcurrentLines") {
+	const auto num_threads = 4u;
+	const auto lines_per_thread = 2000u;
+
+	auto log = program_log(num_threads * lines_per_thread);
 
-	if (log_to_live_file) {
-		std::ofstream recording_file(get_path_in_log_files("live_debug.txt"), std::ios::out | std::ios::app);
-		recording_file << f << std::endl;
+	std::vector<std::thread> threads;
+
+	for (unsigned t = 0; t < num_threads; ++t) {
+		threads.emplace_back([&log, t]() {
+			for (unsigned i = 0; i < lines_per_thread; ++i) {
+				log.push_entry(typesafe_sprintf("%x %x", t, i));
+			}
+		});
 	}
-#else
-	(void)f;
+
+	for (auto& t : threads) {
+		t.join();
+	}
+
+	const auto entries = log.get_recent(num_threads * lines_per_thread);
+	REQUIRE(entries.size() == num_threads * lines_per_thread);
+
+	/* Every line arrives exactly once and each thread's lines keep their order. */
+
+	std::vector<unsigned> next_of_thread(num_threads, 0);
+
+	for (const auto& e : entries) {
+		unsigned t = 0;
+		unsigned i = 0;
+
+		REQUIRE(std::sscanf(e.text.c_str(), "%u %u", &t, &i) == 2);
+		REQUIRE(t < num_threads);
+		REQUIRE(next_of_thread[t] == i);
+
+		++next_of_thread[t];
+	}
+
+	/* Once full, the history drops the oldest lines. */
+
+	log.push_entry("last");
+
+	const auto after = log.get_recent(2);
+	REQUIRE(after.size() == 2);
+	REQUIRE(after[1].text == "last");
+	REQUIRE(log.get_recent(num_threads * lines_per_thread * 2).size() == num_threads * lines_per_thread);
+}
 #endif
-}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include <vector>
+#include <memory>
 #include <cstring>
 
 #include "augs/log_direct.h"
@@ -11,12 +12,21 @@ struct log_entry {
 	std::string text;
 };
 
+/*
+	LOG_DIRECT only moves the line into a lock-free ring owned by the calling thread.
+	A background writer thread periodically drains all rings in the order the lines were logged,
+	appends them to the in-memory history and writes them in batches to the live log file,
+	which stays open for the whole session.
+
+	get_complete and get_recent drain everything pending first,
+	so a line logged right before a crash is never missing from the dump.
+*/
+
 class program_log {
-	static program_log global_instance;
-	unsigned max_all_entries;
+	struct backend;
 
-	void push_entry(const log_entry&);
-	friend void LOG_DIRECT(const std::string& f);
+	static program_log global_instance;
+	std::unique_ptr<backend> impl;
 
 public:
 	static auto& get_current() {
@@ -24,9 +34,17 @@ public:
 	}
 
 	program_log(const unsigned max_all_entries);
+	~program_log();
+
+	program_log(const program_log&) = delete;
+	program_log& operator=(const program_log&) = delete;
+
+	void push_entry(std::string&&);
 
-	std::vector<log_entry> all_entries;
+	/* Blocks until every line logged so far is in the history and in the live file. */
+	void flush();
 
+	std::vector<log_entry> get_recent(std::size_t max_entries) const;
 	std::string get_complete() const;
 };
 
@@ -0,0 +1,124 @@
+#include <new>
+#include <atomic>
+#include <cstdlib>
+
+#if PLATFORM_WINDOWS
+#include <malloc.h>
+#endif
+
+#include "augs/build_settings/setting_count_allocations.h"
+#include "augs/misc/allocation_counter.h"
+
+#if COUNT_ALLOCATIONS
+static std::atomic<uint64_t> num_allocations = 0;
+
+namespace augs {
+	uint64_t get_num_allocations() {
+		return num_allocations.load(std::memory_order_relaxed);
+	}
+}
+
+/*
+	The plain and the aligned forms are replaced.
+	The default nothrow forms forward to them.
+	What the aligned forms allocate has to be released by the aligned deletes,
+	which is why all of them are replaced together.
+*/
+
+static void* allocate_counted(std::size_t n, const std::size_t alignment) {
+	num_allocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (n == 0) {
+		n = 1;
+	}
+
+	for (;;) {
+		void* p = nullptr;
+
+		if (alignment == 0) {
+			p = std::malloc(n);
+		}
+		else {
+#if PLATFORM_WINDOWS
+			p = _aligned_malloc(n, alignment);
+#else
+			/* aligned_alloc wants the size to be a multiple of the alignment. */
+			p = std::aligned_alloc(alignment, (n + alignment - 1) / alignment * alignment);
+#endif
+		}
+
+		if (p != nullptr) {
+			return p;
+		}
+
+		if (const auto handler = std::get_new_handler()) {
+			handler();
+		}
+		else {
+			throw std::bad_alloc();
+		}
+	}
+}
+
+static void free_aligned(void* const p) noexcept {
+#if PLATFORM_WINDOWS
+	_aligned_free(p);
+#else
+	std::free(p);
+#endif
+}
+
+void* operator new(const std::size_t n) {
+	return allocate_counted(n, 0);
+}
+
+void* operator new[](const std::size_t n) {
+	return ::operator new(n);
+}
+
+void operator delete(void* const p) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* const p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* const p, std::size_t) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* const p, std::size_t) noexcept {
+	std::free(p);
+}
+
+void* operator new(const std::size_t n, const std::align_val_t al) {
+	return allocate_counted(n, static_cast<std::size_t>(al));
+}
+
+void* operator new[](const std::size_t n, const std::align_val_t al) {
+	return ::operator new(n, al);
+}
+
+void operator delete(void* const p, std::align_val_t) noexcept {
+	free_aligned(p);
+}
+
+void operator delete[](void* const p, std::align_val_t) noexcept {
+	free_aligned(p);
+}
+
+void operator delete(void* const p, std::size_t, std::align_val_t) noexcept {
+	free_aligned(p);
+}
+
+void operator delete[](void* const p, std::size_t, std::align_val_t) noexcept {
+	free_aligned(p);
+}
+#else
+namespace augs {
+	uint64_t get_num_allocations() {
+		return 0;
+	}
+}
+#endif
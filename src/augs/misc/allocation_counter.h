@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdint>
+
+namespace augs {
+	/*
+		Number of calls to the global operator new (and new[], aligned or not) since the program started, across all threads.
+		Always returns 0 if COUNT_ALLOCATIONS is disabled.
+	*/
+
+	uint64_t get_num_allocations();
+}
@@ -0,0 +1,247 @@
+#pragma once
+#include <vector>
+#include <iterator>
+#include <utility>
+#include "augs/ensure.h"
+#include "augs/ensure_rel.h"
+
+#include "augs/templates/algorithm_templates.h"
+#include "augs/templates/traits/is_comparable.h"
+#include "augs/misc/declare_containers.h"
+#include "augs/templates/traits/is_arena_sized_vector.h"
+
+/*
+	A heap-allocated vector whose capacity is set explicitly and never changes behind the user's back.
+
+	Unlike std::vector:
+	- reserve allocates exactly the requested capacity, which is capped at max_count,
+	- copies have the same capacity as the original,
+	- the only implicit growth happens when the vector is full, and jumps straight to max_count,
+	  so elements move at most once between explicit capacity changes.
+
+	This lets a pool be sized to the content of an arena and then stay pointer-stable,
+	while its copies keep exactly the same limits.
+*/
+
+namespace augs {
+	template <class T, unsigned max_count>
+	class arena_sized_vector {
+		std::vector<T> storage;
+
+		void grow_if_full() {
+			if (size() == capacity()) {
+				ensure_less(size(), max_size());
+				set_capacity(max_size());
+			}
+		}
+
+		void grow_if_exceeded(const std::size_t n) {
+			if (n > capacity()) {
+				ensure_leq(n, max_size());
+				set_capacity(max_size());
+			}
+		}
+
+	public:
+		using value_type = T;
+		using iterator = typename std::vector<T>::iterator;
+		using const_iterator = typename std::vector<T>::const_iterator;
+		using reverse_iterator = typename std::vector<T>::reverse_iterator;
+		using const_reverse_iterator = typename std::vector<T>::const_reverse_iterator;
+
+		arena_sized_vector() = default;
+
+		arena_sized_vector(const arena_sized_vector& b) {
+			storage.reserve(b.capacity());
+			storage.assign(b.begin(), b.end());
+		}
+
+		arena_sized_vector& operator=(const arena_sized_vector& b) {
+			if (this == std::addressof(b)) {
+				return *this;
+			}
+
+			if (capacity() != b.capacity()) {
+				arena_sized_vector copied(b);
+				storage.swap(copied.storage);
+			}
+			else {
+				/* Capacities match, so this never reallocates. */
+				storage.assign(b.begin(), b.end());
+			}
+
+			return *this;
+		}
+
+		arena_sized_vector(arena_sized_vector&&) = default;
+		arena_sized_vector& operator=(arena_sized_vector&&) = default;
+
+		/* Reallocates to exactly n slots. May shrink, but never below size(). */
+		void set_capacity(const std::size_t n) {
+			ensure_leq(size(), n);
+			ensure_leq(n, max_size());
+
+			if (n == capacity()) {
+				return;
+			}
+
+			std::vector<T> reallocated;
+			reallocated.reserve(n);
+
+			for (auto& e : storage) {
+				reallocated.emplace_back(std::move(e));
+			}
+
+			storage.swap(reallocated);
+		}
+
+		void reserve(const std::size_t n) {
+			if (n > capacity()) {
+				set_capacity(n);
+			}
+		}
+
+		void resize(const std::size_t n) {
+			grow_if_exceeded(n);
+			storage.resize(n);
+		}
+
+		void push_back(const value_type& obj) {
+			grow_if_full();
+			storage.push_back(obj);
+		}
+
+		void push_back(value_type&& obj) {
+			grow_if_full();
+			storage.push_back(std::move(obj));
+		}
+
+		template <class... Args>
+		value_type& emplace_back(Args&&... args) {
+			grow_if_full();
+			return storage.emplace_back(std::forward<Args>(args)...);
+		}
+
+		template <class Iter>
+		void assign(const Iter first, const Iter last) {
+			grow_if_exceeded(static_cast<std::size_t>(std::distance(first, last)));
+			storage.assign(first, last);
+		}
+
+		iterator erase(const const_iterator position) {
+			return storage.erase(position);
+		}
+
+		iterator erase(const const_iterator first, const const_iterator last) {
+			return storage.erase(first, last);
+		}
+
+		void pop_back() {
+			storage.pop_back();
+		}
+
+		void clear() {
+			storage.clear();
+		}
+
+		value_type& operator[](const std::size_t i) {
+			return storage[i];
+		}
+
+		const value_type& operator[](const std::size_t i) const {
+			return storage[i];
+		}
+
+		value_type& at(const std::size_t i) {
+			return storage.at(i);
+		}
+
+		const value_type& at(const std::size_t i) const {
+			return storage.at(i);
+		}
+
+		value_type& front() {
+			return storage.front();
+		}
+
+		const value_type& front() const {
+			return storage.front();
+		}
+
+		value_type& back() {
+			return storage.back();
+		}
+
+		const value_type& back() const {
+			return storage.back();
+		}
+
+		value_type* data() {
+			return storage.data();
+		}
+
+		const value_type* data() const {
+			return storage.data();
+		}
+
+		auto begin() {
+			return storage.begin();
+		}
+
+		auto end() {
+			return storage.end();
+		}
+
+		auto begin() const {
+			return storage.begin();
+		}
+
+		auto end() const {
+			return storage.end();
+		}
+
+		auto rbegin() {
+			return storage.rbegin();
+		}
+
+		auto rend() {
+			return storage.rend();
+		}
+
+		auto rbegin() const {
+			return storage.rbegin();
+		}
+
+		auto rend() const {
+			return storage.rend();
+		}
+
+		std::size_t size() const {
+			return storage.size();
+		}
+
+		std::size_t capacity() const {
+			return storage.capacity();
+		}
+
+		static constexpr std::size_t max_size() {
+			return max_count;
+		}
+
+		bool empty() const {
+			return storage.empty();
+		}
+
+		operator std::vector<value_type>() const {
+			return storage;
+		}
+	};
+
+	template <class T, unsigned C, class = std::enable_if_t<is_comparable_v<T, T>>>
+	bool operator==(
+		const arena_sized_vector<T, C>& a,
+		const arena_sized_vector<T, C>& b
+	) {
+		return ranges_equal(a, b);
+	}
+}
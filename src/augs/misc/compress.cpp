@@ -31,19 +31,28 @@ namespace augs {
 		const std::vector<std::byte>& input,
 		std::vector<std::byte>& output
 	) {
+		compress(state, input.data(), input.size(), output);
+	}
+
+	void compress(
+		std::vector<std::byte>& state,
+		const std::byte* const input,
+		const std::size_t byte_count,
+		std::vector<std::byte>& output
+	) {
 #if DISABLE_COMPRESSION
 		(void)state;
-		concatenate(output, input);
+		output.insert(output.end(), input, input + byte_count);
 #else
-		const auto size_bound = LZ4_compressBound(input.size());
+		const auto size_bound = LZ4_compressBound(byte_count);
 		const auto prev_size = output.size();
 		output.resize(prev_size + size_bound);
 
 		const auto bytes_written = LZ4_compress_fast_extState(
 			reinterpret_cast<void*>(state.data()), 
-			reinterpret_cast<const char*>(input.data()), 
+			reinterpret_cast<const char*>(input), 
 			reinterpret_cast<char*>(output.data() + prev_size), 
-			input.size(),
+			byte_count,
 			size_bound,
 			1
 		);
@@ -78,22 +87,41 @@ namespace augs {
 #if DISABLE_COMPRESSION
 		output.assign(input, input + byte_count);
 #else
-		const auto uncompressed_size = output.size();
+		try {
+			decompress(input, byte_count, output.data(), output.size());
+		}
+		catch (...) {
+			output.clear();
+			throw;
+		}
+#endif
+	}
 
+	void decompress(
+		const std::byte* const input,
+		const std::size_t byte_count,
+		std::byte* const output,
+		const std::size_t uncompressed_size
+	) {
+#if DISABLE_COMPRESSION
+		if (byte_count != uncompressed_size) {
+			throw decompression_error("Decompression failure. Read %x bytes, but expected %x.", byte_count, uncompressed_size);
+		}
+
+		std::copy(input, input + byte_count, output);
+#else
 		const auto bytes_read = LZ4_decompress_safe(
 			reinterpret_cast<const char*>(input), 
-			reinterpret_cast<char*>(output.data()), 
+			reinterpret_cast<char*>(output), 
 			byte_count,
 			uncompressed_size
 		);
 
 		if (bytes_read < 0) {
-			output.clear();
 			throw decompression_error("Decompression failure. Failed to read any bytes.");
 		}
 
 		if (uncompressed_size != static_cast<std::size_t>(bytes_read)) {
-			output.clear();
 			throw decompression_error("Decompression failure. Read %x bytes, but expected %x.", bytes_read, uncompressed_size);
 		}
 #endif
@@ -169,4 +197,38 @@ TEST_CASE("Ca CompressionDecompression") {
 		}
 	}
 }
+
+TEST_CASE("Ca ChunkedCompressionDecompression") {
+	std::vector<std::byte> input;
+
+	for (int i = 0; i < 10000; ++i) {
+		input.push_back(static_cast<std::byte>((i * 7) % 13 + (i / 100)));
+	}
+
+	const std::size_t chunk_size = 3000;
+
+	auto state = augs::make_compression_state();
+	std::vector<std::vector<std::byte>> chunks;
+
+	for (std::size_t offset = 0; offset < input.size(); offset += chunk_size) {
+		const auto len = std::min(chunk_size, input.size() - offset);
+
+		chunks.emplace_back();
+		augs::compress(state, input.data() + offset, len, chunks.back());
+	}
+
+	REQUIRE(chunks.size() == 4);
+
+	std::vector<std::byte> output;
+	output.resize(input.size());
+
+	for (std::size_t i = 0; i < chunks.size(); ++i) {
+		const auto offset = i * chunk_size;
+		const auto len = std::min(chunk_size, input.size() - offset);
+
+		augs::decompress(chunks[i].data(), chunks[i].size(), output.data() + offset, len);
+	}
+
+	REQUIRE(output == input);
+}
 #endif
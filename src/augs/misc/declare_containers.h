@@ -9,6 +9,9 @@ namespace augs {
 
 	template <unsigned const_count>
 	class constant_size_string;
+
+	template <class T, unsigned max_count>
+	class arena_sized_vector;
 }
 
 template <unsigned I>
@@ -18,4 +21,7 @@ struct of_size {
 
 	template <class T>
 	using make_nontrivial_constant_vector = augs::constant_size_vector<T, I, true>;
+
+	template <class T>
+	using make_arena_sized_vector = augs::arena_sized_vector<T, I>;
 };
\ No newline at end of file
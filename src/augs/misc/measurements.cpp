@@ -1,4 +1,77 @@
 #include "measurements.h"
 namespace augs {
 
-}
\ No newline at end of file
+}
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+#include <deque>
+#include <random>
+
+TEST_CASE("Measurements RollingWindow") {
+	/* Compare against a window recomputed from scratch on every sample. */
+
+	const std::size_t window = 7;
+
+	auto m = augs::amount_measurements<int>(window);
+	auto reference = std::deque<int>(window, 0);
+
+	auto rng = std::mt19937(1337);
+	auto dist = std::uniform_int_distribution<int>(0, 100);
+
+	for (int i = 0; i < 1000; ++i) {
+		const auto v = dist(rng);
+
+		m.measure(v);
+
+		reference.pop_front();
+		reference.push_back(v);
+
+		int sum = 0;
+
+		for (const auto r : reference) {
+			sum += r;
+		}
+
+		REQUIRE(m.get_average_units() == sum / static_cast<int>(window));
+		REQUIRE(m.get_minimum_units() == *std::min_element(reference.begin(), reference.end()));
+		REQUIRE(m.get_maximum_units() == *std::max_element(reference.begin(), reference.end()));
+		REQUIRE(m.get_last_measurement_units() == v);
+	}
+
+	REQUIRE(m.get_num_measurements() == 1000);
+}
+
+TEST_CASE("Measurements Percentiles") {
+	auto m = augs::time_measurements();
+
+	REQUIRE(!m.tracks_percentiles());
+
+	m.enable_percentiles(1e-6, 10.0);
+
+	/* 98 fast steps, then 2 slow ones. */
+
+	for (int i = 0; i < 98; ++i) {
+		m.measure(0.001);
+	}
+
+	m.measure(0.05);
+	m.measure(0.05);
+
+	REQUIRE(m.get_num_percentile_samples() == 100);
+
+	const auto p50 = m.get_percentile_units(0.5);
+	const auto p99 = m.get_percentile_units(0.99);
+
+	REQUIRE(p50 >= 0.001);
+	REQUIRE(p50 < 0.001 * 1.1);
+
+	REQUIRE(p99 >= 0.05);
+	REQUIRE(p99 < 0.05 * 1.1);
+
+	m.reset_percentiles();
+
+	REQUIRE(m.get_num_percentile_samples() == 0);
+	REQUIRE(m.get_percentile_units(0.99) == 0.0);
+}
+#endif
@@ -1,5 +1,9 @@
 #pragma once
+#include <cmath>
 #include <string>
+#include <vector>
+#include <optional>
+#include <functional>
 
 #include "augs/ensure.h"
 #include "augs/string/typesafe_sprintf.h"
@@ -9,8 +13,148 @@
 #include "augs/misc/scope_guard.h"
 
 namespace augs {
+	/*
+		Counts samples in buckets spaced geometrically between lowest and highest,
+		so that any percentile can be read back with a fixed relative error
+		(about 7% with the default 32 buckets per decade).
+		Samples outside of the range land in the first or the last bucket.
+	*/
+
+	class percentile_histogram {
+		double lowest = 0.0;
+		double buckets_per_log10 = 0.0;
+
+		std::vector<uint32_t> counts;
+		std::size_t num_samples = 0;
+
+	public:
+		percentile_histogram(
+			const double lowest,
+			const double highest,
+			const std::size_t buckets_per_decade = 32
+		) : 
+			lowest(lowest),
+			buckets_per_log10(static_cast<double>(buckets_per_decade))
+		{
+			ensure(lowest > 0.0);
+			ensure(highest > lowest);
+
+			counts.resize(2 + static_cast<std::size_t>(std::ceil(std::log10(highest / lowest) * buckets_per_log10)));
+		}
+
+		void add(const double value) {
+			const auto last = counts.size() - 1;
+
+			const auto bucket = [&]() -> std::size_t {
+				if (!(value >= lowest)) {
+					return 0;
+				}
+
+				const auto b = 1 + std::log10(value / lowest) * buckets_per_log10;
+				return b >= last ? last : static_cast<std::size_t>(b);
+			}();
+
+			++counts[bucket];
+			++num_samples;
+		}
+
+		/* The upper edge of the bucket holding the sample at this fraction, e.g. 0.99 for p99. */
+
+		double get(const double fraction) const {
+			if (num_samples == 0) {
+				return 0.0;
+			}
+
+			const auto target = static_cast<std::size_t>(std::ceil(fraction * num_samples));
+			std::size_t seen = 0;
+
+			for (std::size_t i = 0; i < counts.size(); ++i) {
+				seen += counts[i];
+
+				if (seen >= std::max(target, std::size_t(1))) {
+					return lowest * std::pow(10.0, i / buckets_per_log10);
+				}
+			}
+
+			return lowest * std::pow(10.0, (counts.size() - 1) / buckets_per_log10);
+		}
+
+		std::size_t get_num_samples() const {
+			return num_samples;
+		}
+
+		void clear() {
+			std::fill(counts.begin(), counts.end(), 0u);
+			num_samples = 0;
+		}
+	};
+
 	template <class derived, class T = double>
 	class measurements {
+		/*
+			Candidates for the minimum (or maximum) of the tracked window, 
+			ordered by age, with values monotonic from the front.
+			Each sample enters and leaves at most once, so updates are amortized O(1).
+		*/
+
+		struct monotonic_window {
+			struct entry {
+				std::size_t sample;
+				T value;
+			};
+
+			std::vector<entry> ring;
+			std::size_t first = 0;
+			std::size_t count = 0;
+
+			void reset(const std::size_t window) {
+				ring.resize(window + 1);
+				first = 0;
+				count = 0;
+			}
+
+			entry& at(const std::size_t i) {
+				return ring[(first + i) % ring.size()];
+			}
+
+			const entry& front() const {
+				return ring[first];
+			}
+
+			template <class Before>
+			void push(const std::size_t sample, const T value, const std::size_t window, Before before) {
+				while (count > 0 && front().sample + window <= sample) {
+					first = (first + 1) % ring.size();
+					--count;
+				}
+
+				while (count > 0 && !before(at(count - 1).value, value)) {
+					--count;
+				}
+
+				at(count) = { sample, value };
+				++count;
+			}
+		};
+
+		monotonic_window window_minimum;
+		monotonic_window window_maximum;
+
+		T window_sum = T();
+
+		/* The window is filled with default values in the beginning, as if they were measured before. */
+
+		void reset_window() {
+			const auto n = tracked.size();
+
+			window_sum = T();
+			window_minimum.reset(n);
+			window_maximum.reset(n);
+
+			window_minimum.push(n - 1, T(), n, std::less<T>());
+			window_maximum.push(n - 1, T(), n, std::greater<T>());
+		}
+
 	protected:
 		std::size_t measurement_index = 0;
 
@@ -19,8 +163,13 @@ namespace augs {
 		T last_maximum = T();
 		T last_measurement = T();
 
+		T total = T();
+		std::size_t num_measurements = 0;
+
 		bool measured = false;
 
+		std::optional<percentile_histogram> percentiles;
+
 		struct summary_data {
 			bool measured = false;
 			T value = T();
@@ -35,25 +184,79 @@ namespace augs {
 		measurements(const std::size_t tracked_count = 50u) {
 			ensure(tracked_count != 0);
 			tracked.resize(tracked_count);
+			reset_window();
 		}
 
 		void measure(const T value) {
 			measured = true;
 			last_measurement = value;
 
+			total += value;
+
+			const auto n = tracked.size();
+
+			/* Samples are numbered from n, so that the initial default values precede all of them. */
+			const auto sample = n + num_measurements;
+			++num_measurements;
+
+			window_sum -= tracked[measurement_index];
+			window_sum += value;
+
 			tracked[measurement_index] = last_measurement;
 			++measurement_index;
-			measurement_index %= tracked.size();
+			measurement_index %= n;
+
+			if (measurement_index == 0) {
+				/* Once per lap, so that rounding errors of the running sum never accumulate. */
+
+				window_sum = T();
+
+				for (const auto v : tracked) {
+					window_sum += v;
+				}
+			}
+
+			window_minimum.push(sample, value, n, std::less<T>());
+			window_maximum.push(sample, value, n, std::greater<T>());
 
-			T avg = T();
+			last_average = window_sum / static_cast<unsigned>(n);
+			last_minimum = window_minimum.front().value;
+			last_maximum = window_maximum.front().value;
 
-			for (auto v : tracked) {
-				avg += v;
+			if (percentiles) {
+				percentiles->add(static_cast<double>(value));
 			}
+		}
+
+		/*
+			Percentiles are counted over all samples since the last reset_percentiles,
+			not just over the tracked window.
+		*/
+
+		void enable_percentiles(const T lowest, const T highest) {
+			percentiles.emplace(static_cast<double>(lowest), static_cast<double>(highest));
+		}
+
+		bool tracks_percentiles() const {
+			return percentiles.has_value();
+		}
+
+		T get_percentile_units(const double fraction) const {
+			if (percentiles) {
+				return static_cast<T>(percentiles->get(fraction));
+			}
+
+			return T();
+		}
 
-			last_average = avg / static_cast<unsigned>(tracked.size());
-			last_maximum = maximum_of(tracked);
-			last_minimum = minimum_of(tracked);
+		std::size_t get_num_percentile_samples() const {
+			return percentiles ? percentiles->get_num_samples() : 0;
+		}
+
+		void reset_percentiles() {
+			if (percentiles) {
+				percentiles->clear();
+			}
 		}
 
 		std::string summary() const {
@@ -81,6 +284,16 @@ namespace augs {
 			return last_measurement;
 		}
 
+		/* Totals over the whole lifetime, not just the tracked window. */
+
+		T get_total_units() const {
+			return total;
+		}
+
+		std::size_t get_num_measurements() const {
+			return num_measurements;
+		}
+
 		bool was_measured() const {
 			return summary_info.measured;
 		}
@@ -4,7 +4,9 @@
 #include "augs/misc/pool/pool_io.hpp"
 #include "augs/misc/pool/pool_allocate.h"
 #include "augs/misc/constant_size_vector.h"
+#include "augs/misc/arena_sized_vector.h"
 #include "augs/readwrite/readwrite_test_cycle.h"
+#include "augs/readwrite/to_bytes.h"
 
 using p_t = augs::pool<int, of_size<6>::make_nontrivial_constant_vector, unsigned short>;
 using k_t = p_t::key_type; 
@@ -173,7 +175,121 @@ void test_pool() {
 
 TEST_CASE("Pool Readwrite") {
 	test_pool<augs::pool<float, of_size<100>::make_nontrivial_constant_vector, unsigned short>>();
+	test_pool<augs::pool<float, of_size<100>::make_arena_sized_vector, unsigned short>>();
 	test_pool<augs::pool<float, make_vector, unsigned char>>();
 }
 
+TEST_CASE("Pool FitCapacity") {
+	using a_t = augs::pool<int, of_size<100>::make_arena_sized_vector, unsigned short>;
+
+	a_t p;
+
+	/* An unfitted pool goes straight to its ceiling. */
+	const auto first = p.allocate(0).key;
+	REQUIRE(p.capacity() == 100);
+
+	kv_t keys;
+
+	for (int i = 1; i < 10; ++i) {
+		keys.push_back(p.allocate(i).key);
+	}
+
+	/* Leave a hole so that the highest used indirector is above the size. */
+	p.free(keys[4]);
+
+	p.fit_capacity(2);
+
+	REQUIRE(p.is_capacity_fixed());
+	REQUIRE(p.capacity() == 11);
+	REQUIRE(p.get(first) == 0);
+	REQUIRE(p.find(keys[4]) == nullptr);
+
+	for (std::size_t i = 0; i < keys.size(); ++i) {
+		if (i != 4) {
+			REQUIRE(p.get(keys[i]) == static_cast<int>(i + 1));
+		}
+	}
+
+	const auto* const stable = p.data();
+
+	while (p.size() < p.capacity()) {
+		p.allocate(-1);
+	}
+
+	REQUIRE(p.data() == stable);
+	REQUIRE(p.full());
+	REQUIRE_THROWS(p.allocate(-1));
+
+	/* Copies and round trips keep the exact capacity. */
+	{
+		const a_t copied = p;
+		REQUIRE(copied.capacity() == p.capacity());
+		REQUIRE(copied.is_capacity_fixed());
+
+		a_t assigned;
+		assigned.allocate(0);
+		assigned = p;
+		REQUIRE(assigned.capacity() == p.capacity());
+		REQUIRE(assigned.full());
+
+		readwrite_test_cycle(p);
+	}
+
+	/* Growing keeps all ids valid too. */
+	p.fit_capacity(30);
+	REQUIRE(p.capacity() == 41);
+	REQUIRE(p.get(first) == 0);
+	REQUIRE(!p.full());
+
+	/* Fitting never goes above the ceiling. */
+	p.fit_capacity(1000);
+	REQUIRE(p.capacity() == 100);
+
+	p.clear();
+	REQUIRE(!p.is_capacity_fixed());
+}
+
+TEST_CASE("Pool ArenaSizedByteFormat") {
+	using a_t = augs::pool<int, of_size<100>::make_arena_sized_vector, unsigned short>;
+	using s_t = augs::pool<int, of_size<100>::make_nontrivial_constant_vector, unsigned short>;
+
+	a_t a;
+	s_t s = s_t(100);
+
+	for (int i = 0; i < 10; ++i) {
+		a.allocate(i);
+		s.allocate(i);
+	}
+
+	/* At its ceiling, an arena-sized pool writes the same bytes as a static one. */
+	REQUIRE(augs::to_bytes(a) == augs::to_bytes(s));
+
+	/* So the static bytes are read at the capacity they were written with. */
+	{
+		a_t read;
+		augs::from_bytes(augs::to_bytes(s), read);
+
+		REQUIRE(read.capacity() == 100);
+		REQUIRE(read.size() == 10);
+		REQUIRE(augs::to_bytes(read) == augs::to_bytes(s));
+	}
+
+	a.fit_capacity(5);
+
+	/* The fixed flag is not written, so whoever reads a fitted pool must restore it. */
+	{
+		a_t read;
+		augs::from_bytes(augs::to_bytes(a), read);
+
+		REQUIRE(read.capacity() == a.capacity());
+		REQUIRE(!read.is_capacity_fixed());
+
+		read.fix_capacity();
+
+		REQUIRE(read.is_capacity_fixed());
+		REQUIRE(read.capacity() == a.capacity());
+		REQUIRE(augs::to_bytes(read) == augs::to_bytes(a));
+	}
+}
+
 #endif
@@ -8,11 +8,13 @@
 
 #include "augs/templates/maybe_const.h"
 #include "augs/templates/traits/container_traits.h"
+#include "augs/templates/traits/is_arena_sized_vector.h"
 #include "augs/templates/container_templates.h"
 
 #include "augs/misc/pool/pool_structs.h"
 #include "augs/misc/pool/pooled_object_id.h"
 #include "augs/templates/per_type.h"
+#include "augs/templates/remove_cref.h"
 
 namespace augs {
 	template <class T, template <class> class make_container_type, class size_type, class synchronized_array_list = type_list<>, class... id_keys>
@@ -34,6 +36,7 @@ namespace augs {
 
 		static constexpr bool constexpr_max_size = has_constexpr_max_size_v<object_pool_type>;
 		static constexpr bool has_synchronized_arrays = !std::is_same_v<synchronized_array_list, type_list<>>;
+		static constexpr bool arena_sized = is_arena_sized_vector_v<object_pool_type>;
 
 		make_container_type<pool_slot_type> slots;
 		object_pool_type objects;
@@ -41,6 +44,13 @@ namespace augs {
 		make_container_type<size_type> free_indirectors;
 		per_type_container<synchronized_array_list, make_container_type> synchronized_arrays;
 
+		/* 
+			Set by fit_capacity or fix_capacity. 
+			A fitted pool never reallocates, even if the container could still grow.
+		*/
+
+		bool capacity_fixed = false;
+
 		auto& get_indirector(const key_type key) {
 			return indirectors[key.indirection_index];
 		}
@@ -111,6 +121,7 @@ namespace augs {
 				synchronized_arrays.reserve(new_capacity);
 			}
 
+			indirectors.reserve(new_capacity);
 			indirectors.resize(new_capacity);
 			free_indirectors.reserve(new_capacity);
 
@@ -119,6 +130,86 @@ namespace augs {
 			}
 		}
 
+		/*
+			Reallocates the pool to hold exactly its current objects plus headroom, clamped to max_size.
+			The capacity never drops below the highest indirector still in use,
+			so the ids of existing objects stay valid.
+
+			Afterwards, the pool throws on allocation once the headroom is exhausted,
+			so pointers to its objects stay valid until the next fit_capacity or clear.
+		*/
+
+		void fit_capacity(const size_type headroom) {
+			static_assert(arena_sized, "fit_capacity requires a container with an explicit capacity.");
+
+			std::size_t required = 0;
+
+			for (const auto& s : slots) {
+				required = std::max(required, static_cast<std::size_t>(s.pointing_indirector) + 1);
+			}
+
+			const auto new_capacity = static_cast<size_type>(std::min(
+				static_cast<std::size_t>(max_size()),
+				std::max(required, static_cast<std::size_t>(size()) + headroom)
+			));
+
+			const auto old_capacity = capacity();
+
+			slots.set_capacity(new_capacity);
+			objects.set_capacity(new_capacity);
+
+			if constexpr(has_synchronized_arrays) {
+				synchronized_arrays.for_each_container([&](auto& arr) {
+					arr.set_capacity(new_capacity);
+				});
+			}
+
+			if (new_capacity < old_capacity) {
+				/* 
+					The trimmed indirectors are all free. 
+					Ids still pointing to them will simply fail the range check.
+				*/
+
+				free_indirectors.erase(
+					std::remove_if(
+						free_indirectors.begin(), 
+						free_indirectors.end(), 
+						[new_capacity](const size_type i) { return i >= new_capacity; }
+					),
+					free_indirectors.end()
+				);
+
+				indirectors.resize(new_capacity);
+				indirectors.set_capacity(new_capacity);
+				free_indirectors.set_capacity(new_capacity);
+			}
+			else {
+				indirectors.set_capacity(new_capacity);
+				indirectors.resize(new_capacity);
+				free_indirectors.set_capacity(new_capacity);
+
+				for (size_type i = 0; i < (new_capacity - old_capacity); ++i) {
+					free_indirectors.push_back(new_capacity - i - 1);
+				}
+			}
+
+			capacity_fixed = true;
+		}
+
+		/*
+			Makes the current capacity final without reallocating,
+			for a pool read from the bytes of a pool that was fitted.
+		*/
+
+		void fix_capacity() {
+			static_assert(arena_sized, "fix_capacity requires a container with an explicit capacity.");
+			capacity_fixed = true;
+		}
+
+		bool is_capacity_fixed() const {
+			return capacity_fixed;
+		}
+
 		struct allocation_result {
 			key_type key;
 			mapped_type& object;
@@ -296,7 +387,7 @@ namespace augs {
 		}
 
 		bool can_still_expand() const {
-			return size() < max_size();
+			return !capacity_fixed && size() < max_size();
 		}
 
 		bool full() const {
@@ -400,6 +491,7 @@ namespace augs {
 				synchronized_arrays.clear();
 			}
 
+			capacity_fixed = false;
 			reserve(c);
 		}
 
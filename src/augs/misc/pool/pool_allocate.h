@@ -13,7 +13,16 @@ namespace augs {
 		if (size_at_capacity()) {
 			if (can_still_expand()) {
 				const auto old_size = size();
-				const auto new_size = static_cast<std::size_t>(old_size) * expansion_mult + expansion_add;
+				/* 
+					An arena-sized pool that was never fitted goes straight to its ceiling,
+					so that its objects move at most once.
+				*/
+
+				const auto new_size = arena_sized
+					? static_cast<std::size_t>(max_size())
+					: static_cast<std::size_t>(old_size) * expansion_mult + expansion_add
+				;
+
 				const auto trimmed_new_size = std::min(static_cast<std::size_t>(max_size()), new_size);
 
 				ensure_greater(trimmed_new_size, static_cast<std::size_t>(old_size));
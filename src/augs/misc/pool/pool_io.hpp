@@ -3,6 +3,7 @@
 
 #include "augs/readwrite/byte_readwrite_declaration.h"
 #include "augs/readwrite/lua_readwrite_declaration.h"
+#include "augs/readwrite/stream_read_error.h"
 
 #if READWRITE_OVERLOAD_TRAITS_INCLUDED || LUA_READWRITE_OVERLOAD_TRAITS_INCLUDED
 #error "I/O traits were included BEFORE I/O overloads, which may cause them to be omitted under some compilers."
@@ -27,7 +28,28 @@ namespace augs {
 	template <class Archive>
 	void pool<A, B, C, D, E...>::read_object_bytes(Archive& ar) {
 		auto r = [&ar](auto& object) {
-			augs::read_capacity_bytes(ar, object);
+			if constexpr(arena_sized) {
+				/* 
+					The capacity of a fitted pool is a part of its state, 
+					so it must come out exactly as written, not merely at least as big.
+				*/
+
+				unsigned c;
+				augs::read_bytes(ar, c);
+
+				if (c > object.max_size()) {
+					throw stream_read_error(
+						"Requested storage capacity is bigger than its max_size!"
+					);
+				}
+
+				object.clear();
+				object.set_capacity(c);
+			}
+			else {
+				augs::read_capacity_bytes(ar, object);
+			}
+
 			augs::read_bytes(ar, object);
 		};
 
@@ -36,9 +58,24 @@ namespace augs {
 		r(indirectors);
 		r(free_indirectors);
 
+		/* 
+			The fixed flag is not a part of the byte format, so that it stays the same as for the static pools.
+			Whoever reads a fitted pool must fix its capacity again - see fix_capacity.
+		*/
+
+		capacity_fixed = false;
+
 		if constexpr(has_synchronized_arrays) {
 			synchronized_arrays.for_each_container(
 				[&](auto& container) {
+					if constexpr(arena_sized) {
+						if (container.size() > objects.size()) {
+							container.resize(objects.size());
+						}
+
+						container.set_capacity(objects.capacity());
+					}
+
 					container.resize(objects.size());
 				}
 			);
@@ -82,6 +119,7 @@ namespace augs {
 		slots.clear();
 		indirectors.clear();
 		free_indirectors.clear();
+		capacity_fixed = false;
 
 		auto objects_table = from["objects"];
 		auto indirectors_table = from["indirectors"];
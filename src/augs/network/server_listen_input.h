@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <cstdint>
 #include "augs/templates/maybe.h"
 #include "augs/network/port_type.h"
 
@@ -14,7 +15,7 @@ namespace augs {
 
 	struct dedicated_server_input {
 		// GEN INTROSPECTOR struct augs::dedicated_server_input
-		bool dummy = false;
+		uint32_t num_instances = 1;
 		// END GEN INTROSPECTOR
 	};
 }
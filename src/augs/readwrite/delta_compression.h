@@ -1,9 +1,11 @@
 #pragma once
 #include <vector>
+#include <cstring>
 #include "augs/templates/traits/triviality_traits.h"
 #include "augs/templates/get_index_type_for_size_of.h"
 #include "augs/templates/introspect_declaration.h"
 #include "augs/readwrite/to_bytes.h"
+#include "augs/readwrite/find_byte_runs.h"
 
 #include "augs/ensure.h"
 #include "augs/ensure_rel.h"
@@ -128,22 +130,29 @@ namespace augs {
 			const delta_unit* const base_object_ptr = reinterpret_cast<const delta_unit*>(std::addressof(base_object));
 			const delta_unit* const encoded_object_ptr = reinterpret_cast<const delta_unit*>(std::addressof(encoded_object));
 
-			thread_local std::vector<char> diff_flags;
-			diff_flags.resize(length_bytes);
+			/*
+				Every changed run is emitted as a pair:
+				(distance from the end of the previous run, length of the run).
+			*/
 
-			auto* const diff_flags_ptr = diff_flags.data();
+			std::size_t previous_run_end = 0;
 
-			for (std::size_t i = 0; i < length_bytes; ++i) {
-				if (base_object_ptr[i] == encoded_object_ptr[i]) {
-					diff_flags_ptr[i] = 0;
-				}
-				else {
-					diff_flags_ptr[i] = 1;
-					changed_bytes.push_back(encoded_object_ptr[i]);
+			while (true) {
+				const auto run_begin = find_first_differing_byte(base_object_ptr, encoded_object_ptr, previous_run_end, length_bytes);
+
+				if (run_begin == length_bytes) {
+					break;
 				}
-			}
 
-			changed_offsets = run_length_encoding<offset_type>(diff_flags);
+				const auto run_end = find_first_equal_byte(base_object_ptr, encoded_object_ptr, run_begin + 1, length_bytes);
+
+				changed_offsets.push_back(static_cast<offset_type>(run_begin - previous_run_end));
+				changed_offsets.push_back(static_cast<offset_type>(run_end - run_begin));
+
+				changed_bytes.insert(changed_bytes.end(), encoded_object_ptr + run_begin, encoded_object_ptr + run_end);
+
+				previous_run_end = run_end;
+			}
 		}
 
 		void decode_into(T& decoded) const {
@@ -153,13 +162,15 @@ namespace augs {
 
 			const delta_unit * const original_location = ptr;
 
-			std::size_t previous_vector_pos = 0;
+			const delta_unit* source = changed_bytes.data();
 
 			for (std::size_t i = 0; i < changed_offsets.size(); i += 2) {
+				const std::size_t run_length = changed_offsets[i + 1];
+
 				ptr += changed_offsets[i];
-				std::copy(changed_bytes.begin() + previous_vector_pos, changed_bytes.begin() + previous_vector_pos + changed_offsets[i + 1], ptr);
-				previous_vector_pos += changed_offsets[i + 1];
-				ptr += changed_offsets[i + 1];
+				std::memcpy(ptr, source, run_length * sizeof(delta_unit));
+				source += run_length;
+				ptr += run_length;
 			}
 
 			ensure_leq(static_cast<const delta_unit*>(ptr), original_location + length);
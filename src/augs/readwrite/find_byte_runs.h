@@ -0,0 +1,124 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#define AUGS_FIND_BYTE_RUNS_AVX2 1
+#else
+#define AUGS_FIND_BYTE_RUNS_AVX2 0
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUGS_FIND_BYTE_RUNS_SSE2 1
+#else
+#define AUGS_FIND_BYTE_RUNS_SSE2 0
+#endif
+
+#if AUGS_FIND_BYTE_RUNS_AVX2 || AUGS_FIND_BYTE_RUNS_SSE2
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace augs {
+	namespace detail {
+		inline unsigned count_trailing_zeros(const uint32_t mask) {
+#if defined(_MSC_VER)
+			unsigned long result;
+			_BitScanForward(&result, mask);
+			return static_cast<unsigned>(result);
+#else
+			return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+		}
+
+		/*
+			Returns the first position in [i, n) at which
+			a[i] == b[i] if find_equal is true, or a[i] != b[i] otherwise.
+			Returns n if there is no such position.
+
+			Compares 32 or 16 bytes at a time where the instruction set allows it.
+		*/
+
+		template <bool find_equal>
+		std::size_t find_first_byte_where(
+			const std::byte* const a,
+			const std::byte* const b,
+			std::size_t i,
+			const std::size_t n
+		) {
+#if AUGS_FIND_BYTE_RUNS_AVX2
+			for (; i + 32 <= n; i += 32) {
+				const auto va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+				const auto vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+
+				const auto equal_mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb)));
+				const auto hits = find_equal ? equal_mask : ~equal_mask;
+
+				if (hits != 0) {
+					return i + count_trailing_zeros(hits);
+				}
+			}
+#endif
+
+#if AUGS_FIND_BYTE_RUNS_SSE2
+			for (; i + 16 <= n; i += 16) {
+				const auto va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+				const auto vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+
+				const auto equal_mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)));
+				const auto hits = (find_equal ? equal_mask : ~equal_mask) & 0xFFFFu;
+
+				if (hits != 0) {
+					return i + count_trailing_zeros(hits);
+				}
+			}
+#else
+			if constexpr(!find_equal) {
+				/* Without SIMD, at least skip identical words whole. */
+
+				for (; i + 8 <= n; i += 8) {
+					uint64_t wa;
+					uint64_t wb;
+
+					std::memcpy(&wa, a + i, sizeof(wa));
+					std::memcpy(&wb, b + i, sizeof(wb));
+
+					if (wa != wb) {
+						break;
+					}
+				}
+			}
+#endif
+
+			for (; i < n; ++i) {
+				if ((a[i] == b[i]) == find_equal) {
+					return i;
+				}
+			}
+
+			return n;
+		}
+	}
+
+	inline std::size_t find_first_differing_byte(
+		const std::byte* const a,
+		const std::byte* const b,
+		const std::size_t from,
+		const std::size_t n
+	) {
+		return detail::find_first_byte_where<false>(a, b, from, n);
+	}
+
+	inline std::size_t find_first_equal_byte(
+		const std::byte* const a,
+		const std::byte* const b,
+		const std::size_t from,
+		const std::size_t n
+	) {
+		return detail::find_first_byte_where<true>(a, b, from, n);
+	}
+}
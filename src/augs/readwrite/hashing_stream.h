@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+namespace augs {
+	/*
+		A write-only byte stream that folds everything written into a running 64-bit hash
+		instead of storing it anywhere.
+
+		Lets augs::write_bytes hash arbitrary state without allocating a single byte.
+		The result does not depend on how the written data was split into chunks.
+	*/
+
+	class hashing_stream {
+		static constexpr uint64_t multiplier_a = 0x9E3779B97F4A7C15ull;
+		static constexpr uint64_t multiplier_b = 0xC2B2AE3D27D4EB4Full;
+
+		uint64_t state = 0x84222325CBF29CE4ull;
+		uint64_t pending = 0;
+		unsigned pending_bytes = 0;
+		std::size_t write_pos = 0;
+
+		static uint64_t rotl(const uint64_t x, const int r) {
+			return (x << r) | (x >> (64 - r));
+		}
+
+		void mix(const uint64_t word) {
+			state ^= rotl(word * multiplier_b, 31) * multiplier_a;
+			state = rotl(state, 27) * multiplier_a + 0x52DCE729ull;
+		}
+
+		static uint64_t finalize(uint64_t h) {
+			h ^= h >> 33;
+			h *= 0xFF51AFD7ED558CCDull;
+			h ^= h >> 33;
+			h *= 0xC4CEB9FE1A85EC53ull;
+			h ^= h >> 33;
+			return h;
+		}
+
+	public:
+		void write(const std::byte* data, std::size_t bytes) {
+			write_pos += bytes;
+
+			while (bytes > 0 && pending_bytes > 0) {
+				pending |= static_cast<uint64_t>(*data) << (8 * pending_bytes);
+				++data;
+				--bytes;
+
+				if (++pending_bytes == 8) {
+					mix(pending);
+					pending = 0;
+					pending_bytes = 0;
+				}
+			}
+
+			while (bytes >= 8) {
+				uint64_t word;
+				std::memcpy(&word, data, sizeof(word));
+				mix(word);
+
+				data += 8;
+				bytes -= 8;
+			}
+
+			while (bytes > 0) {
+				pending |= static_cast<uint64_t>(*data) << (8 * pending_bytes);
+				++pending_bytes;
+				++data;
+				--bytes;
+			}
+		}
+
+		uint64_t get_hash() const {
+			auto copy = *this;
+
+			if (copy.pending_bytes > 0) {
+				copy.mix(copy.pending);
+			}
+
+			copy.mix(static_cast<uint64_t>(write_pos));
+			return finalize(copy.state);
+		}
+
+		std::size_t get_write_pos() const {
+			return write_pos;
+		}
+	};
+}
@@ -10,6 +10,7 @@
 
 #include "augs/string/string_templates.h"
 #include "augs/readwrite/readwrite_test_cycle.h"
+#include "augs/readwrite/hashing_stream.h"
 
 #include "augs/math/vec2.h"
 #include "augs/math/transform.h"
@@ -405,5 +406,36 @@ TEST_CASE("Byte readwrite Variants and optionals") {
 		readwrite_test_cycle(v);
 	}
 }
+
+TEST_CASE("Byte readwrite HashingStream") {
+	std::vector<std::byte> bytes;
+
+	for (int i = 0; i < 1000; ++i) {
+		bytes.push_back(static_cast<std::byte>(i * 31 + 7));
+	}
+
+	augs::hashing_stream whole;
+	whole.write(bytes.data(), bytes.size());
+
+	augs::hashing_stream chunked;
+
+	for (std::size_t i = 0; i < bytes.size(); i += 3) {
+		chunked.write(bytes.data() + i, std::min(std::size_t(3), bytes.size() - i));
+	}
+
+	REQUIRE(whole.get_write_pos() == chunked.get_write_pos());
+	REQUIRE(whole.get_hash() == chunked.get_hash());
+
+	augs::hashing_stream altered;
+	bytes[500] ^= std::byte(1);
+	altered.write(bytes.data(), bytes.size());
+
+	REQUIRE(whole.get_hash() != altered.get_hash());
+
+	augs::hashing_stream shorter;
+	shorter.write(bytes.data(), bytes.size() - 1);
+
+	REQUIRE(whole.get_hash() != shorter.get_hash());
+}
 #endif
 #endif
\ No newline at end of file
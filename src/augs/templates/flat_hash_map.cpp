@@ -0,0 +1,117 @@
+#if BUILD_UNIT_TESTS
+#include <map>
+#include <random>
+#include <string>
+#include <Catch/single_include/catch2/catch.hpp>
+#include "augs/templates/flat_hash_map.h"
+#include "augs/templates/container_templates.h"
+
+TEST_CASE("FlatHashMap MatchesStdMap") {
+	augs::flat_hash_map<unsigned, std::string> flat;
+	std::map<unsigned, std::string> reference;
+
+	auto rng = std::mt19937(1234);
+
+	for (int i = 0; i < 20000; ++i) {
+		/* A small key range makes for long clusters and frequent erasures. */
+		const auto key = static_cast<unsigned>(rng() % 512);
+
+		if (rng() % 3 == 0) {
+			REQUIRE(flat.erase(key) == reference.erase(key));
+		}
+		else {
+			const auto value = std::to_string(i);
+			flat[key] = value;
+			reference[key] = value;
+		}
+
+		REQUIRE(flat.size() == reference.size());
+	}
+
+	for (const auto& r : reference) {
+		REQUIRE(flat.at(r.first) == r.second);
+	}
+
+	std::size_t iterated = 0;
+
+	for (const auto& e : flat) {
+		REQUIRE(reference.at(e.first) == e.second);
+		++iterated;
+	}
+
+	REQUIRE(iterated == reference.size());
+
+	const auto copied = flat;
+	REQUIRE(copied.size() == flat.size());
+	REQUIRE(mapped_or_nullptr(copied, 600u) == nullptr);
+
+	flat.clear();
+	REQUIRE(flat.empty());
+	REQUIRE(flat.begin() == flat.end());
+	REQUIRE(copied.size() == reference.size());
+}
+
+TEST_CASE("FlatHashMap SetAndEmplace") {
+	augs::flat_hash_set<int> s;
+
+	REQUIRE(s.emplace(3).second);
+	REQUIRE(!s.emplace(3).second);
+	REQUIRE(s.count(3) == 1);
+	REQUIRE(found_in(s, 3));
+	REQUIRE(erase_element(s, 3));
+	REQUIRE(!found_in(s, 3));
+
+	augs::flat_hash_map<int, int> m;
+	m.reserve(100);
+
+	REQUIRE(m.try_emplace(1, 10).second);
+	REQUIRE(!m.try_emplace(1, 20).second);
+	REQUIRE(*mapped_or_nullptr(m, 1) == 10);
+}
+
+TEST_CASE("FlatHashMap ExistingKeyKeepsReferences") {
+	augs::flat_hash_map<int, int> m;
+
+	/* 
+		The minimum capacity is 8 at a maximum load of 3/4,
+		so with 6 entries any further insertion grows the table.
+	*/
+
+	for (int i = 0; i < 6; ++i) {
+		m[i] = i;
+	}
+
+	REQUIRE(m.size() == 6);
+
+	auto& held = m[0];
+	const auto* const held_address = std::addressof(held);
+
+	for (int i = 0; i < 6; ++i) {
+		REQUIRE(m[i] == i);
+		m.try_emplace(i, -1);
+		m.emplace(i, -1);
+	}
+
+	REQUIRE(std::addressof(m[0]) == held_address);
+	REQUIRE(held == 0);
+
+	held = 42;
+	REQUIRE(m.at(0) == 42);
+
+	/* A new key past the threshold still grows the table and keeps the contents. */
+	m[6] = 6;
+
+	REQUIRE(m.size() == 7);
+	REQUIRE(m.at(0) == 42);
+
+	augs::flat_hash_set<int> s;
+
+	for (int i = 0; i < 6; ++i) {
+		s.emplace(i);
+	}
+
+	const auto* const held_key = std::addressof(*s.find(3));
+	REQUIRE(!s.emplace(3).second);
+	REQUIRE(std::addressof(*s.find(3)) == held_key);
+}
+#endif
@@ -0,0 +1,414 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <functional>
+#include <type_traits>
+
+/*
+	Open addressing hash map and set with linear probing.
+
+	All entries live in a single contiguous vector, with a parallel vector of occupancy flags.
+	Unoccupied slots hold default-constructed entries, so keys and values must be default-constructible.
+	Erasing shifts the following entries of the cluster back, so there are no tombstones.
+
+	Copying is two vector copies, which reduces to memcpy whenever both the key and the value are trivially copyable.
+	This makes it a good fit for caches that are rebuilt or copied in bulk.
+
+	Unlike std::unordered_map:
+	- inserting a new key or erasing any invalidates all iterators and references,
+	  but operator[], try_emplace and emplace on a key that is already present never do,
+	- there is no erase by iterator - erase by key instead.
+*/
+
+namespace augs {
+	template <class K, class V>
+	struct flat_hash_map_entry {
+		K first = K();
+		V second = V();
+	};
+
+	namespace detail {
+		template <class K, class V>
+		struct flat_map_traits {
+			using entry_type = flat_hash_map_entry<K, V>;
+			static constexpr bool mutable_entries = true;
+
+			static const K& key_of(const entry_type& e) {
+				return e.first;
+			}
+
+			static entry_type make_entry(const K& key) {
+				return { key, V() };
+			}
+		};
+
+		template <class K>
+		struct flat_set_traits {
+			using entry_type = K;
+			static constexpr bool mutable_entries = false;
+
+			static const K& key_of(const entry_type& e) {
+				return e;
+			}
+
+			static entry_type make_entry(const K& key) {
+				return key;
+			}
+		};
+
+		template <class K, class Traits, class Hash>
+		class flat_hash_table {
+		public:
+			using key_type = K;
+			using value_type = typename Traits::entry_type;
+			using size_type = std::size_t;
+
+		protected:
+			/* Keep the load below 3/4 so that clusters stay short. */
+			static constexpr std::size_t max_load_num = 3;
+			static constexpr std::size_t max_load_den = 4;
+			static constexpr std::size_t min_capacity = 8;
+
+			std::vector<value_type> entries;
+			std::vector<uint8_t> occupied;
+			std::size_t num_entries = 0;
+			unsigned shift = 64;
+
+			std::size_t capacity() const {
+				return entries.size();
+			}
+
+			std::size_t mask() const {
+				return capacity() - 1;
+			}
+
+			std::size_t home_of(const K& key) const {
+				/* Fibonacci hashing, so that sequential ids do not end up in a single cluster. */
+				const auto h = static_cast<uint64_t>(Hash()(key)) * 0x9E3779B97F4A7C15ull;
+				return static_cast<std::size_t>(h >> shift);
+			}
+
+			std::size_t find_index(const K& key) const {
+				if (num_entries == 0) {
+					return capacity();
+				}
+
+				for (auto i = home_of(key); occupied[i]; i = (i + 1) & mask()) {
+					if (Traits::key_of(entries[i]) == key) {
+						return i;
+					}
+				}
+
+				return capacity();
+			}
+
+			void rehash(const std::size_t new_capacity) {
+				auto old_entries = std::move(entries);
+				auto old_occupied = std::move(occupied);
+
+				entries.clear();
+				entries.resize(new_capacity);
+				occupied.assign(new_capacity, 0);
+
+				shift = 64;
+
+				for (auto c = new_capacity; c > 1; c >>= 1) {
+					--shift;
+				}
+
+				for (std::size_t i = 0; i < old_entries.size(); ++i) {
+					if (old_occupied[i]) {
+						auto j = home_of(Traits::key_of(old_entries[i]));
+
+						while (occupied[j]) {
+							j = (j + 1) & mask();
+						}
+
+						entries[j] = std::move(old_entries[i]);
+						occupied[j] = 1;
+					}
+				}
+			}
+
+			static std::size_t capacity_for(const std::size_t n) {
+				auto result = min_capacity;
+
+				while (result * max_load_num < n * max_load_den) {
+					result *= 2;
+				}
+
+				return result;
+			}
+
+			/* 
+				Returns the slot of the key and whether it was inserted.
+				The table only grows when the key is actually inserted,
+				so finding an existing key never moves any entries.
+			*/
+			std::pair<std::size_t, bool> find_or_insert_slot(const K& key) {
+				if (const auto found = find_index(key); found != capacity()) {
+					return { found, false };
+				}
+
+				if ((num_entries + 1) * max_load_den > capacity() * max_load_num) {
+					rehash(capacity_for(num_entries + 1));
+				}
+
+				auto i = home_of(key);
+
+				while (occupied[i]) {
+					i = (i + 1) & mask();
+				}
+
+				entries[i] = Traits::make_entry(key);
+				occupied[i] = 1;
+				++num_entries;
+
+				return { i, true };
+			}
+
+			template <bool is_const>
+			class basic_iterator {
+				friend class flat_hash_table;
+
+				template <bool>
+				friend class basic_iterator;
+
+				using table_type = std::conditional_t<is_const, const flat_hash_table, flat_hash_table>;
+
+				table_type* table = nullptr;
+				std::size_t i = 0;
+
+				void skip_unoccupied() {
+					while (i < table->capacity() && !table->occupied[i]) {
+						++i;
+					}
+				}
+
+				basic_iterator(table_type* const table, const std::size_t i) : table(table), i(i) {
+					skip_unoccupied();
+				}
+
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = typename flat_hash_table::value_type;
+				using difference_type = std::ptrdiff_t;
+				using pointer = std::conditional_t<is_const || !Traits::mutable_entries, const value_type*, value_type*>;
+				using reference = std::conditional_t<is_const || !Traits::mutable_entries, const value_type&, value_type&>;
+
+				basic_iterator() = default;
+
+				operator basic_iterator<true>() const {
+					return basic_iterator<true>(table, i);
+				}
+
+				reference operator*() const {
+					return table->entries[i];
+				}
+
+				pointer operator->() const {
+					return std::addressof(table->entries[i]);
+				}
+
+				basic_iterator& operator++() {
+					++i;
+					skip_unoccupied();
+					return *this;
+				}
+
+				basic_iterator operator++(int) {
+					auto self = *this;
+					++*this;
+					return self;
+				}
+
+				bool operator==(const basic_iterator& b) const {
+					return i == b.i;
+				}
+
+				bool operator!=(const basic_iterator& b) const {
+					return i != b.i;
+				}
+			};
+
+		public:
+			using iterator = basic_iterator<false>;
+			using const_iterator = basic_iterator<true>;
+
+		protected:
+			iterator iterator_at(const std::size_t i) {
+				return { this, i };
+			}
+
+		public:
+			iterator begin() {
+				return { this, 0 };
+			}
+
+			iterator end() {
+				return { this, capacity() };
+			}
+
+			const_iterator begin() const {
+				return { this, 0 };
+			}
+
+			const_iterator end() const {
+				return { this, capacity() };
+			}
+
+			iterator find(const K& key) {
+				return { this, find_index(key) };
+			}
+
+			const_iterator find(const K& key) const {
+				return { this, find_index(key) };
+			}
+
+			std::size_t count_of(const K& key) const {
+				return find_index(key) != capacity() ? 1 : 0;
+			}
+
+			std::size_t erase(const K& key) {
+				auto hole = find_index(key);
+
+				if (hole == capacity()) {
+					return 0;
+				}
+
+				/* Shift back every following entry of the cluster that would otherwise become unreachable. */
+
+				for (auto j = (hole + 1) & mask(); occupied[j]; j = (j + 1) & mask()) {
+					const auto home = home_of(Traits::key_of(entries[j]));
+
+					const bool stays = hole <= j
+						? (hole < home && home <= j)
+						: (hole < home || home <= j)
+					;
+
+					if (!stays) {
+						entries[hole] = std::move(entries[j]);
+						hole = j;
+					}
+				}
+
+				entries[hole] = value_type();
+				occupied[hole] = 0;
+				--num_entries;
+
+				return 1;
+			}
+
+			void reserve(const std::size_t n) {
+				if (n * max_load_den > capacity() * max_load_num) {
+					rehash(capacity_for(n));
+				}
+			}
+
+			void clear() {
+				if (num_entries == 0) {
+					return;
+				}
+
+				if constexpr(!std::is_trivially_destructible_v<value_type>) {
+					for (std::size_t i = 0; i < capacity(); ++i) {
+						if (occupied[i]) {
+							entries[i] = value_type();
+						}
+					}
+				}
+
+				std::fill(occupied.begin(), occupied.end(), uint8_t(0));
+				num_entries = 0;
+			}
+
+			std::size_t size() const {
+				return num_entries;
+			}
+
+			bool empty() const {
+				return num_entries == 0;
+			}
+		};
+	}
+
+	template <class K, class V, class Hash = std::hash<K>>
+	class flat_hash_map : public detail::flat_hash_table<K, detail::flat_map_traits<K, V>, Hash> {
+		using base = detail::flat_hash_table<K, detail::flat_map_traits<K, V>, Hash>;
+
+	public:
+		using mapped_type = V;
+		using typename base::iterator;
+		using typename base::const_iterator;
+
+		V& operator[](const K& key) {
+			return this->entries[this->find_or_insert_slot(key).first].second;
+		}
+
+		template <class... Args>
+		std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+			const auto result = this->find_or_insert_slot(key);
+
+			if (result.second) {
+				this->entries[result.first].second = V(std::forward<Args>(args)...);
+			}
+
+			return { this->iterator_at(result.first), result.second };
+		}
+
+		template <class... Args>
+		std::pair<iterator, bool> emplace(const K& key, Args&&... args) {
+			return try_emplace(key, std::forward<Args>(args)...);
+		}
+
+		V& at(const K& key) {
+			const auto it = this->find(key);
+
+			if (it == this->end()) {
+				throw std::out_of_range("flat_hash_map::at");
+			}
+
+			return it->second;
+		}
+
+		const V& at(const K& key) const {
+			const auto it = this->find(key);
+
+			if (it == this->end()) {
+				throw std::out_of_range("flat_hash_map::at");
+			}
+
+			return it->second;
+		}
+
+		std::size_t count(const K& key) const {
+			return this->count_of(key);
+		}
+	};
+
+	template <class K, class Hash = std::hash<K>>
+	class flat_hash_set : public detail::flat_hash_table<K, detail::flat_set_traits<K>, Hash> {
+		using base = detail::flat_hash_table<K, detail::flat_set_traits<K>, Hash>;
+
+	public:
+		using typename base::iterator;
+		using typename base::const_iterator;
+
+		std::pair<iterator, bool> emplace(const K& key) {
+			const auto result = this->find_or_insert_slot(key);
+			return { this->iterator_at(result.first), result.second };
+		}
+
+		std::pair<iterator, bool> insert(const K& key) {
+			return emplace(key);
+		}
+
+		std::size_t count(const K& key) const {
+			return this->count_of(key);
+		}
+	};
+}
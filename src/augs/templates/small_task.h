@@ -0,0 +1,131 @@
+#pragma once
+#include <new>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+
+namespace augs {
+	/*
+		A move-only, type-erased void() callable.
+
+		Unlike std::function, it keeps callables of up to inline_capacity bytes
+		directly inside the object, so enqueuing a typical lambda does not allocate.
+		Bigger callables fall back to the heap.
+	*/
+
+	class small_task {
+	public:
+		static constexpr std::size_t inline_capacity = 96;
+
+	private:
+		struct operations {
+			void (*call)(void* storage);
+			void (*move_to)(void* from, void* to);
+			void (*destroy)(void* storage);
+		};
+
+		template <class F>
+		static constexpr bool stored_inline_v =
+			sizeof(F) <= inline_capacity
+			&& alignof(F) <= alignof(std::max_align_t)
+			&& std::is_nothrow_move_constructible_v<F>
+		;
+
+		template <class F>
+		struct inline_operations {
+			static F& get(void* storage) {
+				return *std::launder(reinterpret_cast<F*>(storage));
+			}
+
+			static constexpr operations value = {
+				[](void* storage) { get(storage)(); },
+				[](void* from, void* to) {
+					::new (to) F(std::move(get(from)));
+					get(from).~F();
+				},
+				[](void* storage) { get(storage).~F(); }
+			};
+		};
+
+		template <class F>
+		struct heap_operations {
+			static F*& get(void* storage) {
+				return *std::launder(reinterpret_cast<F**>(storage));
+			}
+
+			static constexpr operations value = {
+				[](void* storage) { (*get(storage))(); },
+				[](void* from, void* to) {
+					::new (to) F*(get(from));
+				},
+				[](void* storage) { delete get(storage); }
+			};
+		};
+
+		alignas(std::max_align_t) std::byte storage[inline_capacity];
+		const operations* ops = nullptr;
+
+		void reset() {
+			if (ops != nullptr) {
+				ops->destroy(storage);
+				ops = nullptr;
+			}
+		}
+
+	public:
+		small_task() = default;
+
+		template <
+			class F,
+			class D = std::decay_t<F>,
+			class = std::enable_if_t<!std::is_same_v<D, small_task>>
+		>
+		small_task(F&& f) {
+			if constexpr(stored_inline_v<D>) {
+				::new (static_cast<void*>(storage)) D(std::forward<F>(f));
+				ops = &inline_operations<D>::value;
+			}
+			else {
+				::new (static_cast<void*>(storage)) D*(new D(std::forward<F>(f)));
+				ops = &heap_operations<D>::value;
+			}
+		}
+
+		small_task(small_task&& b) noexcept : ops(b.ops) {
+			if (ops != nullptr) {
+				ops->move_to(b.storage, storage);
+				b.ops = nullptr;
+			}
+		}
+
+		small_task& operator=(small_task&& b) noexcept {
+			if (this != &b) {
+				reset();
+
+				ops = b.ops;
+
+				if (ops != nullptr) {
+					ops->move_to(b.storage, storage);
+					b.ops = nullptr;
+				}
+			}
+
+			return *this;
+		}
+
+		small_task(const small_task&) = delete;
+		small_task& operator=(const small_task&) = delete;
+
+		~small_task() {
+			reset();
+		}
+
+		void operator()() {
+			ops->call(storage);
+		}
+
+		explicit operator bool() const {
+			return ops != nullptr;
+		}
+	};
+}
@@ -0,0 +1,191 @@
+#if BUILD_UNIT_TESTS
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <Catch/single_include/catch2/catch.hpp>
+#include "augs/templates/thread_pool.h"
+
+TEST_CASE("ThreadPool SubmittedBatchCompletes") {
+	augs::thread_pool pool(3);
+
+	std::array<int, 1000> results = {};
+
+	for (int round = 0; round < 10; ++round) {
+		for (int i = 0; i < static_cast<int>(results.size()); ++i) {
+			pool.enqueue([&results, i, round]() { results[i] = i * round; });
+		}
+
+		pool.submit();
+		pool.help_until_no_tasks();
+		pool.wait_for_all_tasks_to_complete();
+
+		for (int i = 0; i < static_cast<int>(results.size()); ++i) {
+			REQUIRE(results[i] == i * round);
+		}
+	}
+}
+
+TEST_CASE("ThreadPool NoWorkers") {
+	augs::thread_pool pool(0);
+
+	int sum = 0;
+
+	for (int i = 1; i <= 10; ++i) {
+		pool.enqueue([&sum, i]() { sum += i; });
+	}
+
+	pool.submit();
+	pool.help_until_no_tasks();
+	pool.wait_for_all_tasks_to_complete();
+
+	REQUIRE(sum == 55);
+}
+
+TEST_CASE("ThreadPool TaskGroupForkJoin") {
+	augs::thread_pool pool(3);
+
+	std::atomic<int> leaves = 0;
+
+	pool.enqueue([&]() {
+		augs::task_group outer(pool);
+
+		for (int i = 0; i < 8; ++i) {
+			outer.run([&]() {
+				augs::task_group inner(pool);
+
+				for (int j = 0; j < 8; ++j) {
+					inner.run([&]() { leaves.fetch_add(1); });
+				}
+			});
+		}
+	});
+
+	pool.submit();
+	pool.help_until_no_tasks();
+	pool.wait_for_all_tasks_to_complete();
+
+	REQUIRE(leaves.load() == 64);
+}
+
+TEST_CASE("ThreadPool OverlappingSubmissions") {
+	augs::thread_pool pool(3);
+
+	std::atomic<int> sum = 0;
+
+	for (int i = 0; i < 100; ++i) {
+		pool.enqueue([&sum]() { sum.fetch_add(1); });
+	}
+
+	pool.submit();
+
+	for (int i = 0; i < 100; ++i) {
+		pool.enqueue([&sum]() { sum.fetch_add(10); });
+	}
+
+	/* The first batch might still be running. */
+	pool.submit();
+
+	pool.help_until_no_tasks();
+	pool.wait_for_all_tasks_to_complete();
+
+	REQUIRE(sum.load() == 100 + 1000);
+}
+
+TEST_CASE("ThreadPool NestedSubmission") {
+	augs::thread_pool pool(2);
+
+	std::atomic<int> nested = 0;
+
+	pool.enqueue([&]() {
+		for (int i = 0; i < 50; ++i) {
+			pool.enqueue([&nested]() { nested.fetch_add(1); });
+		}
+
+		pool.submit();
+	});
+
+	pool.submit();
+	pool.help_until_no_tasks();
+	pool.wait_for_all_tasks_to_complete();
+
+	REQUIRE(nested.load() == 50);
+}
+
+TEST_CASE("ThreadPool ReclaimsOutgrownRings") {
+	augs::thread_pool pool(2);
+
+	const auto initial_rings = pool.num_retained_rings();
+
+	std::atomic<int> count = 0;
+
+	/* Way more than fits in a single ring of any deque. */
+
+	for (int i = 0; i < 5000; ++i) {
+		pool.enqueue([&count]() { count.fetch_add(1); });
+	}
+
+	pool.submit();
+	pool.help_until_no_tasks();
+	pool.wait_for_all_tasks_to_complete();
+
+	REQUIRE(count.load() == 5000);
+
+	/* A thief could in theory still be reading, but it can only delay the reclamation. */
+
+	for (int attempt = 0; attempt < 1000 && pool.num_retained_rings() != initial_rings; ++attempt) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+		pool.submit();
+		pool.wait_for_all_tasks_to_complete();
+	}
+
+	REQUIRE(pool.num_retained_rings() == initial_rings);
+}
+
+TEST_CASE("ThreadPool ConcurrentTaskGroupRun") {
+	augs::thread_pool pool(3);
+
+	std::atomic<int> leaves = 0;
+
+	{
+		augs::task_group group(pool);
+
+		for (int i = 0; i < 8; ++i) {
+			pool.enqueue([&]() {
+				for (int j = 0; j < 100; ++j) {
+					group.run([&]() { leaves.fetch_add(1); });
+				}
+			});
+		}
+
+		pool.submit();
+		pool.help_until_no_tasks();
+		pool.wait_for_all_tasks_to_complete();
+	}
+
+	REQUIRE(leaves.load() == 800);
+}
+
+TEST_CASE("ThreadPool SmallTaskStorage") {
+	int calls = 0;
+
+	augs::small_task small = [&calls]() { ++calls; };
+
+	std::array<char, 2 * augs::small_task::inline_capacity> big_capture = {};
+	big_capture.back() = 1;
+
+	augs::small_task big = [&calls, big_capture]() { calls += big_capture.back(); };
+
+	auto moved_small = std::move(small);
+	auto moved_big = std::move(big);
+
+	REQUIRE(!small);
+	REQUIRE(!big);
+
+	moved_small();
+	moved_big();
+
+	REQUIRE(calls == 2);
+}
+#endif
@@ -1,66 +1,427 @@
 #pragma once
+#include <deque>
 #include <vector>
+#include <memory>
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <cstdint>
+#include <algorithm>
 #include <condition_variable>
-#include <functional>
+
+#include "augs/templates/small_task.h"
 
 namespace augs {
+	class thread_pool;
+	class task_group;
+
+	namespace detail {
+		struct pool_job {
+			small_task task;
+			std::atomic<int>* remaining = nullptr;
+
+			template <class F>
+			pool_job(F&& f, std::atomic<int>* remaining) : task(std::forward<F>(f)), remaining(remaining) {}
+		};
+
+		/*
+			Chase-Lev deque.
+			Only the owning thread pushes and pops at the bottom,
+			any other thread can steal from the top without taking a lock.
+		*/
+
+		class work_stealing_deque {
+			struct ring {
+				const std::size_t capacity;
+				std::unique_ptr<std::atomic<pool_job*>[]> slots;
+
+				explicit ring(const std::size_t capacity) : capacity(capacity), slots(new std::atomic<pool_job*>[capacity]) {}
+
+				auto& at(const int64_t i) {
+					return slots[static_cast<std::size_t>(i) & (capacity - 1)];
+				}
+			};
+
+			alignas(64) std::atomic<int64_t> top = 0;
+			alignas(64) std::atomic<int64_t> bottom = 0;
+			std::atomic<ring*> buffer;
+
+			/* Thieves that might be reading a slot right now, possibly from an outgrown ring. */
+			std::atomic<int> num_reading_thieves = 0;
+
+			/*
+				Outgrown rings are kept alive until reclaim_outgrown_rings,
+				because a thief might still be reading from one.
+			*/
+
+			std::vector<std::unique_ptr<ring>> rings;
+
+			ring* grow(ring* const old, const int64_t t, const int64_t b) {
+				auto bigger = std::make_unique<ring>(old->capacity * 2);
+
+				for (auto i = t; i < b; ++i) {
+					bigger->at(i).store(old->at(i).load(std::memory_order_relaxed), std::memory_order_relaxed);
+				}
+
+				auto* const result = bigger.get();
+				rings.emplace_back(std::move(bigger));
+				buffer.store(result, std::memory_order_release);
+
+				return result;
+			}
+
+		public:
+			work_stealing_deque(const std::size_t initial_capacity = 256) {
+				rings.emplace_back(std::make_unique<ring>(initial_capacity));
+				buffer.store(rings.back().get(), std::memory_order_relaxed);
+			}
+
+			void push(pool_job* const job) {
+				const auto b = bottom.load(std::memory_order_relaxed);
+				const auto t = top.load(std::memory_order_acquire);
+
+				auto* r = buffer.load(std::memory_order_relaxed);
+
+				if (b - t >= static_cast<int64_t>(r->capacity)) {
+					r = grow(r, t, b);
+				}
+
+				r->at(b).store(job, std::memory_order_relaxed);
+				bottom.store(b + 1, std::memory_order_release);
+			}
+
+			pool_job* pop() {
+				const auto b = bottom.load(std::memory_order_relaxed) - 1;
+				auto* const r = buffer.load(std::memory_order_relaxed);
+
+				/* Sequentially consistent so that a concurrent thief either sees the new bottom or we see its top. */
+
+				bottom.store(b, std::memory_order_seq_cst);
+				auto t = top.load(std::memory_order_seq_cst);
+
+				if (t <= b) {
+					auto* job = r->at(b).load(std::memory_order_relaxed);
+
+					if (t == b) {
+						/* Last one - race against the thieves. */
+
+						if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+							job = nullptr;
+						}
+
+						bottom.store(b + 1, std::memory_order_relaxed);
+					}
+
+					return job;
+				}
+
+				bottom.store(b + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			pool_job* steal() {
+				auto t = top.load(std::memory_order_seq_cst);
+				const auto b = bottom.load(std::memory_order_seq_cst);
+
+				if (t < b) {
+					num_reading_thieves.fetch_add(1, std::memory_order_seq_cst);
+
+					auto* const r = buffer.load(std::memory_order_acquire);
+					auto* const job = r->at(t).load(std::memory_order_relaxed);
+
+					num_reading_thieves.fetch_sub(1, std::memory_order_release);
+
+					if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+						return nullptr;
+					}
+
+					return job;
+				}
+
+				return nullptr;
+			}
+
+			bool empty() const {
+				return bottom.load(std::memory_order_acquire) <= top.load(std::memory_order_acquire);
+			}
+
+			/*
+				Frees every ring but the current one.
+				Only call when nothing can be pushed concurrently.
+				Returns false if a thief was still reading, in which case nothing is freed.
+			*/
+
+			bool reclaim_outgrown_rings() {
+				if (rings.size() == 1) {
+					return true;
+				}
+
+				if (num_reading_thieves.load(std::memory_order_seq_cst) != 0) {
+					return false;
+				}
+
+				auto* const current = buffer.load(std::memory_order_relaxed);
+
+				rings.erase(
+					std::remove_if(rings.begin(), rings.end(), [current](const auto& r) { return r.get() != current; }),
+					rings.end()
+				);
+
+				return true;
+			}
+
+			std::size_t num_rings() const {
+				return rings.size();
+			}
+		};
+	}
+
+	/*
+		Work-stealing thread pool.
+
+		Tasks are enqueued and then published all at once with submit().
+		Both can be called from any thread, including from within a running task,
+		and a submission does not have to wait until the previous ones complete.
+		wait_for_all_tasks_to_complete() waits for everything submitted so far,
+		so it must not be called from within a task - use a task_group there.
+
+		Every worker has its own deque; an idle worker steals from the others.
+		Other threads can join in with help_until_no_tasks().
+
+		task_group allows tasks to fork further tasks and join on them.
+	*/
+
 	class thread_pool {
+		friend task_group;
+
+		using job_type = detail::pool_job;
+		using deque_type = detail::work_stealing_deque;
+
+		struct worker_identity {
+			const thread_pool* pool = nullptr;
+			std::size_t deque_index = 0;
+		};
+
+		static worker_identity& this_thread_identity() {
+			thread_local worker_identity identity;
+			return identity;
+		}
+
 		std::vector<std::thread> workers;
-		std::vector<std::function<void()>> tasks;
-		std::vector<std::function<void()>> cold_tasks;
 
-		int tasks_completed = 0;
+		/*
+			Deque 0 takes the jobs from threads other than the workers.
+			Pushes to it are serialized by submission_mutex and nobody pops from it - everyone steals.
+			Deque i + 1 belongs to the i-th worker.
+		*/
+
+		std::vector<std::unique_ptr<deque_type>> deques;
+
+		std::mutex submission_mutex;
+
+		std::vector<job_type> cold_tasks;
+
+		/*
+			Submitted jobs must stay in place until they are executed,
+			so their storage is only recycled once no job is in flight.
+		*/
+
+		std::vector<std::vector<job_type>> posted_batches;
+		std::vector<std::vector<job_type>> spare_batches;
+
+		/* Submitted tasks that have not completed yet. */
+		std::atomic<int> tasks_remaining = 0;
 		int tasks_posted = 0;
 
-		std::mutex queue_mutex;
+		/* Every pushed job that has not completed yet, including the ones forked by task groups. */
+		std::atomic<int> jobs_in_flight = 0;
+
+		std::mutex sleep_mutex;
 		std::condition_variable cv;
+		std::atomic<uint64_t> work_epoch = 0;
+		std::atomic<int> num_sleeping = 0;
 
 		std::condition_variable completion_variable;
 		std::mutex completion_mutex;
 
 		std::atomic<bool> shall_quit = false;
 
-		auto lock_queue() {
-			return std::unique_lock<std::mutex>(queue_mutex);
+		auto lock_sleep() {
+			return std::unique_lock<std::mutex>(sleep_mutex);
 		}
 
 		auto lock_completion() {
 			return std::unique_lock<std::mutex>(completion_mutex);
 		}
 
-		void register_completion() {
-			{
-				auto lock = lock_completion();
-				++tasks_completed;
+		auto lock_submission() {
+			return std::unique_lock<std::mutex>(submission_mutex);
+		}
+
+		deque_type* find_own_deque() {
+			const auto& identity = this_thread_identity();
+
+			if (identity.pool == this) {
+				return deques[identity.deque_index].get();
+			}
+
+			return nullptr;
+		}
+
+		/*
+			Call with submission_mutex locked.
+			With no job in flight nothing can be pushed concurrently:
+			workers only push from within a job and everyone else pushes under the lock.
+		*/
+
+		void reclaim_if_quiescent() {
+			if (jobs_in_flight.load(std::memory_order_seq_cst) != 0) {
+				return;
+			}
+
+			for (auto& b : posted_batches) {
+				b.clear();
+				spare_batches.emplace_back(std::move(b));
+			}
+
+			posted_batches.clear();
+
+			for (auto& d : deques) {
+				d->reclaim_outgrown_rings();
+			}
+		}
+
+		job_type* find_job(deque_type* const own, const std::size_t first_victim) {
+			if (own != nullptr) {
+				if (const auto job = own->pop()) {
+					return job;
+				}
+			}
+
+			const auto n = deques.size();
+
+			for (;;) {
+				bool any_left = false;
+
+				for (std::size_t i = 0; i < n; ++i) {
+					auto& victim = *deques[(first_victim + i) % n];
+
+					if (&victim == own) {
+						continue;
+					}
 
-				if (tasks_completed == tasks_posted) {
-					completion_variable.notify_all();
+					if (const auto job = victim.steal()) {
+						return job;
+					}
+
+					if (!victim.empty()) {
+						/* Lost a race with another thief. */
+						any_left = true;
+					}
 				}
+
+				if (!any_left) {
+					return nullptr;
+				}
+			}
+		}
+
+		job_type* find_job_for_this_thread() {
+			const auto& identity = this_thread_identity();
+			const auto first_victim = identity.pool == this ? identity.deque_index : 0;
+
+			return find_job(find_own_deque(), first_victim);
+		}
+
+		void execute(job_type& job) {
+			auto* const remaining = job.remaining;
+
+			job.task();
+
+			/* The job might not exist anymore after either decrement. */
+
+			jobs_in_flight.fetch_sub(1, std::memory_order_acq_rel);
+
+			if (remaining->fetch_sub(1, std::memory_order_acq_rel) == 1 && remaining == &tasks_remaining) {
+				auto lock = lock_completion();
+				completion_variable.notify_all();
+			}
+		}
+
+		void wake_all_workers() {
+			{
+				auto lock = lock_sleep();
+				work_epoch.fetch_add(1);
+			}
+
+			cv.notify_all();
+		}
+
+		void wake_one_worker() {
+			/*
+				A worker that is about to sleep re-checks the epoch under the lock,
+				so the lock is only needed when somebody actually sleeps.
+			*/
+
+			work_epoch.fetch_add(1);
+
+			if (num_sleeping.load() == 0) {
+				return;
+			}
+
+			{
+				auto lock = lock_sleep();
+			}
+
+			cv.notify_one();
+		}
+
+		void spawn(job_type& job) {
+			jobs_in_flight.fetch_add(1, std::memory_order_seq_cst);
+
+			if (const auto own = find_own_deque()) {
+				own->push(std::addressof(job));
+			}
+			else {
+				auto lock = lock_submission();
+				deques[0]->push(std::addressof(job));
 			}
+
+			wake_one_worker();
+		}
+
+		bool help_once() {
+			if (const auto job = find_job_for_this_thread()) {
+				execute(*job);
+				return true;
+			}
+
+			return false;
 		}
 
-		auto make_continuous_worker() {
-			return [this] {
+		auto make_continuous_worker(const std::size_t deque_index) {
+			return [this, deque_index] {
+				this_thread_identity() = { this, deque_index };
+
+				auto* const own = deques[deque_index].get();
+
 				for (;;) {
-					std::function<void()> task;
+					const auto seen_epoch = work_epoch.load();
 
-					{
-						auto lock = lock_queue();
-						cv.wait(lock, [this]{ return shall_quit || !tasks.empty(); });
+					if (const auto job = find_job(own, deque_index)) {
+						execute(*job);
+						continue;
+					}
 
-						if (shall_quit.load() && tasks.empty()) {
-							return;
-						}
+					auto lock = lock_sleep();
 
-						task = std::move(tasks.back());
-						tasks.pop_back();
+					if (shall_quit.load()) {
+						return;
 					}
 
-					task();
-					register_completion();
+					num_sleeping.fetch_add(1);
+					cv.wait(lock, [this, seen_epoch]{ return shall_quit.load() || work_epoch.load() != seen_epoch; });
+					num_sleeping.fetch_sub(1);
 				}
 			};
 		}
@@ -76,7 +437,11 @@ namespace augs {
 				return;
 			}
 
-			shall_quit.store(true);
+			{
+				auto lock = lock_sleep();
+				shall_quit.store(true);
+			}
+
 			cv.notify_all();
 			join_all();
 			workers.clear();
@@ -91,36 +456,62 @@ namespace augs {
 			quit_all_workers();
 		}
 
+		/* Only call when no tasks are pending. */
+
 		void resize(const std::size_t num_workers) {
 			quit_all_workers();
 			shall_quit.store(false);
 
+			deques.clear();
+
+			for (std::size_t i = 0; i < num_workers + 1; ++i) {
+				deques.emplace_back(std::make_unique<deque_type>());
+			}
+
 			for (std::size_t i = 0; i < num_workers; ++i) {
-				workers.emplace_back(make_continuous_worker());
+				workers.emplace_back(make_continuous_worker(i + 1));
 			}
 		}
 
 		template <class F>
 		void enqueue(F&& f) {
-			cold_tasks.emplace_back(std::move(f));
+			auto lock = lock_submission();
+			cold_tasks.emplace_back(std::move(f), &tasks_remaining);
 		}
 
 		void submit() {
 			{
-				auto lock = lock_queue();
-				ensure(tasks.empty());
-				std::swap(cold_tasks, tasks);
+				auto lock = lock_submission();
+
+				reclaim_if_quiescent();
+
+				auto& batch = posted_batches.emplace_back(std::move(cold_tasks));
+				cold_tasks.clear();
+
+				if (!spare_batches.empty()) {
+					cold_tasks = std::move(spare_batches.back());
+					spare_batches.pop_back();
+				}
+
+				const auto n = static_cast<int>(batch.size());
 
 				{
-					auto lock = lock_completion();
-					tasks_completed = 0;
-					tasks_posted = tasks.size();
+					auto completion_lock = lock_completion();
+					tasks_remaining.fetch_add(n);
+					tasks_posted = n;
+				}
+
+				jobs_in_flight.fetch_add(n, std::memory_order_seq_cst);
+
+				auto& injected = *deques[0];
+
+				for (auto& t : batch) {
+					injected.push(std::addressof(t));
 				}
 			}
 
-			cold_tasks.clear();
 			completion_variable.notify_all();
-			cv.notify_all();
+			wake_all_workers();
 		}
 
 		std::size_t size() const {
@@ -133,29 +524,76 @@ namespace augs {
 		}
 
 		void help_until_no_tasks() {
-			for (;;) {
-				std::function<void()> task;
+			while (help_once()) {}
+		}
 
-				{
-					auto lock = lock_queue();
+		void wait_for_all_tasks_to_complete() {
+			{
+				auto lock = lock_completion();
+				completion_variable.wait(lock, [this]{ return tasks_remaining.load() == 0; });
+			}
 
-					if (tasks.empty()) {
-						return;
-					}
+			auto lock = lock_submission();
+			reclaim_if_quiescent();
+		}
 
-					task = std::move(tasks.back());
-					tasks.pop_back();
-				}
+		std::size_t num_retained_rings() {
+			auto lock = lock_submission();
+
+			std::size_t total = 0;
 
-				task();
-				register_completion();
+			for (const auto& d : deques) {
+				total += d->num_rings();
 			}
+
+			return total;
 		}
+	};
 
-		void wait_for_all_tasks_to_complete() {
-			auto lock = lock_completion();
-			completion_variable.wait(lock, [this]{ return tasks_posted == tasks_completed; });
+	/*
+		Fork-join on top of a thread_pool.
+		Tasks can be run from within other pool tasks; wait() helps with any pending work until all of them finish.
+		run() may be called concurrently, e.g. by several tasks of the same group.
+	*/
+
+	class task_group {
+		thread_pool& pool;
+
+		/* Deque so that the jobs never move while they are queued. */
+		std::deque<detail::pool_job> jobs;
+		std::mutex jobs_mutex;
+		std::atomic<int> remaining = 0;
+
+	public:
+		task_group(thread_pool& pool) : pool(pool) {}
+
+		task_group(const task_group&) = delete;
+		task_group& operator=(const task_group&) = delete;
+
+		~task_group() {
+			wait();
+		}
+
+		template <class F>
+		void run(F&& f) {
+			detail::pool_job* job = nullptr;
+
+			{
+				auto lock = std::unique_lock<std::mutex>(jobs_mutex);
+				job = std::addressof(jobs.emplace_back(std::forward<F>(f), &remaining));
+			}
+
+			remaining.fetch_add(1, std::memory_order_relaxed);
+
+			pool.spawn(*job);
+		}
+
+		void wait() {
+			while (remaining.load(std::memory_order_acquire) > 0) {
+				if (!pool.help_once()) {
+					std::this_thread::yield();
+				}
+			}
 		}
 	};
 }
-
@@ -0,0 +1,12 @@
+#pragma once
+#include <type_traits>
+#include "augs/misc/declare_containers.h"
+
+template <class T>
+struct is_arena_sized_vector : std::false_type {};
+
+template <class T, unsigned C>
+struct is_arena_sized_vector<augs::arena_sized_vector<T, C>> : std::true_type {};
+
+template <class T>
+constexpr bool is_arena_sized_vector_v = is_arena_sized_vector<T>::value;
@@ -11,6 +11,9 @@ struct atlas_profiler : public augs::profiler_mixin<atlas_profiler> {
 	augs::time_measurements gathering_subjects = std::size_t(1);
 	augs::time_measurements unpacking_results = std::size_t(1);
 
+	augs::time_measurements loading_cached_atlas = std::size_t(1);
+	augs::time_measurements saving_cached_atlas = std::size_t(1);
+
 	augs::time_measurements loading_image_sizes = std::size_t(1);
 	augs::time_measurements loading_images = std::size_t(1);
 	augs::time_measurements making_worker_inputs = std::size_t(1);
@@ -13,6 +13,7 @@
 #include "augs/image/image.h"
 #include "augs/image/blit.h"
 #include "augs/texture_atlas/bake_fresh_atlas.h"
+#include "augs/texture_atlas/baked_atlas_cache.h"
 
 #include "augs/readwrite/byte_file.h"
 #include "augs/filesystem/directory.h"
@@ -26,6 +27,9 @@
 
 using namespace rectpack2D;
 
+/* Every cached atlas may take as much disk space as the atlas texture itself. */
+constexpr std::size_t max_cached_atlases = 4;
+
 void bake_fresh_atlas(
 	const bake_fresh_atlas_input in,
 	const bake_fresh_atlas_output out
@@ -35,6 +39,26 @@ void bake_fresh_atlas(
 	auto& baked = out.baked;
 	auto& output_image_size = out.baked.atlas_image_size;
 
+	const bool use_cache = !in.cache_directory.empty();
+
+	const auto cache_key = use_cache ? calc_baked_atlas_cache_key(subjects, in.max_atlas_size) : 0;
+	const auto cache_path = use_cache ? get_baked_atlas_cache_path(in.cache_directory, cache_key) : augs::path_type();
+
+	if (use_cache) {
+		auto scope = measure_scope(out.profiler.loading_cached_atlas);
+
+		try {
+			if (load_baked_atlas(cache_path, cache_key, subjects, out)) {
+				return;
+			}
+		}
+		catch (...) {
+			LOG("Failed to load the cached atlas from %x. Baking a fresh one.", cache_path);
+		}
+
+		baked.clear();
+	}
+
 	std::unordered_map<source_font_identifier, augs::font> loaded_fonts;
 
 	thread_local std::vector<rect_xywhf> rects_for_packer;
@@ -404,4 +428,16 @@ void bake_fresh_atlas(
 #if TEST_SAVE_ATLAS
 	augs::image(output_image.get_data(), output_image.get_size()).save_as_image("/tmp/atl.image");
 #endif
+
+	if (use_cache) {
+		auto scope = measure_scope(out.profiler.saving_cached_atlas);
+
+		try {
+			save_baked_atlas(cache_path, cache_key, subjects, baked, output_image.get_data());
+			prune_baked_atlas_cache(in.cache_directory, max_cached_atlases);
+		}
+		catch (...) {
+			/* Failing to cache is not an error - the atlas will just be baked again next time. */
+		}
+	}
 }
\ No newline at end of file
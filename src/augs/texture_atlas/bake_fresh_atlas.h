@@ -38,6 +38,7 @@ struct baked_atlas {
 		atlas_image_size = {};
 		images.clear();
 		fonts.clear();
+		loaded_images.clear();
 	}
 };
 
@@ -45,6 +46,13 @@ struct bake_fresh_atlas_input {
 	const atlas_input_subjects& subjects;
 	const unsigned max_atlas_size;
 	const unsigned blitting_threads;
+
+	/*
+		If not empty, the baked atlas is first looked up in this directory
+		and stored there after a fresh bake.
+	*/
+
+	const augs::path_type cache_directory = {};
 };
 
 struct bake_fresh_atlas_output {
@@ -0,0 +1,301 @@
+#include <cstdio>
+#include <algorithm>
+#include <system_error>
+
+#include "augs/string/typesafe_sprintf.h"
+#include "augs/filesystem/file.h"
+#include "augs/filesystem/file_time_type.h"
+#include "augs/filesystem/directory.h"
+#include "augs/texture_atlas/baked_atlas_cache.h"
+
+#include "augs/readwrite/byte_readwrite.h"
+#include "augs/readwrite/hashing_stream.h"
+
+namespace {
+	struct baked_atlas_header {
+		static constexpr uint32_t current_magic = 0x314c5441; /* "ATL1" */
+
+		uint32_t magic = current_magic;
+		uint32_t bytes_per_pixel = sizeof(rgba);
+		uint64_t key = 0;
+		uint64_t num_images = 0;
+		uint64_t num_fonts = 0;
+		uint64_t num_loaded_images = 0;
+		uint32_t width = 0;
+		uint32_t height = 0;
+
+		bool matches(const baked_atlas_header& b) const {
+			return
+				magic == b.magic
+				&& bytes_per_pixel == b.bytes_per_pixel
+				&& key == b.key
+				&& num_images == b.num_images
+				&& num_fonts == b.num_fonts
+				&& num_loaded_images == b.num_loaded_images
+			;
+		}
+	};
+
+	auto make_header(const uint64_t key, const atlas_input_subjects& subjects) {
+		baked_atlas_header header;
+		header.key = key;
+		header.num_images = subjects.images.size();
+		header.num_fonts = subjects.fonts.size();
+		header.num_loaded_images = subjects.loaded_images.size();
+
+		return header;
+	}
+
+	void hash_file_stamp(augs::hashing_stream& hs, const augs::path_type& path) {
+		augs::write_bytes(hs, path.string());
+
+		std::error_code ec;
+
+		const auto write_time = std::filesystem::last_write_time(path, ec);
+		const auto stamp = ec ? int64_t(-1) : static_cast<int64_t>(write_time.time_since_epoch().count());
+
+		const auto size = std::filesystem::file_size(path, ec);
+		const auto size_stamp = ec ? uint64_t(-1) : static_cast<uint64_t>(size);
+
+		augs::write_bytes(hs, stamp);
+		augs::write_bytes(hs, size_stamp);
+	}
+
+	template <class F>
+	void for_each_unique_font(const atlas_input_subjects& subjects, F callback) {
+		for (const auto& f : subjects.fonts) {
+			const auto first_occurrence = std::find(subjects.fonts.begin(), subjects.fonts.end(), f);
+
+			if (std::addressof(*first_occurrence) == std::addressof(f)) {
+				callback(f);
+			}
+		}
+	}
+}
+
+uint64_t calc_baked_atlas_cache_key(const atlas_input_subjects& subjects, const unsigned max_atlas_size) {
+	augs::hashing_stream hs;
+
+	augs::write_bytes(hs, baked_atlas_header::current_magic);
+	augs::write_bytes(hs, max_atlas_size);
+
+	augs::write_bytes(hs, subjects.images.size());
+
+	for (const auto& path : subjects.images) {
+		hash_file_stamp(hs, path);
+	}
+
+	augs::write_bytes(hs, subjects.fonts.size());
+
+	for (const auto& f : subjects.fonts) {
+		hash_file_stamp(hs, f.source_font_path);
+
+		augs::write_bytes(hs, f.unicode_ranges);
+		augs::write_bytes(hs, f.size_in_pixels);
+		augs::write_bytes(hs, f.add_japanese_ranges);
+		augs::write_bytes(hs, f.add_cyrillic_ranges);
+	}
+
+	augs::write_bytes(hs, subjects.loaded_images);
+
+	return hs.get_hash();
+}
+
+augs::path_type get_baked_atlas_cache_path(const augs::path_type& cache_directory, const uint64_t key) {
+	return cache_directory / typesafe_sprintf("%x.atlas", key);
+}
+
+bool load_baked_atlas(
+	const augs::path_type& cache_path,
+	const uint64_t key,
+	const atlas_input_subjects& subjects,
+	const bake_fresh_atlas_output out
+) {
+	if (!augs::exists(cache_path)) {
+		return false;
+	}
+
+	auto in = augs::open_binary_input_stream(cache_path);
+
+	baked_atlas_header header;
+	in.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+	if (!header.matches(make_header(key, subjects))) {
+		return false;
+	}
+
+	auto& baked = out.baked;
+	baked.clear();
+	baked.atlas_image_size = vec2u(header.width, header.height);
+
+	const auto area = baked.atlas_image_size.area();
+
+	rgba* const pixels = [&]() {
+		if (out.whole_image != nullptr) {
+			return out.whole_image;
+		}
+
+		out.fallback_output.resize(area);
+		return out.fallback_output.data();
+	}();
+
+	in.read(reinterpret_cast<char*>(pixels), static_cast<std::streamsize>(area * sizeof(rgba)));
+
+	for (const auto& path : subjects.images) {
+		augs::read_bytes(in, baked.images[path]);
+	}
+
+	baked.loaded_images.resize(subjects.loaded_images.size());
+
+	for (auto& entry : baked.loaded_images) {
+		augs::read_bytes(in, entry);
+	}
+
+	for_each_unique_font(subjects, [&](const auto& f) {
+		augs::read_bytes(in, baked.fonts[f]);
+	});
+
+	/* Mark as recently used so that pruning keeps it. */
+	std::filesystem::last_write_time(cache_path, augs::file_time_type::clock::now());
+
+	return true;
+}
+
+void save_baked_atlas(
+	const augs::path_type& cache_path,
+	const uint64_t key,
+	const atlas_input_subjects& subjects,
+	const baked_atlas& baked,
+	const rgba* const pixels
+) {
+	auto header = make_header(key, subjects);
+	header.width = baked.atlas_image_size.x;
+	header.height = baked.atlas_image_size.y;
+
+	augs::create_directories_for(cache_path);
+
+	/*
+		Write to a temporary file first so that a crash
+		never leaves a partially written atlas behind.
+	*/
+
+	auto temporary_path = cache_path;
+	temporary_path += ".tmp";
+
+	{
+		auto out = augs::open_binary_output_stream(temporary_path);
+
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		out.write(reinterpret_cast<const char*>(pixels), static_cast<std::streamsize>(baked.atlas_image_size.area() * sizeof(rgba)));
+
+		for (const auto& path : subjects.images) {
+			augs::write_bytes(out, baked.images.at(path));
+		}
+
+		for (const auto& entry : baked.loaded_images) {
+			augs::write_bytes(out, entry);
+		}
+
+		for_each_unique_font(subjects, [&](const auto& f) {
+			augs::write_bytes(out, baked.fonts.at(f));
+		});
+	}
+
+	std::filesystem::rename(temporary_path, cache_path);
+}
+
+void prune_baked_atlas_cache(const augs::path_type& cache_directory, const std::size_t max_kept) {
+	std::vector<std::pair<augs::file_time_type, augs::path_type>> cached;
+
+	augs::for_each_in_directory(
+		cache_directory,
+		[](const auto&) { return callback_result::CONTINUE; },
+		[&](const auto& path) {
+			if (path.extension() == ".atlas") {
+				cached.emplace_back(augs::last_write_time(path), path);
+			}
+
+			return callback_result::CONTINUE;
+		}
+	);
+
+	if (cached.size() <= max_kept) {
+		return;
+	}
+
+	/* Most recent first */
+	std::sort(cached.begin(), cached.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+	for (std::size_t i = max_kept; i < cached.size(); ++i) {
+		augs::remove_file(cached[i].second);
+	}
+}
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+#include "augs/readwrite/byte_file.h"
+
+TEST_CASE("BakedAtlasCache RoundTripAndInvalidation") {
+	const auto cache_directory = augs::path_type(GENERATED_FILES_DIR) / "test_baked_atlases";
+	const auto source = augs::path_type(GENERATED_FILES_DIR) / "test_baked_atlas_source.bin";
+
+	augs::create_directories(cache_directory);
+	augs::save_string_as_bytes("first", source);
+
+	atlas_input_subjects subjects;
+	subjects.images.push_back(source);
+	subjects.loaded_images.push_back({ std::byte(1), std::byte(2), std::byte(3) });
+
+	const auto key = calc_baked_atlas_cache_key(subjects, 1024);
+	const auto cache_path = get_baked_atlas_cache_path(cache_directory, key);
+
+	REQUIRE(key == calc_baked_atlas_cache_key(subjects, 1024));
+	REQUIRE(key != calc_baked_atlas_cache_key(subjects, 2048));
+
+	baked_atlas baked;
+	baked.atlas_image_size = vec2u(3, 2);
+	baked.images[source].atlas_space.set(0.25f, 0.5f, 0.125f, 0.0625f);
+	baked.images[source].cached_original_size_pixels = vec2u(7, 9);
+	baked.loaded_images.resize(1);
+	baked.loaded_images[0].was_flipped = true;
+
+	const auto pixels = std::vector<rgba> {
+		rgba(1, 2, 3, 4), rgba(5, 6, 7, 8), rgba(9, 10, 11, 12),
+		rgba(13, 14, 15, 16), rgba(17, 18, 19, 20), rgba(21, 22, 23, 24)
+	};
+
+	augs::remove_file(cache_path);
+
+	std::vector<rgba> loaded_pixels;
+	baked_atlas loaded;
+	atlas_profiler profiler;
+
+	const auto output = bake_fresh_atlas_output { nullptr, loaded_pixels, loaded, profiler };
+
+	REQUIRE(!load_baked_atlas(cache_path, key, subjects, output));
+
+	save_baked_atlas(cache_path, key, subjects, baked, pixels.data());
+
+	REQUIRE(load_baked_atlas(cache_path, key, subjects, output));
+	REQUIRE(loaded_pixels == pixels);
+	REQUIRE(loaded.atlas_image_size == baked.atlas_image_size);
+	REQUIRE(loaded.images.at(source).atlas_space == baked.images.at(source).atlas_space);
+	REQUIRE(loaded.images.at(source).cached_original_size_pixels == vec2u(7, 9));
+	REQUIRE(loaded.loaded_images.size() == 1);
+	REQUIRE(loaded.loaded_images[0].was_flipped);
+
+	/* A source of a different size must produce a different key. */
+
+	augs::save_string_as_bytes("second, longer", source);
+	REQUIRE(key != calc_baked_atlas_cache_key(subjects, 1024));
+
+	/* A key mismatch in the header must be rejected. */
+
+	REQUIRE(!load_baked_atlas(cache_path, key + 1, subjects, output));
+
+	prune_baked_atlas_cache(cache_directory, 0);
+	REQUIRE(!augs::exists(cache_path));
+
+	augs::remove_file(source);
+}
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include "augs/texture_atlas/bake_fresh_atlas.h"
+
+/*
+	Baked atlases kept on disk so that an unchanged set of images is packed and blitted only once.
+
+	The key hashes the paths, write times and sizes of all source images and font files,
+	the font loading inputs, the bytes of images loaded from memory and the maximum atlas size.
+	Neon maps and desaturations are regenerated into files before the atlas is baked,
+	so a change to their settings reaches the key through the write times of the generated files.
+
+	A cached file holds the raw pixels first, followed by the atlas entries in the order of the subjects.
+	The pixels are read with a single call straight into the buffer that is later uploaded.
+*/
+
+uint64_t calc_baked_atlas_cache_key(const atlas_input_subjects&, unsigned max_atlas_size);
+augs::path_type get_baked_atlas_cache_path(const augs::path_type& cache_directory, uint64_t key);
+
+/*
+	Returns false if there is no cached atlas for this key.
+	On success, fills the output exactly as bake_fresh_atlas would.
+*/
+
+bool load_baked_atlas(
+	const augs::path_type& cache_path,
+	uint64_t key,
+	const atlas_input_subjects&,
+	bake_fresh_atlas_output
+);
+
+void save_baked_atlas(
+	const augs::path_type& cache_path,
+	uint64_t key,
+	const atlas_input_subjects&,
+	const baked_atlas&,
+	const rgba* pixels
+);
+
+/* Removes all but the most recently used cached atlases in the directory. */
+
+void prune_baked_atlas_cache(const augs::path_type& cache_directory, std::size_t max_kept);
@@ -11,13 +11,18 @@
 #include "game/cosmos/entity_id.h"
 #include "game/cosmos/cosmos.h"
 #include "augs/misc/readable_bytesize.h"
+#include "augs/build_settings/setting_count_allocations.h"
 
 inline auto static_allocations_info() {
 	return typesafe_sprintf(
 		"STATICALLY_ALLOCATE_ENTITIES=%x\n"
-		"STATICALLY_ALLOCATE_ENTITY_FLAVOURS=%x\n",
+		"STATICALLY_ALLOCATE_ENTITY_FLAVOURS=%x\n"
+		"ARENA_SIZED_ENTITY_POOLS=%x\n"
+		"COUNT_ALLOCATIONS=%x\n",
 		STATICALLY_ALLOCATE_ENTITIES,
-		STATICALLY_ALLOCATE_ENTITY_FLAVOURS
+		STATICALLY_ALLOCATE_ENTITY_FLAVOURS,
+		ARENA_SIZED_ENTITY_POOLS,
+		COUNT_ALLOCATIONS
 	);
 }
 
@@ -81,6 +86,29 @@ Options:
                                 Contrary to the --dedicated-server option, this lets you play on your own server within the same game instance.
     --dedicated-server          The same as --server, but applies some settings suitable for a dedicated server instance.
                                 For example - the game will be started without a window.
+    --relay ADDRESS             Start a dedicated server that relays the match hosted at ADDRESS to its own spectators.
+                                Overrides server_relay.upstream.address from the config file. See server_relay for the broadcast delay.
+    --benchmark-solve STEPS     Headlessly advance a test scene with scripted bots for STEPS steps,
+                                then write per-system timings, steps per second and allocations per step as JSON and quit.
+                                Allocations are only counted in builds configured with -DCOUNT_ALLOCATIONS=ON.
+    --benchmark-bots N          Number of bots spawned by --benchmark-solve. Default: 8.
+    --benchmark-seed SEED       Seed of the scripted bot inputs. Default: 0.
+    --benchmark-minimal         Benchmark the minimal test scene instead of the testbed.
+    --benchmark-particles N     Advance and draw N general particles through both the scalar path and the SIMD particle store,
+                                then report particles processed per millisecond as JSON and quit.
+    --benchmark-particle-frames N  Number of frames advanced by --benchmark-particles. Default: 300.
+    --benchmark-delta N         Encode the changes of several entity types N times through object_delta and through the per-byte loop it replaced,
+                                then report the average microseconds per encoding as JSON and quit.
+    --benchmark-report PATH     Where to write the JSON report. If not specified, it is written to the log.
+    --headless-client           Run the client with a renderer backend that only counts the commands instead of drawing them.
+                                Requires a build with BUILD_OPENGL and BUILD_WINDOW_FRAMEWORK turned off.
+                                Combine with --connect [ADDRESS] or --play-demo PATH.
+    --play-demo PATH            Replay the demo file at PATH.
+    --headless-frames N         Quit the headless client after N frames and write the averages of all frame profilers as JSON.
+                                Only the frames rendered once the gameplay is on are measured, so connecting and loading are excluded.
+                                Default: 0 (run until quit).
+    --headless-report PATH      Where to write the JSON report of the headless client. If not specified, it is written to the log.
+    --headless-dump PATH        Append per-frame counts of draw calls, triangles and uploaded bytes to PATH as CSV.
 
 If editor_file_path is supplied and it is a directory,
 the game will automatically launch the editor to try and open the project inside it, if there is one. 
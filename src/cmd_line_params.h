@@ -2,6 +2,10 @@
 #include "augs/filesystem/path.h"
 #include "augs/app_type.h"
 #include "augs/network/network_types.h"
+#include "application/benchmark/solve_benchmark.h"
+#include "application/benchmark/particles_benchmark.h"
+#include "application/benchmark/delta_benchmark.h"
+#include "application/benchmark/headless_client.h"
 
 struct cmd_line_params {
 	augs::path_type exe_path;
@@ -17,6 +21,12 @@ struct cmd_line_params {
 	bool should_connect = false;
 	int test_fp_consistency = -1;
 	std::string connect_address;
+	std::string relay_address;
+
+	solve_benchmark_settings solve_benchmark;
+	particles_benchmark_settings particles_benchmark;
+	delta_benchmark_settings delta_benchmark;
+	headless_client_settings headless_client;
 
 	bool disallow_nat_traversal = false;
 
@@ -50,6 +60,10 @@ struct cmd_line_params {
 			else if (a == "--dedicated-server") {
 				type = app_type::DEDICATED_SERVER;
 			}
+			else if (a == "--relay") {
+				type = app_type::DEDICATED_SERVER;
+				relay_address = argv[i++];
+			}
 			else if (a == "--disallow-nat-traversal") {
 				disallow_nat_traversal = true;
 			}
@@ -68,6 +82,48 @@ struct cmd_line_params {
 			else if (a == "--consistency-report") {
 				consistency_report = argv[i++];
 			}
+			else if (a == "--benchmark-solve") {
+				solve_benchmark.steps = std::atoi(argv[i++]);
+			}
+			else if (a == "--benchmark-bots") {
+				solve_benchmark.bots = std::atoi(argv[i++]);
+			}
+			else if (a == "--benchmark-seed") {
+				solve_benchmark.seed = std::strtoull(argv[i++], nullptr, 10);
+			}
+			else if (a == "--benchmark-minimal") {
+				solve_benchmark.minimal_scene = true;
+			}
+			else if (a == "--benchmark-particles") {
+				particles_benchmark.particles = std::atoi(argv[i++]);
+			}
+			else if (a == "--benchmark-particle-frames") {
+				particles_benchmark.frames = std::atoi(argv[i++]);
+			}
+			else if (a == "--benchmark-delta") {
+				delta_benchmark.iterations = std::atoi(argv[i++]);
+			}
+			else if (a == "--benchmark-report") {
+				solve_benchmark.report_path = argv[i];
+				particles_benchmark.report_path = argv[i];
+				delta_benchmark.report_path = argv[i];
+				++i;
+			}
+			else if (a == "--headless-client") {
+				headless_client.enabled = true;
+			}
+			else if (a == "--headless-frames") {
+				headless_client.frames = std::atoi(argv[i++]);
+			}
+			else if (a == "--headless-report") {
+				headless_client.report_path = argv[i++];
+			}
+			else if (a == "--headless-dump") {
+				headless_client.dump_path = argv[i++];
+			}
+			else if (a == "--play-demo") {
+				headless_client.demo_path = argv[i++];
+			}
 			else if (a == "--connect") {
 				should_connect = true;
 				
@@ -70,12 +70,27 @@ namespace invariants {
 		particle_effect_input muzzle_leave_particles;
 		bool trace_particles_fly_backwards = false;
 		bool trace_sound_audible_to_shooter = false;
-		pad_bytes<2> pad;
+		bool simulate_without_body = false;
+		pad_bytes<1> pad;
 		particle_effect_input trace_particles;
 
 		remnant_flavour_vector remnant_flavours;
 		real32 ricochet_cooldown_ms = 24.f;
 		real32 ricochet_born_cooldown_ms = 24.f;
 		// END GEN INTROSPECTOR
+
+		/*
+			Only rounds that do nothing but damage what they hit can be simulated without a body.
+			See lightweight_projectiles.h.
+		*/
+
+		bool can_simulate_without_body() const {
+			return 
+				simulate_without_body
+				&& damage_upon_collision
+				&& destroy_upon_damage
+				&& homing_towards_hostile_strength <= 0.f
+			;
+		}
 	};
 }
\ No newline at end of file
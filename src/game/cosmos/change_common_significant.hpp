@@ -8,6 +8,7 @@ template <class F>
 void cosmos::change_common_significant(F&& callback) {
 	auto status = changer_callback_result::INVALID;
 	auto& self = *this;
+	auto& unshared = get_unshared_common();
 
 	auto refresh_when_done = augs::scope_guard([&]() {
 		if (status != changer_callback_result::DONT_REFRESH) {
@@ -15,10 +16,10 @@ void cosmos::change_common_significant(F&& callback) {
 				Always first reinfer the common,
 				only later the entities, as they might use the common inferred during their own reinference. 
 			*/
-			common.reinfer();
+			unshared.reinfer();
 			cosmic::reinfer_all_entities(self);
 		}
 	});
 
-	status = callback(common.significant);
+	status = callback(unshared.significant);
 }
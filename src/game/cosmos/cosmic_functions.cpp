@@ -25,6 +25,30 @@ void cosmic::after_solvable_copy(cosmos& to, const cosmos& from) {
 	to.get_solvable_inferred({}).physics.clone_from(from.get_solvable_inferred().physics, to, from);
 }
 
+std::size_t cosmic::transfer_solvable(cosmos& to, const cosmos& from) {
+	auto& target = to.get_solvable({});
+	const auto& source = from.get_solvable();
+
+	/*
+		Every transfer that writes a pool copies all of the inferred state along with it.
+		So if no pool was written to on either side since, the inferred state is still equal,
+		and the caches and the Box2D world are left alone.
+	*/
+
+	const bool pools_differ = !target.significant.same_pool_versions(source.significant);
+	const auto written = target.significant.assign_differing(source.significant);
+
+	if (pools_differ) {
+		target.inferred = source.inferred;
+		after_solvable_copy(to, from);
+
+		/* Migrating the per-entity caches accessed the pools for writing, but left them equal to the source's. */
+		target.significant.copy_pool_versions_from(source.significant);
+	}
+
+	return written;
+}
+
 entity_handle just_create_entity(
 	cosmos& cosm,
 	const entity_flavour_id id,
@@ -155,6 +179,13 @@ void cosmic::reserve_storage_for_entities(cosmos& cosm, const cosmic_pool_size_t
 	cosm.get_solvable({}).reserve_storage_for_entities(s);
 }
 
+void cosmic::fit_entity_pools(cosmos& cosm, const entity_pool_headroom& headroom) {
+	cosm.get_solvable({}).fit_storage_for_entities(headroom);
+
+	/* Fitting moves the entities, so anything that pointed into the pools must be rebuilt. */
+	reinfer_solvable(cosm);
+}
+
 void cosmic::increment_step(cosmos& cosm) {
 	cosm.get_solvable({}).increment_step();
 }
@@ -8,6 +8,7 @@
 
 class cosmic_delta;
 class cosmos;
+struct entity_pool_headroom;
 
 /*
 	The purpose of this class is to centralize all functions 
@@ -83,6 +84,7 @@ public:
 	static std::optional<cosmic_pool_undo_free_input> delete_entity(const entity_handle);
 
 	static void reserve_storage_for_entities(cosmos&, const cosmic_pool_size_type s);
+	static void fit_entity_pools(cosmos&, const entity_pool_headroom&);
 	static void increment_step(cosmos&);
 
 	static void reinfer_solvable(cosmos&);
@@ -96,5 +98,6 @@ public:
 	static void for_each_entity(C& self, F callback);
 
 	static void after_solvable_copy(cosmos&, const cosmos&);
+	static std::size_t transfer_solvable(cosmos&, const cosmos&);
 	static void set_flavour_id_cache_enabled(bool flag, cosmos&);
 };
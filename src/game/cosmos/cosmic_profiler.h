@@ -38,6 +38,7 @@ struct cosmic_profiler : public augs::profiler_mixin<cosmic_profiler> {
 	augs::time_measurements serialization_pass = 1;
 
 	augs::amount_measurements<std::size_t> delta_bytes = 1;
+	augs::amount_measurements<std::size_t> transferred_bytes = 1;
 
 	augs::time_measurements duplication = 1;
 
@@ -1,5 +1,4 @@
 #include "augs/ensure_rel.h"
-#include "3rdparty/crc32/crc32.h"
 
 #include "augs/readwrite/memory_stream.h"
 
@@ -15,6 +14,12 @@
 #include "augs/readwrite/byte_readwrite.h"
 
 #include "game/cosmos/for_each_entity.h"
+#include "game/cosmos/solvable_signi_hashes.h"
+
+#include "augs/templates/for_each_type.h"
+#include "augs/templates/folded_finders.h"
+#include "augs/templates/remove_cref.h"
+#include "augs/string/get_type_name.h"
 
 #include <atomic>
 
@@ -32,12 +37,12 @@ void cosmos::mark_as_resampled() const {
 	resample = false;
 }
 
-cosmos::cosmos() : cosmos_id(cosmos_counter++) 
+cosmos::cosmos() : common(std::make_shared<cosmos_common>()), cosmos_id(cosmos_counter++) 
 {
 }
 
 cosmos::cosmos(const cosmic_pool_size_type reserved_entities) 
-	: solvable(reserved_entities), cosmos_id(cosmos_counter++)
+	: common(std::make_shared<cosmos_common>()), solvable(reserved_entities), cosmos_id(cosmos_counter++)
 {
 }
 
@@ -56,26 +61,27 @@ cosmos& cosmos::operator=(const cosmos& b) {
 
 const cosmos cosmos::zero = {};
 
-template <class T>
-T cosmos::calculate_solvable_signi_hash() const {
-	if constexpr(std::is_same_v<T, uint32_t>) {
-		augs::memory_stream ss;
+cosmos_common& cosmos::get_unshared_common() {
+	/*
+		Only the thread owning this cosmos can make another copy of its pointer,
+		so if nobody else holds it now, nobody will until we return.
+	*/
 
-		augs::write_bytes(ss, get_clock().now);
-		augs::write_bytes(ss, get_entities_count());
+	if (common.use_count() > 1) {
+		common = std::make_shared<cosmos_common>(*common);
+	}
 
-		for_each_having<components::sentience>(
-			[&](const auto& it) {
-				const auto& b = it.template get<components::rigid_body>();
-				const auto& c = b.get_raw_component().physics_transforms.m_xf;
-				const auto& s = it.template get<components::sentience>();
+	return *common;
+}
 
-				augs::write_bytes(ss, c);
-				augs::write_bytes(ss, s.meters);
-			}
-		);
+solvable_signi_hashes cosmos::calculate_solvable_signi_hashes() const {
+	return get_solvable().significant.calculate_hashes();
+}
 
-		return crc32buf(reinterpret_cast<char*>(ss.data()), ss.get_write_pos());
+template <class T>
+T cosmos::calculate_solvable_signi_hash() const {
+	if constexpr(std::is_same_v<T, uint32_t>) {
+		return calculate_solvable_signi_hashes().combined();
 	}
 	else {
 		static_assert(always_false_v<T>, "Unsupported hash type.");
@@ -86,6 +92,29 @@ T cosmos::calculate_solvable_signi_hash() const {
 
 template uint32_t cosmos::calculate_solvable_signi_hash() const;
 
+std::string solvable_signi_hashes::describe(const solvable_signi_hashes* const reference) const {
+	std::string out;
+
+	auto line = [&](const std::string& label, const uint64_t value, const uint64_t* const previous) {
+		const bool changed = previous != nullptr && *previous != value;
+		out += typesafe_sprintf("%x%x: %x\n", changed ? "* " : "  ", label, value);
+	};
+
+	line("clock", clock, reference ? &reference->clock : nullptr);
+
+	for_each_type_in_list<all_entity_types>([&](const auto& dummy) {
+		using E = remove_cref<decltype(dummy)>;
+		constexpr auto idx = index_in_list_v<E, all_entity_types>;
+
+		line(get_type_name_strip_namespace<E>(), pools[idx], reference ? &reference->pools[idx] : nullptr);
+	});
+
+	line("specific_names", specific_names, reference ? &reference->specific_names : nullptr);
+	line("global", global, reference ? &reference->global : nullptr);
+
+	return out;
+}
+
 std::string cosmos::summary() const {
 	return typesafe_sprintf("Entities: %x\n", get_entities_count());
 }
@@ -143,7 +172,15 @@ void cosmos::set(const cosmos_solvable_significant& new_signi) {
 }
 
 void cosmos::reinfer_everything() {
-	common.reinfer();
+	/*
+		A shared common was already reinferred by whoever changed it last,
+		and its inferred part depends on nothing but its significant part.
+	*/
+
+	if (common.use_count() == 1) {
+		common->reinfer();
+	}
+
 	cosmic::reinfer_solvable(*this);
 }
 
@@ -158,7 +195,6 @@ void cosmos::set_fixed_delta(const augs::delta& dt) {
 }
 
 void cosmos::assign_solvable(const cosmos& b) {
-	solvable = b.solvable;
-
-	cosmic::after_solvable_copy(*this, b);
+	const auto written = cosmic::transfer_solvable(*this, b);
+	profiler.transferred_bytes.measure(written);
 }
@@ -1,4 +1,5 @@
 #pragma once
+#include <memory>
 #include "augs/build_settings/compiler_defines.h"
 #include "augs/misc/randomization_declaration.h"
 
@@ -6,6 +7,7 @@
 
 #include "game/cosmos/cosmos_common.h"
 #include "game/cosmos/cosmic_profiler.h"
+#include "game/cosmos/solvable_signi_hashes.h"
 #include "game/cosmos/cosmos_common_significant_access.h"
 #include "game/cosmos/private_cosmos_solvable.h"
 #include "game/cosmos/entity_id.h"
@@ -23,12 +25,21 @@ class cosmos {
 		}
 	}
 
-	cosmos_common common;
+	/*
+		Copies of a cosmos share the common state until one of them changes it,
+		e.g. the initial and the advanced cosmos of an arena,
+		or the arenas of dedicated server instances loaded from the same files.
+	*/
+
+	std::shared_ptr<cosmos_common> common;
 	private_cosmos_solvable solvable;
 
 	cosmos_id_type cosmos_id = 0;
 	mutable bool resample = true;
 
+	/* Detaches the common state from the other copies first if it is shared. */
+	cosmos_common& get_unshared_common();
+
 public: 
 	/* A detail only for performance benchmarks */
 	mutable cosmic_profiler profiler;
@@ -71,15 +82,15 @@ public:
 	std::string summary() const;
 
 	const cosmos_common_significant& get_common_significant() const {
-		return common.significant;
+		return common->significant;
 	}
 
 	cosmos_common_significant& get_common_significant(cosmos_common_significant_access) {
-		return common.significant;
+		return get_unshared_common().significant;
 	}
 
 	const cosmos_common_significant& get_common_significant(cosmos_common_significant_access) const {
-		return common.significant;
+		return common->significant;
 	}
 
 	const common_assets& get_common_assets() const {
@@ -311,6 +322,8 @@ public:
 	template <class T>
 	T calculate_solvable_signi_hash() const;
 
+	solvable_signi_hashes calculate_solvable_signi_hashes() const;
+
 	cosmos_id_type get_cosmos_id() const {
 		return cosmos_id;
 	}
@@ -1,13 +1,80 @@
 #pragma once
 #include "game/detail/inventory/item_mounting.h"
+#include "game/detail/missile/lightweight_projectiles.h"
 #include "game/cosmos/step_declaration.h"
+#include "augs/readwrite/byte_readwrite_declaration.h"
 
 struct cosmos_global_solvable {
 	// GEN INTROSPECTOR struct cosmos_global_solvable
 	pending_item_mounts_type pending_item_mounts;
+	lightweight_projectiles projectiles;
 	// END GEN INTROSPECTOR
 
 	void solve_item_mounting(logic_step);
 	void clear();
+
+	/*
+		The rounds in flight came after the arenas were first saved,
+		so they are written only if there are any, flagged by the top bit of the mount count.
+		A state without them stays the same byte for byte as before, and so does its hash.
+	*/
+
+	static constexpr unsigned has_projectiles_bit = 1u << 31;
+
+	template <class Archive>
+	void write_object_bytes(Archive& ar) const {
+		const auto num_mounts = static_cast<unsigned>(pending_item_mounts.size());
+		augs::write_bytes(ar, projectiles.empty() ? num_mounts : (num_mounts | has_projectiles_bit));
+
+		for (const auto& it : pending_item_mounts) {
+			augs::write_bytes(ar, it.first);
+			augs::write_bytes(ar, it.second);
+		}
+
+		if (!projectiles.empty()) {
+			augs::write_bytes(ar, projectiles);
+		}
+	}
+
+	template <class Archive>
+	void read_object_bytes(Archive& ar) {
+		unsigned num_mounts;
+		augs::read_bytes(ar, num_mounts);
+
+		const bool has_projectiles = (num_mounts & has_projectiles_bit) != 0;
+		num_mounts &= ~has_projectiles_bit;
+
+		pending_item_mounts.clear();
+
+		while (num_mounts--) {
+			pending_item_mounts_type::key_type key;
+			pending_item_mounts_type::mapped_type mapped;
+
+			augs::read_bytes(ar, key);
+			augs::read_bytes(ar, mapped);
+
+			pending_item_mounts.emplace(std::move(key), std::move(mapped));
+		}
+
+		projectiles.clear();
+
+		if (has_projectiles) {
+			augs::read_bytes(ar, projectiles);
+		}
+	}
 };
 
+/* 
+	Found by argument-dependent lookup, 
+	so unlike the overloads in the augs namespace, these work regardless of the order of includes.
+*/
+
+template <class A>
+void read_object_bytes(A& ar, cosmos_global_solvable& storage) {
+	storage.read_object_bytes(ar);
+}
+
+template <class A>
+void write_object_bytes(A& ar, const cosmos_global_solvable& storage) {
+	storage.write_object_bytes(ar);
+}
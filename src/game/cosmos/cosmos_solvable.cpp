@@ -12,6 +12,7 @@ const cosmos_solvable cosmos_solvable::zero;
 void cosmos_solvable::clear() {
 	destroy_all_caches();
 	significant.entity_pools.clear();
+	significant.pool_hashes.invalidate_all();
 	significant.clk = {};
 	significant.specific_names.clear();
 }
@@ -40,11 +41,42 @@ static auto make_reserver(const std::size_t n) {
 
 void cosmos_solvable::reserve_storage_for_entities(const cosmic_pool_size_type n) {
 	significant.entity_pools.reserve(n);
+	significant.pool_hashes.invalidate_all();
 	augs::introspect(make_reserver(n), inferred);
 }
 
+void cosmos_solvable::fit_storage_for_entities(const entity_pool_headroom& headroom) {
+	significant.pool_hashes.invalidate_all();
+
+	significant.entity_pools.for_each_container(
+		[&](auto& entity_pool) {
+			using P = remove_cref<decltype(entity_pool)>;
+			using E = entity_type_of<typename P::value_type>;
+
+			if constexpr(is_arena_sized_vector_v<typename P::object_pool_type>) {
+				const auto n = static_cast<std::size_t>(entity_pool.size());
+
+				const auto for_content = std::max(
+					static_cast<std::size_t>(headroom.min_free_entities),
+					static_cast<std::size_t>(n * headroom.arena_content_mult)
+				);
+
+				const auto for_spawning = static_cast<std::size_t>(E::spawn_headroom_entities * headroom.spawn_headroom_mult);
+
+				const auto total = std::min(
+					for_content + for_spawning, 
+					E::statically_allocated_entities
+				);
+
+				entity_pool.fit_capacity(static_cast<cosmic_pool_size_type>(total));
+			}
+		}
+	);
+}
+
 void cosmos_solvable::destroy_all_caches() {
 	inferred.~cosmos_solvable_inferred();
+	significant.pool_hashes.invalidate_all();
 
 	significant.entity_pools.for_each_container(
 		[&](auto& entity_pool) {
@@ -14,6 +14,7 @@
 #include "game/cosmos/cosmos_solvable_significant.h"
 #include "game/cosmos/entity_id.h"
 #include "game/cosmos/entity_creation_error.h"
+#include "game/cosmos/entity_pool_headroom.h"
 
 struct entity_creation_input {
 	raw_entity_flavour_id flavour_id;
@@ -52,6 +53,7 @@ public:
 	explicit cosmos_solvable(const cosmic_pool_size_type reserved_entities);
 
 	void reserve_storage_for_entities(const cosmic_pool_size_type);
+	void fit_storage_for_entities(const entity_pool_headroom&);
 
 	template <class E>
 	auto allocate_next_entity(entity_creation_input);
@@ -89,7 +91,8 @@ public:
 	
 	template <class E>
 	auto get_max_count_of() const {
-		return significant.template get_pool<E>().max_size();
+		const auto& pool = significant.template get_pool<E>();
+		return pool.is_capacity_fixed() ? pool.capacity() : pool.max_size();
 	}
 
 	auto get_count_of(const processing_subjects list_type) const {
@@ -4,7 +4,9 @@
 
 template <template <class> class Predicate, class S, class F>
 void cosmos_solvable::for_each_entity_impl(S& self, F callback) {
-	self.significant.for_each_entity_pool(
+	/* Only the pools matching the predicate are touched, so only those lose their cached hashes. */
+
+	self.significant.entity_pools.for_each_container(
 		[&](auto& p) {
 			using P = decltype(p);
 			using pool_type = remove_cref<P>;
@@ -13,6 +15,10 @@ void cosmos_solvable::for_each_entity_impl(S& self, F callback) {
 			using E = entity_type_of<Solvable>;
 
 			if constexpr(Predicate<E>::value) {
+				if constexpr(!std::is_const_v<S>) {
+					self.significant.pool_hashes.template invalidate<E>();
+				}
+
 				using index_type = typename pool_type::used_size_type;
 
 				for (index_type i = 0; i < p.size(); ++i) {
@@ -1,11 +1,310 @@
+#include <atomic>
 #include "augs/filesystem/file.h"
 
 #include "augs/readwrite/memory_stream.h"
+#include "augs/readwrite/hashing_stream.h"
+#include "augs/readwrite/byte_readwrite.h"
+#include "augs/templates/introspect.h"
 
 #include "game/organization/all_component_includes.h"
 #include "game/cosmos/cosmos.h"
+#include "game/cosmos/solvable_signi_hashes.h"
 
 void cosmos_solvable_significant::clear() {
 	*this = cosmos_solvable_significant();
 	global.clear();
-}
\ No newline at end of file
+}
+
+void cosmos_solvable_significant::fix_entity_pool_capacities() {
+	/* The flag is not hashed, so the cached hashes stay valid. */
+
+	entity_pools.for_each_container([&](auto& pool) {
+		using P = remove_cref<decltype(pool)>;
+
+		if constexpr(is_arena_sized_vector_v<typename P::object_pool_type>) {
+			pool.fix_capacity();
+		}
+	});
+}
+
+uint64_t signi_pool_hash_cache::next_version() {
+	static std::atomic<uint64_t> last_version = 0;
+	return last_version.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+std::size_t cosmos_solvable_significant::assign_differing(const cosmos_solvable_significant& b) {
+	augs::byte_counter_stream written;
+
+	augs::introspect(
+		[&](auto, auto& field, const auto& b_field) {
+			using T = remove_cref<decltype(field)>;
+
+			if constexpr(std::is_same_v<T, all_entity_pools>) {
+				field.for_each_container([&](auto& pool) {
+					using P = remove_cref<decltype(pool)>;
+					using E = entity_type_of<typename P::value_type>;
+
+					if (pool_hashes.same_version<E>(b.pool_hashes)) {
+						/* Neither pool was accessed for writing since they were last made equal. */
+						return;
+					}
+
+					const auto& b_pool = b_field.template get<P>();
+
+					pool = b_pool;
+					pool_hashes.copy_from<E>(b.pool_hashes);
+
+					augs::write_bytes(written, b_pool);
+				});
+			}
+			else {
+				field = b_field;
+				augs::write_bytes(written, b_field);
+			}
+		},
+		*this,
+		b
+	);
+
+	return written.size();
+}
+
+bool cosmos_solvable_significant::same_pool_versions(const cosmos_solvable_significant& b) const {
+	bool same = true;
+
+	entity_pools.for_each_container([&](const auto& pool) {
+		using E = entity_type_of<typename remove_cref<decltype(pool)>::value_type>;
+
+		same = same && pool_hashes.same_version<E>(b.pool_hashes);
+	});
+
+	return same;
+}
+
+void cosmos_solvable_significant::copy_pool_versions_from(const cosmos_solvable_significant& b) {
+	entity_pools.for_each_container([&](const auto& pool) {
+		using E = entity_type_of<typename remove_cref<decltype(pool)>::value_type>;
+		pool_hashes.copy_from<E>(b.pool_hashes);
+	});
+}
+
+solvable_signi_hashes cosmos_solvable_significant::calculate_hashes() const {
+	solvable_signi_hashes result;
+
+	auto hash_of = [](const auto& object) {
+		augs::hashing_stream hs;
+		augs::write_bytes(hs, object);
+		return hs.get_hash();
+	};
+
+	for_each_entity_pool([&](const auto& pool) {
+		using E = entity_type_of<typename remove_cref<decltype(pool)>::value_type>;
+		constexpr auto idx = index_in_list_v<E, all_entity_types>;
+
+		if (const auto cached = pool_hashes.find<E>()) {
+			result.pools[idx] = *cached;
+		}
+		else {
+			result.pools[idx] = hash_of(pool);
+			pool_hashes.set<E>(result.pools[idx]);
+		}
+	});
+
+	result.clock = hash_of(clk);
+	result.specific_names = hash_of(specific_names);
+	result.global = hash_of(global);
+
+	return result;
+}
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+#include "augs/misc/pool/pool_allocate.h"
+#include "augs/templates/introspection_utils/count_members.h"
+
+TEST_CASE("SolvableSignificant CachedPoolHashes") {
+	cosmos_solvable_significant signi;
+	signi.entity_pools.reserve(16);
+
+	const auto initial = signi.calculate_hashes();
+
+	REQUIRE(initial == signi.calculate_hashes());
+
+	constexpr auto decoration_idx = index_in_list_v<sprite_decoration, all_entity_types>;
+	constexpr auto character_idx = index_in_list_v<controlled_character, all_entity_types>;
+
+	{
+		/* A const access must keep the cached hash. */
+		const auto& const_signi = signi;
+		REQUIRE(const_signi.get_pool<sprite_decoration>().size() == 0);
+		REQUIRE(signi.pool_hashes.find<sprite_decoration>() != nullptr);
+	}
+
+	signi.get_pool<sprite_decoration>().allocate(raw_entity_flavour_id(), augs::stepped_timestamp());
+
+	REQUIRE(signi.pool_hashes.find<sprite_decoration>() == nullptr);
+	REQUIRE(signi.pool_hashes.find<controlled_character>() != nullptr);
+
+	const auto after_allocation = signi.calculate_hashes();
+
+	REQUIRE(after_allocation.pools[decoration_idx] != initial.pools[decoration_idx]);
+	REQUIRE(after_allocation.pools[character_idx] == initial.pools[character_idx]);
+
+	{
+		/* A copy starts with no cache, so it hashes everything from scratch. */
+		const auto copied = signi;
+
+		REQUIRE(copied.pool_hashes.find<controlled_character>() == nullptr);
+		REQUIRE(copied.calculate_hashes() == after_allocation);
+	}
+
+	{
+		/* Equal contents after assign_differing, so the source's hashes can be kept. */
+		cosmos_solvable_significant target;
+		target.entity_pools.reserve(16);
+		target.assign_differing(signi);
+
+		REQUIRE(target.pool_hashes.find<sprite_decoration>() != nullptr);
+		REQUIRE(target.calculate_hashes() == after_allocation);
+	}
+
+	signi.for_each_entity_pool([](auto&) {});
+	REQUIRE(signi.pool_hashes.find<controlled_character>() == nullptr);
+	REQUIRE(signi.calculate_hashes() == after_allocation);
+}
+
+TEST_CASE("SolvableSignificant AssignDifferingSkipsUnchangedPools") {
+	auto bytes_of = [](const auto& object) {
+		augs::byte_counter_stream s;
+		augs::write_bytes(s, object);
+		return s.size();
+	};
+
+	cosmos_solvable_significant source;
+	source.entity_pools.reserve(16);
+	source.get_pool<sprite_decoration>().allocate(raw_entity_flavour_id(), augs::stepped_timestamp());
+
+	cosmos_solvable_significant target;
+	target.entity_pools.reserve(16);
+
+	REQUIRE(!target.same_pool_versions(source));
+	REQUIRE(target.assign_differing(source) == bytes_of(source));
+	REQUIRE(target.same_pool_versions(source));
+
+	const auto non_pool_bytes = bytes_of(source) - bytes_of(source.entity_pools);
+
+	/* Nothing was accessed for writing, so only the fields outside of the pools are written. */
+	REQUIRE(target.assign_differing(source) == non_pool_bytes);
+
+	/* Any write access, even one that changes nothing, counts. */
+	source.get_pool<controlled_character>();
+
+	REQUIRE(!target.same_pool_versions(source));
+	REQUIRE(target.assign_differing(source) == non_pool_bytes + bytes_of(std::as_const(source).get_pool<controlled_character>()));
+	REQUIRE(target.same_pool_versions(source));
+
+	target.get_pool<sprite_decoration>().allocate(raw_entity_flavour_id(), augs::stepped_timestamp());
+
+	REQUIRE(!target.same_pool_versions(source));
+	REQUIRE(target.assign_differing(source) == non_pool_bytes + bytes_of(std::as_const(source).get_pool<sprite_decoration>()));
+	REQUIRE(target.get_pool<sprite_decoration>().size() == 1);
+
+	{
+		/* A copy has the same contents, but does not know it. */
+		const auto copied = source;
+		REQUIRE(!copied.same_pool_versions(source));
+	}
+}
+
+TEST_CASE("SolvableSignificant AssignDifferingCopiesEveryField") {
+	cosmos_solvable_significant source;
+	source.entity_pools.reserve(16);
+
+	/*
+		If this fails, a field was added to cosmos_solvable_significant.
+		Make it differ from the default below too, so that this test covers it.
+	*/
+
+	REQUIRE(augs::count_members(source) == 4);
+
+	source.get_pool<sprite_decoration>().allocate(raw_entity_flavour_id(), augs::stepped_timestamp());
+	source.clk.now.step = 1337;
+	source.specific_names[entity_id()] = "name";
+	source.global.projectiles.push_back(lightweight_projectile());
+
+	cosmos_solvable_significant target;
+	target.entity_pools.reserve(16);
+	target.assign_differing(source);
+
+	auto bytes_of = [](const auto& object) {
+		std::vector<std::byte> bytes;
+		auto s = augs::ref_memory_stream(bytes);
+		augs::write_bytes(s, object);
+		return bytes;
+	};
+
+	const auto defaults = std::make_unique<cosmos_solvable_significant>();
+	defaults->entity_pools.reserve(16);
+
+	augs::introspect(
+		[&](const auto label, const auto& target_field, const auto& source_field, const auto& default_field) {
+			INFO(label);
+			REQUIRE(bytes_of(source_field) != bytes_of(default_field));
+			REQUIRE(bytes_of(target_field) == bytes_of(source_field));
+		},
+		target,
+		source,
+		*defaults
+	);
+}
+TEST_CASE("SolvableSignificant ProjectilesWrittenOnlyIfAny") {
+	auto bytes_of = [](const auto& object) {
+		std::vector<std::byte> bytes;
+		auto s = augs::ref_memory_stream(bytes);
+		augs::write_bytes(s, object);
+		return bytes;
+	};
+
+	cosmos_global_solvable global;
+	global.pending_item_mounts[entity_id()].progress_ms = 12.f;
+
+	/* Without rounds in flight, the bytes are those of the format that came before them. */
+	REQUIRE(bytes_of(global) == bytes_of(global.pending_item_mounts));
+
+	lightweight_projectile round;
+	round.rng_seed = 42;
+
+	global.projectiles.push_back(round);
+	global.projectiles.push_back(round);
+
+	const auto with_projectiles = bytes_of(global);
+	REQUIRE(with_projectiles != bytes_of(global.pending_item_mounts));
+
+	{
+		cosmos_global_solvable read;
+		read.projectiles.push_back(round);
+
+		auto s = augs::cref_memory_stream(with_projectiles);
+		augs::read_bytes(s, read);
+
+		REQUIRE(read.pending_item_mounts.size() == 1);
+		REQUIRE(read.pending_item_mounts.begin()->second.progress_ms == 12.f);
+		REQUIRE(read.projectiles.size() == 2);
+		REQUIRE(read.projectiles.rng_seeds[1] == 42);
+		REQUIRE(bytes_of(read) == with_projectiles);
+	}
+
+	{
+		/* The state written before the rounds existed reads as having none. */
+		cosmos_global_solvable read;
+		read.projectiles.push_back(round);
+
+		const auto old_bytes = bytes_of(global.pending_item_mounts);
+		auto s = augs::cref_memory_stream(old_bytes);
+		augs::read_bytes(s, read);
+
+		REQUIRE(read.pending_item_mounts.size() == 1);
+		REQUIRE(read.projectiles.empty());
+	}
+}
+#endif
@@ -1,6 +1,7 @@
 #pragma once
 #include <map>
 #include "augs/misc/constant_size_vector.h"
+#include "augs/misc/arena_sized_vector.h"
 #include "augs/misc/pool/pool.h"
 
 #include "augs/templates/get_by_dynamic_id.h"
@@ -13,6 +14,10 @@
 #include "game/cosmos/cosmos_global_solvable.h"
 
 #include "augs/misc/assignment_detector.h"
+#include "game/cosmos/signi_pool_hash_cache.h"
+#include "game/cosmos/specific_entity_handle_declaration.h"
+
+struct solvable_signi_hashes;
 
 using cosmos_clock = augs::stepped_clock;
 
@@ -26,9 +31,11 @@ struct cosmos_solvable_significant {
 	// END GEN INTROSPECTOR
 
 	mutable augs::assignment_detector assignment_detector;
+	mutable signi_pool_hash_cache pool_hashes;
 
 	template <class E>
 	auto& get_pool() {
+		pool_hashes.invalidate<E>();
 		return entity_pools.get_for<E>();
 	}
 
@@ -39,7 +46,12 @@ struct cosmos_solvable_significant {
 
 	template <class F>
 	decltype(auto) on_pool(const entity_type_id id, F&& callback) {
-		return entity_pools.visit(id, std::forward<F>(callback));
+		return entity_pools.visit(id, [&](auto& pool) -> decltype(auto) {
+			using P = remove_cref<decltype(pool)>;
+			pool_hashes.invalidate<entity_type_of<typename P::value_type>>();
+
+			return callback(pool);
+		});
 	}
 
 	template <class F>
@@ -49,6 +61,7 @@ struct cosmos_solvable_significant {
 
 	template <class F>
 	decltype(auto) for_each_entity_pool(F&& callback) {
+		pool_hashes.invalidate_all();
 		return entity_pools.for_each_container(std::forward<F>(callback));
 	}
 
@@ -58,4 +71,35 @@ struct cosmos_solvable_significant {
 	}
 
 	void clear();
+
+	/*
+		Makes the current capacities of the entity pools final.
+		Used after reading the state of a server, whose pools are always fitted.
+	*/
+
+	void fix_entity_pool_capacities();
+
+	/*
+		Assigns b, skipping the entity pools whose versions in pool_hashes match b's.
+		Returns the number of bytes actually written.
+	*/
+
+	std::size_t assign_differing(const cosmos_solvable_significant& b);
+
+	/* True if assign_differing would skip every entity pool. */
+	bool same_pool_versions(const cosmos_solvable_significant& b) const;
+
+	/* 
+		For after the pools were made equal to b's by assign_differing,
+		and then accessed for writing only to migrate the caches kept alongside them.
+	*/
+
+	void copy_pool_versions_from(const cosmos_solvable_significant& b);
+
+	/*
+		Hashes every part of the state.
+		Pools whose hashes are still cached in pool_hashes are not hashed again.
+	*/
+
+	solvable_signi_hashes calculate_hashes() const;
 };
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+
+/*
+	How much room to leave in each entity pool once it is fitted to a loaded arena.
+
+	Every pool gets the larger of min_free_entities and arena_content_mult times the number of its entities,
+	plus spawn_headroom_mult times the spawn_headroom_entities of its type.
+	The result is always clamped to statically_allocated_entities.
+
+	Both the server and the clients fit their pools with these same values,
+	so this is a part of the solvable server vars.
+*/
+
+struct entity_pool_headroom {
+	// GEN INTROSPECTOR struct entity_pool_headroom
+	float arena_content_mult = 0.25f;
+	unsigned min_free_entities = 64;
+	float spawn_headroom_mult = 1.f;
+	// END GEN INTROSPECTOR
+};
@@ -12,10 +12,22 @@
 template <class E>
 struct entity_solvable;
 
+/*
+	With arena-sized pools, statically_allocated_entities is only the ceiling.
+	The actual capacity is fitted to the arena once it is loaded - see cosmic::fit_entity_pools.
+*/
+
+template <class T>
+using make_static_entity_pool = std::conditional_t<
+	arena_sized_entity_pools,
+	augs::pool<entity_solvable<T>, of_size<T::statically_allocated_entities>::template make_arena_sized_vector, cosmic_pool_size_type, typename T::synchronized_arrays>,
+	augs::pool<entity_solvable<T>, of_size<T::statically_allocated_entities>::template make_nontrivial_constant_vector, cosmic_pool_size_type, typename T::synchronized_arrays>
+>;
+
 template <class T>
 using make_entity_pool = std::conditional_t<
 	statically_allocate_entities,
-	augs::pool<entity_solvable<T>, of_size<T::statically_allocated_entities>::template make_nontrivial_constant_vector, cosmic_pool_size_type, typename T::synchronized_arrays>,
+	make_static_entity_pool<T>,
 	augs::pool<entity_solvable<T>, make_vector, cosmic_pool_size_type, typename T::synchronized_arrays>
 >;
 
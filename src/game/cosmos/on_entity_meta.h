@@ -10,7 +10,7 @@ decltype(auto) cosmos_solvable::on_entity_meta_impl(
 	using meta_ptr = maybe_const_ptr_t<std::is_const_v<C>, entity_solvable_meta>;
 
 	if (id.type_id.is_set()) {
-		return self.significant.entity_pools.visit(
+		return self.significant.on_pool(
 			id.type_id,
 			[&](auto& pool) -> decltype(auto) {	
 				return callback(static_cast<meta_ptr>(pool.find(id.raw)));
@@ -6,6 +6,7 @@
 #include "game/organization/all_entity_types_declaration.h"
 
 static constexpr bool statically_allocate_entities = STATICALLY_ALLOCATE_ENTITIES;
+static constexpr bool arena_sized_entity_pools = ARENA_SIZED_ENTITY_POOLS;
 
 template <template <class> class Mod>
 using per_entity_type = per_type_t<all_entity_types, Mod>;
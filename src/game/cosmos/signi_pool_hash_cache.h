@@ -0,0 +1,109 @@
+#pragma once
+#include <memory>
+#include <cstdint>
+
+#include "game/cosmos/per_entity_type.h"
+#include "game/organization/all_entity_types_declaration.h"
+
+/*
+	Hashes of entity pools last calculated by cosmos::calculate_solvable_signi_hashes,
+	and the versions of their contents.
+
+	Any non-const access to a pool invalidates its hash,
+	so only the pools that could have changed since the last calculation are hashed again.
+	Most pools (decorations, markers, lights and the like) are never touched by a step.
+
+	The same access also drops the version of the pool.
+	The next time it is asked for, the pool gets a version never handed out before in this process.
+	A version travels along with the contents only through copy_from,
+	so two pools of the same version are equal, and a transfer can skip them altogether.
+
+	Copying or assigning a cache invalidates it entirely - the owner copies valid hashes explicitly
+	if it knows the contents are equal.
+*/
+
+class signi_pool_hash_cache {
+	per_entity_type_array<uint64_t> hashes = {};
+	per_entity_type_array<bool> valid = {};
+
+	per_entity_type_array<uint64_t> versions = {};
+	per_entity_type_array<bool> versioned = {};
+
+	static uint64_t next_version();
+
+public:
+	signi_pool_hash_cache() = default;
+
+	signi_pool_hash_cache(const signi_pool_hash_cache&) {}
+
+	signi_pool_hash_cache& operator=(const signi_pool_hash_cache&) {
+		invalidate_all();
+		return *this;
+	}
+
+	template <class E>
+	void invalidate() {
+		constexpr auto idx = index_in_list_v<E, all_entity_types>;
+
+		valid[idx] = false;
+		versioned[idx] = false;
+	}
+
+	void invalidate_all() {
+		valid.fill(false);
+		versioned.fill(false);
+	}
+
+	template <class E>
+	const uint64_t* find() const {
+		constexpr auto idx = index_in_list_v<E, all_entity_types>;
+
+		if (valid[idx]) {
+			return std::addressof(hashes[idx]);
+		}
+
+		return nullptr;
+	}
+
+	template <class E>
+	void set(const uint64_t hash) {
+		constexpr auto idx = index_in_list_v<E, all_entity_types>;
+
+		hashes[idx] = hash;
+		valid[idx] = true;
+	}
+
+	template <class E>
+	uint64_t get_version() {
+		constexpr auto idx = index_in_list_v<E, all_entity_types>;
+
+		if (!versioned[idx]) {
+			versions[idx] = next_version();
+			versioned[idx] = true;
+		}
+
+		return versions[idx];
+	}
+
+	template <class E>
+	bool same_version(signi_pool_hash_cache& b) {
+		return get_version<E>() == b.get_version<E>();
+	}
+
+	/* Call only once the pool of E holds the same contents as the pool b was kept for. */
+
+	template <class E>
+	void copy_from(const signi_pool_hash_cache& b) {
+		constexpr auto idx = index_in_list_v<E, all_entity_types>;
+
+		if (const auto h = b.find<E>()) {
+			set<E>(*h);
+		}
+		else {
+			valid[idx] = false;
+		}
+
+		versions[idx] = b.versions[idx];
+		versioned[idx] = b.versioned[idx];
+	}
+};
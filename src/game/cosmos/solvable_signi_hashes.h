@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "game/cosmos/per_entity_type.h"
+
+/*
+	Hashes of the entire significant state of the solvable,
+	kept separately per entity pool so that a desync can be narrowed down
+	to the pools whose contents diverged.
+*/
+
+struct solvable_signi_hashes {
+	per_entity_type_array<uint64_t> pools = {};
+	uint64_t clock = 0;
+	uint64_t specific_names = 0;
+	uint64_t global = 0;
+
+	uint32_t combined() const {
+		uint64_t h = clock;
+
+		auto fold = [&h](const uint64_t v) {
+			h ^= v + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+		};
+
+		for (const auto& p : pools) {
+			fold(p);
+		}
+
+		fold(specific_names);
+		fold(global);
+
+		return static_cast<uint32_t>(h ^ (h >> 32));
+	}
+
+	bool operator==(const solvable_signi_hashes& b) const {
+		return
+			pools == b.pools
+			&& clock == b.clock
+			&& specific_names == b.specific_names
+			&& global == b.global
+		;
+	}
+
+	/*
+		Lists all partial hashes.
+		Entries that changed since "reference" are marked,
+		e.g. since the last step at which the state was known to be in sync.
+	*/
+
+	std::string describe(const solvable_signi_hashes* reference = nullptr) const;
+};
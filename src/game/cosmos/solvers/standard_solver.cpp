@@ -176,6 +176,7 @@ void standard_solve(const logic_step step) {
 		missile_system().ricochet_missiles(step);
 		missile_system().detonate_colliding_missiles(step);
 		missile_system().detonate_expired_missiles(step);
+		missile_system().advance_lightweight_projectiles(step);
 	}
 
 	destruction_system().generate_damages_from_forceful_collisions(step);
@@ -1,9 +1,12 @@
 #if !PRODUCTION_BUILD
 #if BUILD_UNIT_TESTS
 #include "augs/log_direct.h"
+#include "augs/log.h"
 #include <Catch/single_include/catch2/catch.hpp>
 #include <cstring>
 #include <array>
+#include <memory>
+#include <random>
 
 #include "augs/filesystem/file.h"
 #include "augs/templates/introspection_utils/describe_fields.h"
@@ -11,6 +14,7 @@
 #include "augs/readwrite/delta_compression.h"
 
 #include "game/cosmos/cosmos.h"
+#include "game/cosmos/change_common_significant.hpp"
 #include "game/cosmos/cosmic_delta.h"
 #include "game/organization/all_component_includes.h"
 #include "game/organization/for_each_component_type.h"
@@ -20,6 +24,8 @@
 #include "augs/readwrite/byte_readwrite.h"
 #include "augs/readwrite/lua_readwrite.h"
 #include "augs/log_path_getters.h"
+#include "game/cosmos/entity_solvable.h"
+#include "game/organization/all_entity_types.h"
 
 TEST_CASE("StateTest0 PaddingSanityCheck1") {
 	struct ok {
@@ -217,5 +223,115 @@ TEST_CASE("StateTest2 PaddingTest") {
 	);
 #endif
 }
+
+template <class T>
+void check_object_delta(const unsigned changed_runs) {
+	using offset_type = get_index_type_for_size_of_t<T>;
+
+	/* The per-byte loop that object_delta used before, kept as the reference. */
+
+	auto reference_delta = [](const T& base, const T& enco, std::vector<std::byte>& changed_bytes, std::vector<offset_type>& changed_offsets) {
+		const auto* const base_ptr = reinterpret_cast<const std::byte*>(std::addressof(base));
+		const auto* const enco_ptr = reinterpret_cast<const std::byte*>(std::addressof(enco));
+
+		thread_local std::vector<char> diff_flags;
+		diff_flags.resize(sizeof(T));
+
+		for (std::size_t i = 0; i < sizeof(T); ++i) {
+			if (base_ptr[i] == enco_ptr[i]) {
+				diff_flags[i] = 0;
+			}
+			else {
+				diff_flags[i] = 1;
+				changed_bytes.push_back(enco_ptr[i]);
+			}
+		}
+
+		changed_offsets = augs::run_length_encoding<offset_type>(diff_flags);
+	};
+
+	const auto base = std::make_unique<T>();
+	const auto enco = std::make_unique<T>();
+
+	{
+		auto* const enco_ptr = reinterpret_cast<std::byte*>(enco.get());
+		std::minstd_rand rng(static_cast<unsigned>(sizeof(T)));
+
+		for (unsigned r = 0; r < changed_runs; ++r) {
+			const auto run_begin = rng() % sizeof(T);
+			const auto run_end = std::min(sizeof(T), run_begin + 1 + rng() % 24);
+
+			for (auto i = run_begin; i < run_end; ++i) {
+				enco_ptr[i] ^= std::byte(0x5a);
+			}
+		}
+	}
+
+	std::vector<std::byte> reference_bytes;
+	std::vector<offset_type> reference_offsets;
+
+	reference_delta(*base, *enco, reference_bytes, reference_offsets);
+
+	{
+		const auto dt = augs::object_delta<T>(*base, *enco);
+
+		REQUIRE(dt.get_changed_bytes() == reference_bytes);
+		REQUIRE(dt.get_changed_offsets() == reference_offsets);
+
+		auto decoded = std::make_unique<T>(*base);
+		dt.decode_into(*decoded);
+
+		REQUIRE(0 == std::memcmp(decoded.get(), enco.get(), sizeof(T)));
+	}
+}
+
+/* For the timings, see --benchmark-delta. */
+
+TEST_CASE("StateTest3 DeltaEncodingMatchesPerByteLoop") {
+	auto check = [](auto dummy) {
+		using E = decltype(dummy);
+		using S = entity_solvable<E>;
+
+		if constexpr(std::is_trivially_copyable_v<S>) {
+			check_object_delta<S>(0);
+			check_object_delta<S>(4);
+			check_object_delta<S>(64);
+		}
+	};
+
+	check(controlled_character());
+	check(shootable_weapon());
+	check(plain_missile());
+}
+
+TEST_CASE("StateTest4 CommonSharedUntilChanged") {
+	auto source = std::make_unique<cosmos>();
+	auto copy = std::make_unique<cosmos>(*source);
+
+	REQUIRE(&copy->get_common_significant() == &source->get_common_significant());
+
+	copy->change_common_significant([](cosmos_common_significant& common) {
+		common.ambient_light_color = rgba(1, 2, 3, 4);
+		return changer_callback_result::DONT_REFRESH;
+	});
+
+	REQUIRE(&copy->get_common_significant() != &source->get_common_significant());
+	REQUIRE(copy->get_common_significant().ambient_light_color == rgba(1, 2, 3, 4));
+	REQUIRE(source->get_common_significant().ambient_light_color != rgba(1, 2, 3, 4));
+
+	/* Nobody shares it anymore, so it is changed in place. */
+
+	const auto* const detached = &copy->get_common_significant();
+
+	copy->change_common_significant([](cosmos_common_significant& common) {
+		common.ambient_light_color = rgba(5, 6, 7, 8);
+		return changer_callback_result::DONT_REFRESH;
+	});
+
+	REQUIRE(&copy->get_common_significant() == detached);
+
+	*source = *copy;
+	REQUIRE(&source->get_common_significant() == detached);
+}
 #endif
 #endif
@@ -0,0 +1,162 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+
+#include "augs/math/vec2.h"
+
+/*
+	The rules by which a single round simulated without a body
+	treats the surfaces its displacement crossed in one step.
+
+	They mirror collide_missile_against_surface and ricochet_missile_against_surface,
+	but only work on what was already read from the surfaces,
+	so that missile_system can post the messages and play the effects on its own.
+*/
+
+struct lightweight_sweep_hit {
+	vec2 point;
+	vec2 normal;
+	real32 max_ricochet_angle = 0.f;
+
+	/* See missile_surface_info. */
+	bool ignored = false;
+	bool ricochetable = false;
+	bool detonates = false;
+
+	/*
+		Whether the contact with a body would be solved at all.
+		Sentient bodies and fly-through fixtures never stop a missile.
+	*/
+
+	bool blocking = false;
+};
+
+struct lightweight_sweep_input {
+	vec2 position;
+	vec2 velocity;
+	real32 dt = 0.f;
+
+	int charges = 1;
+	bool destroy_upon_damage = true;
+
+	bool ricochet_cooldown = false;
+	bool born_cooldown = false;
+};
+
+struct lightweight_sweep_result {
+	vec2 position;
+	vec2 velocity;
+	int charges = 0;
+
+	bool ricocheted = false;
+	bool removed = false;
+};
+
+/*
+	hits must be sorted front to back.
+
+	on_damage(hit_index, destructed) is called for every surface that gets damaged,
+	on_ricochet(hit_index, reflected_dir, angle_mult) for the surface that the round ricocheted off.
+*/
+
+template <class OnDamage, class OnRicochet>
+lightweight_sweep_result sweep_lightweight_projectile(
+	const lightweight_sweep_input in,
+	const std::vector<lightweight_sweep_hit>& hits,
+	OnDamage&& on_damage,
+	OnRicochet&& on_ricochet
+) {
+	lightweight_sweep_result result;
+
+	result.position = in.position + in.velocity * in.dt;
+	result.velocity = in.velocity;
+	result.charges = in.charges;
+
+	if (in.ricochet_cooldown) {
+		/* Just ricocheted. Just like with a missile entity, nothing is impacted for this step. */
+		return result;
+	}
+
+	const auto impact_velocity = in.velocity;
+	const auto impact_speed = impact_velocity.length();
+
+	if (impact_speed <= 0.f) {
+		return result;
+	}
+
+	const auto impact_dir = impact_velocity / impact_speed;
+
+	for (std::size_t i = 0; i < hits.size(); ++i) {
+		const auto& hit = hits[i];
+
+		if (hit.ignored) {
+			continue;
+		}
+
+		const auto collision_normal = vec2(hit.normal).normalize();
+
+		if (hit.ricochetable && impact_dir.dot(collision_normal) < 0.f && !in.born_cooldown) {
+			const auto hit_facing = impact_dir.degrees_between(collision_normal);
+
+			const auto left_b = 90 - hit.max_ricochet_angle;
+			const auto right_b = 90 + hit.max_ricochet_angle;
+
+			if (hit_facing > left_b && hit_facing < right_b) {
+				const auto angle = std::min(hit_facing - left_b, right_b - hit_facing);
+				const auto angle_mult = angle / hit.max_ricochet_angle;
+
+				const auto reflected_dir = vec2(impact_dir).reflect(collision_normal);
+
+				/* The rest of the distance is lost, just like with a body whose contact was solved. */
+				result.position = hit.point + collision_normal;
+				result.velocity = reflected_dir * impact_speed;
+				result.ricocheted = true;
+
+				on_ricochet(i, reflected_dir, angle_mult);
+				return result;
+			}
+		}
+
+		if (result.charges <= 0) {
+			return result;
+		}
+
+		if (hit.detonates && in.destroy_upon_damage) {
+			--result.charges;
+
+			if (result.charges == 0) {
+				result.position = hit.point;
+				result.removed = true;
+			}
+		}
+
+		on_damage(i, result.removed);
+
+		if (result.removed) {
+			return result;
+		}
+
+		if (hit.blocking) {
+			/*
+				A body would have been stopped here.
+				A round without one can't come to rest, so it is dropped at the surface.
+			*/
+
+			result.position = hit.point;
+			result.removed = true;
+			return result;
+		}
+	}
+
+	return result;
+}
+
+inline bool lightweight_projectile_expired(
+	const unsigned fired_step,
+	const unsigned now_step,
+	const real32 max_lifetime_ms,
+	const real32 step_ms
+) {
+	const auto fuse_delay_steps = static_cast<unsigned>(max_lifetime_ms / step_ms);
+	return now_step >= fired_step + fuse_delay_steps;
+}
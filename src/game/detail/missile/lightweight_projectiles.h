@@ -0,0 +1,116 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+#include "augs/math/vec2.h"
+#include "augs/misc/timing/stepped_timing.h"
+#include "augs/misc/randomization_declaration.h"
+
+#include "game/components/sender_component.h"
+#include "game/cosmos/entity_flavour_id.h"
+
+/*
+	Rounds whose flavour sets invariants::missile::simulate_without_body
+	are never created as entities and never get a b2Body.
+
+	Instead, they are kept here and every step, after the physics world was stepped,
+	missile_system sweeps each of them with a single raycast along the distance it travels in that step.
+	Whatever the ray hits is then damaged or ricocheted off just like by a missile entity.
+
+	The rounds are stored as a structure of arrays so that a sweep over all of them
+	only touches the arrays it needs. Every array always has the same length,
+	and rounds are only ever appended or removed with the order preserved,
+	so the simulation stays deterministic.
+*/
+
+/* Same as invariants::cartridge::round_flavour_type. */
+
+using lightweight_round_flavour_type = constrained_entity_flavour_id<
+	invariants::rigid_body, 
+	invariants::missile, 
+	components::sender
+>;
+
+struct lightweight_projectile {
+	vec2 position;
+	vec2 velocity;
+	lightweight_round_flavour_type flavour;
+	components::sender sender;
+	real32 power_multiplier_of_sender = 1.f;
+	int damage_charges_before_destruction = 1;
+	augs::stepped_timestamp when_fired;
+	rng_seed_type rng_seed = 0;
+};
+
+struct lightweight_projectiles {
+	// GEN INTROSPECTOR struct lightweight_projectiles
+	std::vector<vec2> positions;
+	std::vector<vec2> velocities;
+	std::vector<lightweight_round_flavour_type> flavours;
+	std::vector<components::sender> senders;
+	std::vector<real32> power_multipliers_of_sender;
+	std::vector<int> damage_charges_before_destruction;
+	std::vector<augs::stepped_timestamp> when_fired;
+	std::vector<augs::stepped_timestamp> when_last_ricocheted;
+	std::vector<rng_seed_type> rng_seeds;
+	// END GEN INTROSPECTOR
+
+	template <class F>
+	void for_each_array(F&& callback) {
+		callback(positions);
+		callback(velocities);
+		callback(flavours);
+		callback(senders);
+		callback(power_multipliers_of_sender);
+		callback(damage_charges_before_destruction);
+		callback(when_fired);
+		callback(when_last_ricocheted);
+		callback(rng_seeds);
+	}
+
+	void push_back(const lightweight_projectile& p) {
+		positions.push_back(p.position);
+		velocities.push_back(p.velocity);
+		flavours.push_back(p.flavour);
+		senders.push_back(p.sender);
+		power_multipliers_of_sender.push_back(p.power_multiplier_of_sender);
+		damage_charges_before_destruction.push_back(p.damage_charges_before_destruction);
+		when_fired.push_back(p.when_fired);
+		when_last_ricocheted.push_back(augs::stepped_timestamp());
+		rng_seeds.push_back(p.rng_seed);
+	}
+
+	/* Removes every round i for which removed[i] is set, preserving the order of the rest. */
+
+	void erase_flagged(const std::vector<uint8_t>& removed) {
+		for_each_array([&](auto& arr) {
+			std::size_t w = 0;
+
+			for (std::size_t i = 0; i < arr.size(); ++i) {
+				if (!removed[i]) {
+					if (w != i) {
+						arr[w] = std::move(arr[i]);
+					}
+
+					++w;
+				}
+			}
+
+			arr.resize(w);
+		});
+	}
+
+	void clear() {
+		for_each_array([](auto& arr) {
+			arr.clear();
+		});
+	}
+
+	std::size_t size() const {
+		return positions.size();
+	}
+
+	bool empty() const {
+		return positions.empty();
+	}
+};
@@ -119,34 +119,7 @@ static void ricochet_missile_against_surface(
 
 		::play_collision_sound(angle_mult * 150.f, point, typed_missile, surface_handle, step);
 
-		const auto effect_transform = transformr(point, reflected_dir.degrees());
-
-		{
-			const auto& effect = missile_def.ricochet_particles;
-
-			effect.start(
-				step,
-				particle_effect_start_input::fire_and_forget(effect_transform),
-				always_predictable_v
-			);
-		}
-
-		{
-			const auto pitch = 0.7f + angle_mult / 1.5f;
-
-			auto effect = missile_def.ricochet_sound;
-			effect.modifier.pitch = pitch;
-
-			// TODO: PARAMETRIZE!
-			effect.modifier.max_distance = 3000.f;
-			effect.modifier.reference_distance = 1000.f;
-
-			effect.start(
-				step,
-				sound_effect_start_input::fire_and_forget(effect_transform),
-				always_predictable_v
-			);
-		}
+		::play_ricochet_effects(step, missile_def, point, reflected_dir, angle_mult);
 	}
 	else {
 		RIC_LOG("Not enough facing. IGNORED.");
@@ -8,6 +8,43 @@ void play_collision_sound(
 	const logic_step step
 );
 
+static void play_ricochet_effects(
+	const logic_step step,
+	const invariants::missile& missile_def,
+	const vec2& point,
+	const vec2& reflected_dir,
+	const real32 angle_mult
+) {
+	const auto effect_transform = transformr(point, reflected_dir.degrees());
+
+	{
+		const auto& effect = missile_def.ricochet_particles;
+
+		effect.start(
+			step,
+			particle_effect_start_input::fire_and_forget(effect_transform),
+			always_predictable_v
+		);
+	}
+
+	{
+		const auto pitch = 0.7f + angle_mult / 1.5f;
+
+		auto effect = missile_def.ricochet_sound;
+		effect.modifier.pitch = pitch;
+
+		// TODO: PARAMETRIZE!
+		effect.modifier.max_distance = 3000.f;
+		effect.modifier.reference_distance = 1000.f;
+
+		effect.start(
+			step,
+			sound_effect_start_input::fire_and_forget(effect_transform),
+			always_predictable_v
+		);
+	}
+}
+
 template <class R, class F>
 static void spawn_bullet_remnants(
 	const logic_step step,
@@ -6,27 +6,13 @@ class missile_surface_info {
 	bool ignore_altogether = false;
 	bool is_fly_through = false;
 
-public:
-	bool surface_is_item = false;
-	bool surface_is_held_item = false;
-	bool surface_is_lying_item = false;
-	bool surface_is_missile = false;
-
-	entity_id surface_capability;
-
-	template <class A, class B>
-	missile_surface_info(
-		const A missile,
+	template <class B>
+	void classify(
+		const components::sender& missile_sender,
+		const bool same_kind_as_surface,
 		const B surface
 	) {
-		const auto& missile_sender = missile.template get<components::sender>();
-
-		if ((missile.template has<components::missile>() 
-			&& surface.template has<components::missile>())
-			||
-			(missile.template has<components::melee>() 
-			&& surface.template has<components::melee>())
-		) {
+		if (same_kind_as_surface) {
 			/* Prevent bullets coming from the same weapon or character from colliding with each other */
 
 			if (const auto surface_sender = surface.template find<components::sender>()) {
@@ -57,6 +43,40 @@ public:
 		is_fly_through = surface_is_missile || ignore_altogether || surface_is_lying_item || surface.template get<invariants::fixtures>().bullets_fly_through;
 	}
 
+public:
+	bool surface_is_item = false;
+	bool surface_is_held_item = false;
+	bool surface_is_lying_item = false;
+	bool surface_is_missile = false;
+
+	entity_id surface_capability;
+
+	template <class A, class B>
+	missile_surface_info(
+		const A missile,
+		const B surface
+	) {
+		const bool same_kind_as_surface = 
+			(missile.template has<components::missile>() 
+			&& surface.template has<components::missile>())
+			||
+			(missile.template has<components::melee>() 
+			&& surface.template has<components::melee>())
+		;
+
+		classify(missile.template get<components::sender>(), same_kind_as_surface, surface);
+	}
+
+	/* For missiles simulated without an entity of their own. */
+
+	template <class B>
+	missile_surface_info(
+		const components::sender& missile_sender,
+		const B surface
+	) {
+		classify(missile_sender, surface.template has<components::missile>(), surface);
+	}
+
 	bool should_ignore_altogether() const {
 		return ignore_altogether;
 	}
@@ -9,9 +9,8 @@ struct raycast_input : public b2RayCastCallback {
 	entity_id subject;
 	b2Filter subject_filter;
 
-	bool save_all = false;
 	physics_raycast_output output;
-	std::vector<physics_raycast_output> outputs;
+	std::vector<physics_raycast_output>* outputs = nullptr;
 
 	bool ShouldRaycast(b2Fixture* fixture) override;
 	float32 ReportFixture(b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal, float32 fraction) override;
@@ -34,10 +33,12 @@ float32 raycast_input::ReportFixture(
 
 	output.hit = true;
 	output.what_entity = fixture->GetBody()->GetUserData();
+	output.what_fixture_entity = fixture->GetUserData();
 	output.normal = normal;
+	output.fraction = fraction;
 
-	if (save_all) {
-		outputs.push_back(output);
+	if (outputs != nullptr) {
+		outputs->push_back(output);
 		return 1.f;
 	}
 
@@ -50,18 +51,31 @@ std::vector<physics_raycast_output> physics_world_cache::ray_cast_all_intersecti
 	const b2Filter filter, 
 	const entity_id ignore_entity
 ) const {
+	std::vector<physics_raycast_output> output;
+	ray_cast_all_intersections(output, p1_meters, p2_meters, filter, ignore_entity);
+	return output;
+}
+
+void physics_world_cache::ray_cast_all_intersections(
+	std::vector<physics_raycast_output>& output,
+	const vec2 p1_meters, 
+	const vec2 p2_meters, 
+	const b2Filter filter, 
+	const entity_id ignore_entity
+) const {
+	output.clear();
+
 	raycast_input callback;
 	callback.subject = ignore_entity;
 	callback.subject_filter = filter;
-	callback.save_all = true;
+	callback.outputs = std::addressof(output);
 
 	if (!((p1_meters - p2_meters).length_sq() > 0.f)) {
 		//LOG("Ray casting error: X: %x %x", p1_meters, p2_meters);
-		return callback.outputs;
+		return;
 	}
 
 	b2world->RayCast(&callback, b2Vec2(p1_meters), b2Vec2(p2_meters));
-	return callback.outputs;
 }
 
 float physics_world_cache::get_closest_wall_intersection(
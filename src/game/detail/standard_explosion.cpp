@@ -50,7 +50,7 @@ void standard_explosion_input::instantiate(
 
 	if (create_thunders_effect) {
 		for (int t = 0; t < 4; ++t) {
-			static randomization rng;
+			thread_local randomization rng;
 			auto msg = messages::thunder_effect(predictability);
 			auto& th = msg.payload;
 
@@ -0,0 +1,642 @@
+#define DEBUG_PHYSICS_SYSTEM_COPY 0
+#include "3rdparty/Box2D/Box2D.h"
+
+#include <cstring>
+#include <unordered_set>
+
+#include "augs/ensure.h"
+#include "augs/ensure_rel.h"
+#include "augs/build_settings/offsetof.h"
+#include "augs/templates/dynamic_cast_dispatch.h"
+
+#include "game/inferred_caches/b2world_cloner.h"
+
+bool b2world_cloner::can_clone_by_chunks(const b2World& world) {
+	if (world.m_blockAllocator.GetNumLargeAllocations() > 0) {
+		return false;
+	}
+
+	/* Chain shapes keep their vertices outside of the allocator. */
+
+	for (const b2Body* b = world.m_bodyList; b; b = b->m_next) {
+		for (const b2Fixture* f = b->m_fixtureList; f; f = f->m_next) {
+			if (f->m_shape->GetType() == b2Shape::e_chain) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void b2world_cloner::clone(b2World& target, const b2World& source) {
+	if (can_clone_by_chunks(source)) {
+		clone_by_chunks(target, source);
+	}
+	else {
+		clone_by_objects(target, source);
+	}
+}
+
+void* b2world_cloner::migrated(const void* const source_object) const {
+	if (source_object == nullptr) {
+		return nullptr;
+	}
+
+	if (chunk_migrations != nullptr) {
+		return chunk_migrations->MigrateFromSource(source_object);
+	}
+
+	return pointer_migrations.at(source_object);
+}
+
+void b2world_cloner::copy_trivially(b2World& target, const b2World& source) {
+#if DEBUG_PHYSICS_SYSTEM_COPY
+	ensure_eq(0, source.m_stackAllocator.m_entryCount);
+	ensure_eq(0, source.m_stackAllocator.m_index);
+#endif
+
+	ensure_eq(static_cast<const b2ContactListener*>(source.m_contactManager.m_contactListener), &source.defaultListener);
+
+	// do the initial trivial copy of all fields,
+	// we will migrate all pointers shortly
+	target = source;
+
+	{
+#if DEBUG_PHYSICS_SYSTEM_COPY
+		ensure_eq(0, target.m_stackAllocator.m_entryCount);
+		ensure_eq(0, target.m_stackAllocator.m_index);
+#endif
+
+		b2StackEntry null_entry;
+		null_entry.data = nullptr;
+
+		auto& entries = target.m_stackAllocator.m_entries;
+		std::fill(std::begin(entries), std::end(entries), null_entry);
+	}
+
+	/*
+	   	b2BlockAllocator has a null operator=,
+		so the target preserves its own allocator even after the above copy.
+	*/
+
+	// reset the allocator pointer to the new one
+	target.m_contactManager.m_allocator = &target.m_blockAllocator;
+	target.m_contactManager.m_contactFilter = &target.defaultFilter;
+	target.m_contactManager.m_contactListener = &target.defaultListener;
+}
+
+void b2world_cloner::clone_by_chunks(b2World& target, const b2World& source) {
+	ensure(std::addressof(target) != std::addressof(source));
+	ensure(can_clone_by_chunks(source));
+
+	if (!can_clone_by_chunks(target)) {
+		/* Release whatever the target keeps outside of its chunks. */
+
+		target.~b2World();
+		new (&target) b2World(b2Vec2(0.f, 0.f));
+	}
+
+	copy_trivially(target, source);
+
+	auto& allocator = target.m_blockAllocator;
+	allocator.CloneChunksFrom(source.m_blockAllocator);
+
+	chunk_migrations = &allocator;
+
+	/*
+		Every object now sits at the same offset in our chunk as it did in the source's chunk,
+		including the edges embedded inside contacts and joints,
+		so each pointer can be migrated independently of the others.
+	*/
+
+	auto migrate = [&allocator](auto*& p) {
+		using T = std::remove_reference_t<decltype(*p)>;
+		p = reinterpret_cast<T*>(allocator.MigrateFromSource(p));
+	};
+
+	migrate(target.m_contactManager.m_contactList);
+
+	for (b2Contact* c = target.m_contactManager.m_contactList; c; c = c->m_next) {
+		migrate(c->m_prev);
+		migrate(c->m_next);
+		migrate(c->m_fixtureA);
+		migrate(c->m_fixtureB);
+
+		c->m_nodeA.contact = c;
+		migrate(c->m_nodeA.other);
+		migrate(c->m_nodeA.prev);
+		migrate(c->m_nodeA.next);
+
+		c->m_nodeB.contact = c;
+		migrate(c->m_nodeB.other);
+		migrate(c->m_nodeB.prev);
+		migrate(c->m_nodeB.next);
+	}
+
+	migrate(target.m_jointList);
+
+	for (b2Joint* j = target.m_jointList; j; j = j->m_next) {
+		migrate(j->m_prev);
+		migrate(j->m_next);
+		migrate(j->m_bodyA);
+		migrate(j->m_bodyB);
+
+		j->m_edgeA.joint = j;
+		migrate(j->m_edgeA.other);
+		migrate(j->m_edgeA.prev);
+		migrate(j->m_edgeA.next);
+
+		j->m_edgeB.joint = j;
+		migrate(j->m_edgeB.other);
+		migrate(j->m_edgeB.prev);
+		migrate(j->m_edgeB.next);
+	}
+
+	auto& proxy_tree = target.m_contactManager.m_broadPhase.m_tree;
+
+	migrate(target.m_bodyList);
+
+	for (b2Body* b = target.m_bodyList; b; b = b->m_next) {
+		migrate(b->m_fixtureList);
+		migrate(b->m_prev);
+		migrate(b->m_next);
+		migrate(b->m_ownerFrictionGround);
+
+		migrate(b->m_contactList);
+		migrate(b->m_jointList);
+		b->m_world = &target;
+
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next) {
+			f->m_body = b;
+
+			migrate(f->m_proxies);
+			migrate(f->m_shape);
+			migrate(f->m_next);
+
+			for (int32 i = 0; i < f->m_proxyCount; ++i) {
+				f->m_proxies[i].fixture = f;
+
+				void*& ud = proxy_tree.m_nodes[f->m_proxies[i].proxyId].userData;
+				ud = allocator.MigrateFromSource(ud);
+			}
+		}
+	}
+}
+
+void b2world_cloner::clone_by_objects(b2World& migrated_b2World, const b2World& source_b2World) {
+	ensure(std::addressof(migrated_b2World) != std::addressof(source_b2World));
+
+	chunk_migrations = nullptr;
+
+	pointer_migrations.clear();
+	contact_edge_a_or_b_in_contacts.clear();
+	joint_edge_a_or_b_in_joints.clear();
+
+	migrated_b2World.~b2World();
+	new (&migrated_b2World) b2World(b2Vec2(0.f, 0.f));
+
+	copy_trivially(migrated_b2World, source_b2World);
+
+	b2BlockAllocator& migrated_allocator = migrated_b2World.m_blockAllocator;
+
+	const auto contact_edge_a_offset = augs_offsetof(b2Contact, m_nodeA);
+	const auto contact_edge_b_offset = augs_offsetof(b2Contact, m_nodeB);
+
+	const auto joint_edge_a_offset = augs_offsetof(b2Joint, m_edgeA);
+	const auto joint_edge_b_offset = augs_offsetof(b2Joint, m_edgeB);
+
+#if DEBUG_PHYSICS_SYSTEM_COPY
+	std::unordered_set<void**> already_migrated_pointers;
+#endif
+
+	auto migrate_pointer = [
+#if DEBUG_PHYSICS_SYSTEM_COPY
+		&already_migrated_pointers,
+#endif
+		this,
+		&migrated_allocator
+	](
+		auto*& pointer_to_be_migrated,
+		const unsigned count = 1
+	) {
+#if DEBUG_PHYSICS_SYSTEM_COPY
+		ensure(already_migrated_pointers.find(reinterpret_cast<void**>(&pointer_to_be_migrated)) == already_migrated_pointers.end());
+		already_migrated_pointers.insert(reinterpret_cast<void**>(&pointer_to_be_migrated));
+#endif
+
+		using type = std::remove_pointer_t<std::remove_reference_t<decltype(pointer_to_be_migrated)>>;
+		static_assert(!std::is_same_v<type, b2Joint>, "Can't migrate an abstract base class");
+
+		const auto void_ptr = reinterpret_cast<const void*>(pointer_to_be_migrated);
+
+		if (pointer_to_be_migrated == nullptr) {
+			return;
+		}
+
+		if (
+			auto maybe_already_migrated = pointer_migrations.find(void_ptr);
+			maybe_already_migrated == pointer_migrations.end()
+		) {
+			const auto bytes_count = std::size_t{ sizeof(type) * count };
+
+			void* const migrated_pointer = migrated_allocator.Allocate(static_cast<int32>(bytes_count));
+			std::memcpy(migrated_pointer, void_ptr, bytes_count);
+
+			/* Bookmark position in memory of each and every element */
+
+			pointer_migrations.insert(std::make_pair(
+				void_ptr,
+				migrated_pointer
+			));
+
+			pointer_to_be_migrated = reinterpret_cast<type*>(migrated_pointer);
+		}
+		else {
+			pointer_to_be_migrated = reinterpret_cast<type*>((*maybe_already_migrated).second);
+		}
+	};
+
+	// migration of contacts and contact edges
+
+	auto migrate_contact_edge = [
+#if DEBUG_PHYSICS_SYSTEM_COPY
+		&already_migrated_pointers,
+#endif
+		this,
+		contact_edge_a_offset,
+		contact_edge_b_offset
+	](b2ContactEdge*& edge_ptr) {
+#if DEBUG_PHYSICS_SYSTEM_COPY
+		ensure(already_migrated_pointers.find((void**)&edge_ptr) == already_migrated_pointers.end());
+		already_migrated_pointers.insert((void**)&edge_ptr);
+#endif
+		if (edge_ptr == nullptr) {
+			return;
+		}
+
+		const bool a_or_b_in_contact { contact_edge_a_or_b_in_contacts.at(edge_ptr) };
+		const auto offset_to_edge_in_contact = std::size_t{ !a_or_b_in_contact ? contact_edge_a_offset : contact_edge_b_offset };
+
+		std::byte* const contact_that_owns_unmigrated_edge = reinterpret_cast<std::byte*>(edge_ptr) - offset_to_edge_in_contact;
+		// here "at" requires that the contacts be already migrated
+		std::byte* const migrated_contact = reinterpret_cast<std::byte*>(pointer_migrations.at(contact_that_owns_unmigrated_edge));
+		std::byte* const edge_from_migrated_contact = migrated_contact + offset_to_edge_in_contact;
+
+		edge_ptr = reinterpret_cast<b2ContactEdge*>(edge_from_migrated_contact);
+	};
+
+	// make a map of pointers to b2ContactEdges to their respective offsets in
+	// the b2Contacts that own them
+	for (b2Contact* c = migrated_b2World.m_contactManager.m_contactList; c; c = c->m_next) {
+		contact_edge_a_or_b_in_contacts.insert(std::make_pair(&c->m_nodeA, false));
+		contact_edge_a_or_b_in_contacts.insert(std::make_pair(&c->m_nodeB, true));
+	}
+
+	// migrate contact pointers
+	// contacts are polymorphic, but their derived classes do not add any member fields.
+	// thus, it is safe to just memcpy sizeof(b2Contact)
+
+	migrate_pointer(migrated_b2World.m_contactManager.m_contactList);
+
+	for (b2Contact* c = migrated_b2World.m_contactManager.m_contactList; c; c = c->m_next) {
+		migrate_pointer(c->m_prev);
+		migrate_pointer(c->m_next);
+		migrate_pointer(c->m_fixtureA);
+		migrate_pointer(c->m_fixtureB);
+
+		c->m_nodeA.contact = c;
+		migrate_pointer(c->m_nodeA.other);
+
+		c->m_nodeB.contact = c;
+		migrate_pointer(c->m_nodeB.other);
+	}
+
+	// migrate contact edges of contacts
+	for (b2Contact* c = migrated_b2World.m_contactManager.m_contactList; c; c = c->m_next) {
+		migrate_contact_edge(c->m_nodeA.next);
+		migrate_contact_edge(c->m_nodeA.prev);
+
+		migrate_contact_edge(c->m_nodeB.next);
+		migrate_contact_edge(c->m_nodeB.prev);
+	}
+
+	// migration of joints and joint edges
+
+	auto migrate_joint_edge = [
+#if DEBUG_PHYSICS_SYSTEM_COPY
+		&already_migrated_pointers,
+#endif
+		this,
+		joint_edge_a_offset,
+		joint_edge_b_offset
+	](b2JointEdge*& edge_ptr) {
+#if DEBUG_PHYSICS_SYSTEM_COPY
+		ensure(already_migrated_pointers.find((void**)&edge_ptr) == already_migrated_pointers.end());
+		already_migrated_pointers.insert((void**)&edge_ptr);
+#endif
+		if (edge_ptr == nullptr) {
+			return;
+		}
+
+		const bool a_or_b_in_joint { joint_edge_a_or_b_in_joints.at(edge_ptr) };
+		const auto offset_to_edge_in_joint = std::size_t { !a_or_b_in_joint ? joint_edge_a_offset : joint_edge_b_offset };
+
+		std::byte* const joint_that_owns_unmigrated_edge = reinterpret_cast<std::byte*>(edge_ptr) - offset_to_edge_in_joint;
+		// here "at" requires that the joints be already migrated
+		std::byte* const migrated_joint = reinterpret_cast<std::byte*>(pointer_migrations.at(joint_that_owns_unmigrated_edge));
+		std::byte* const edge_from_migrated_joint = migrated_joint + offset_to_edge_in_joint;
+
+		edge_ptr = reinterpret_cast<b2JointEdge*>(edge_from_migrated_joint);
+	};
+
+	auto migrate_joint = [&migrate_pointer](b2Joint*& j){
+		if (j == nullptr) {
+			return;
+		}
+
+		dynamic_cast_dispatch<
+			b2MotorJoint, // most likely
+
+			b2DistanceJoint,
+			b2FrictionJoint,
+			b2GearJoint,
+			b2MouseJoint,
+			b2PrismaticJoint,
+			b2PulleyJoint,
+			b2RevoluteJoint,
+			b2RopeJoint,
+			b2WeldJoint,
+			b2WheelJoint
+		>(j, [&j, &migrate_pointer](auto* derived){
+			using derived_type = std::remove_pointer_t<decltype(derived)>;
+			// static_assert(std::is_same_v<derived_type, b2MotorJoint>, "test failed");
+			migrate_pointer(reinterpret_cast<derived_type*&>(j));
+		});
+	};
+
+	// make a map of pointers to b2JointEdges to their respective offsets in
+	// the b2Joints that own them
+	for (b2Joint* j = migrated_b2World.m_jointList; j; j = j->m_next) {
+		joint_edge_a_or_b_in_joints.insert(std::make_pair(&j->m_edgeA, false));
+		joint_edge_a_or_b_in_joints.insert(std::make_pair(&j->m_edgeB, true));
+	}
+
+	// migrate joint pointers
+	migrate_joint(migrated_b2World.m_jointList);
+
+	for (b2Joint* c = migrated_b2World.m_jointList; c; c = c->m_next) {
+		migrate_joint(c->m_prev);
+		migrate_joint(c->m_next);
+		migrate_pointer(c->m_bodyA);
+		migrate_pointer(c->m_bodyB);
+
+		c->m_edgeA.joint = c;
+		migrate_pointer(c->m_edgeA.other);
+
+		c->m_edgeB.joint = c;
+		migrate_pointer(c->m_edgeB.other);
+	}
+
+	// migrate joint edges of joints
+	for (b2Joint* c = migrated_b2World.m_jointList; c; c = c->m_next) {
+		migrate_joint_edge(c->m_edgeA.next);
+		migrate_joint_edge(c->m_edgeA.prev);
+
+		migrate_joint_edge(c->m_edgeB.next);
+		migrate_joint_edge(c->m_edgeB.prev);
+	}
+
+	auto& proxy_tree = migrated_b2World.m_contactManager.m_broadPhase.m_tree;
+
+	// migrate bodies and fixtures
+	migrate_pointer(migrated_b2World.m_bodyList);
+
+	for (b2Body* b = migrated_b2World.m_bodyList; b; b = b->m_next) {
+		migrate_pointer(b->m_fixtureList);
+		migrate_pointer(b->m_prev);
+		migrate_pointer(b->m_next);
+		migrate_pointer(b->m_ownerFrictionGround);
+
+		migrate_contact_edge(b->m_contactList);
+		migrate_joint_edge(b->m_jointList);
+		b->m_world = &migrated_b2World;
+
+		/*
+			b->m_fixtureList is already migrated.
+			f->m_next will also be always migrated before the next iteration
+			thus f is always already a migrated instance.
+		*/
+
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next) {
+			f->m_body = b;
+
+			migrate_pointer(f->m_proxies, f->m_proxyCount);
+			f->m_shape = f->m_shape->Clone(&migrated_allocator);
+			migrate_pointer(f->m_next);
+
+			for (std::size_t i = 0; i < f->m_proxyCount; ++i) {
+#if DEBUG_PHYSICS_SYSTEM_COPY
+				/*
+					"fixture" field of b2FixtureProxy should point to the fixture itself,
+					thus its value should already be found in the pointer map.
+				*/
+
+				ensure(pointer_migrations.find(f->m_proxies[i].fixture) != pointer_migrations.end())
+
+				{
+					const auto ff = pointer_migrations[f->m_proxies[i].fixture];
+					ensure_eq(reinterpret_cast<void*>(f), ff);
+				}
+#endif
+				f->m_proxies[i].fixture = f;
+
+				void*& ud = proxy_tree.m_nodes[f->m_proxies[i].proxyId].userData;
+				ud = pointer_migrations.at(ud);
+			}
+		}
+	}
+
+	/*
+		There is no need to iterate userdatas of the broadphase's dynamic tree,
+		as for every existing b2FixtureProxy we have manually migrated the correspondent userdata
+		inside the loop that migrated all bodies and fixtures.
+	*/
+
+#if DEBUG_PHYSICS_SYSTEM_COPY
+	// ensure that all allocations have been migrated
+
+	ensure_eq(
+		migrated_allocator.m_numAllocatedObjects,
+		source_b2World.m_blockAllocator.m_numAllocatedObjects
+	);
+#endif
+}
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+#include "augs/log.h"
+#include "augs/misc/timing/timer.h"
+
+TEST_CASE("B2WorldCloner ChunksAndObjects") {
+	/*
+		Several hundred bodies packed tightly enough to keep plenty of contacts alive,
+		some of them tied together with motor joints.
+	*/
+
+	auto make_world = []() {
+		auto world = std::make_unique<b2World>(b2Vec2(0.f, 0.f));
+		world->SetAllowSleeping(true);
+		world->SetAutoClearForces(false);
+
+		b2Body* previous = nullptr;
+
+		for (int y = 0; y < 20; ++y) {
+			for (int x = 0; x < 20; ++x) {
+				b2BodyDef def;
+				def.type = b2_dynamicBody;
+
+				const auto position = b2Vec2(x * 0.9f, y * 0.9f);
+				const auto angle = 0.1f * (x + y);
+
+				def.transform.Set(position, angle);
+
+				def.sweep.localCenter.SetZero();
+				def.sweep.c0 = def.sweep.c = position;
+				def.sweep.a0 = def.sweep.a = angle;
+				def.sweep.alpha0 = 0.f;
+
+				b2Body* const body = world->CreateBody(&def);
+
+				b2FixtureDef fixture;
+				fixture.density = 1.f;
+
+				b2PolygonShape box;
+				b2CircleShape circle;
+
+				if ((x + y) % 2 == 0) {
+					box.SetAsBox(0.5f, 0.5f);
+					fixture.shape = &box;
+				}
+				else {
+					circle.m_radius = 0.55f;
+					fixture.shape = &circle;
+				}
+
+				body->CreateFixture(&fixture);
+
+				if (previous != nullptr && x % 5 == 0) {
+					b2MotorJointDef joint;
+					joint.Initialize(previous, body);
+					world->CreateJoint(&joint);
+				}
+
+				previous = body;
+			}
+		}
+
+		return world;
+	};
+
+	auto step = [](b2World& world) {
+		world.Step(1 / 60.f, 8, 3);
+		world.ClearForces();
+	};
+
+	auto source = make_world();
+
+	for (int i = 0; i < 10; ++i) {
+		step(*source);
+	}
+
+	REQUIRE(source->GetContactCount() > 0);
+	REQUIRE(b2world_cloner::can_clone_by_chunks(*source));
+
+	auto by_objects = std::make_unique<b2World>(b2Vec2(0.f, 0.f));
+	auto by_chunks = std::make_unique<b2World>(b2Vec2(0.f, 0.f));
+
+	b2world_cloner object_cloner;
+	b2world_cloner chunk_cloner;
+
+	object_cloner.clone_by_objects(*by_objects, *source);
+	chunk_cloner.clone_by_chunks(*by_chunks, *source);
+
+	REQUIRE(by_objects->GetBodyCount() == source->GetBodyCount());
+	REQUIRE(by_chunks->GetBodyCount() == source->GetBodyCount());
+	REQUIRE(by_chunks->GetContactCount() == source->GetContactCount());
+	REQUIRE(by_chunks->GetJointCount() == source->GetJointCount());
+
+	for (const b2Body* b = source->GetBodyList(); b; b = b->GetNext()) {
+		REQUIRE(chunk_cloner.migrated(b)->GetWorld() == by_chunks.get());
+		REQUIRE(object_cloner.migrated(b)->GetWorld() == by_objects.get());
+	}
+
+	/* Both clones and the source must evolve identically. */
+
+	for (int i = 0; i < 30; ++i) {
+		step(*source);
+		step(*by_objects);
+		step(*by_chunks);
+	}
+
+	{
+		const b2Body* s = source->GetBodyList();
+		const b2Body* o = by_objects->GetBodyList();
+		const b2Body* c = by_chunks->GetBodyList();
+
+		for (; s; s = s->GetNext(), o = o->GetNext(), c = c->GetNext()) {
+			REQUIRE(o != nullptr);
+			REQUIRE(c != nullptr);
+
+			REQUIRE(s->GetTransform() == o->GetTransform());
+			REQUIRE(s->GetTransform() == c->GetTransform());
+		}
+
+		REQUIRE(o == nullptr);
+		REQUIRE(c == nullptr);
+	}
+
+	/* Cloning over an existing clone must work just as well. */
+
+	chunk_cloner.clone_by_chunks(*by_chunks, *source);
+	object_cloner.clone_by_objects(*by_objects, *source);
+
+	for (int i = 0; i < 5; ++i) {
+		step(*source);
+		step(*by_chunks);
+	}
+
+	for (
+		const b2Body* s = source->GetBodyList(), *c = by_chunks->GetBodyList();
+		s;
+		s = s->GetNext(), c = c->GetNext()
+	) {
+		REQUIRE(s->GetTransform() == c->GetTransform());
+	}
+
+	{
+		const int clones = 200;
+
+		auto measure = [&](auto clone) {
+			auto t = augs::timer();
+
+			for (int i = 0; i < clones; ++i) {
+				clone();
+			}
+
+			return t.get<std::chrono::microseconds>() / clones;
+		};
+
+		const auto objects_us = measure([&]() { object_cloner.clone_by_objects(*by_objects, *source); });
+		const auto chunks_us = measure([&]() { chunk_cloner.clone_by_chunks(*by_chunks, *source); });
+
+		LOG(
+			"b2World clone of %x bodies, %x contacts: by objects %x us, by chunks %x us",
+			source->GetBodyCount(),
+			source->GetContactCount(),
+			objects_us,
+			chunks_us
+		);
+	}
+}
+#endif
@@ -0,0 +1,45 @@
+#pragma once
+#include <unordered_map>
+
+class b2World;
+class b2BlockAllocator;
+
+/*
+	Makes a b2World an independent copy of another one.
+
+	The fast path copies the source's block allocator chunk by chunk
+	and rewrites the pointers between objects with base-offset arithmetic,
+	reusing the target's chunks so that nothing is allocated once the target has warmed up.
+
+	It applies whenever every object of the world lives inside the chunks,
+	i.e. there are no allocations above b2_maxBlockSize and no chain shapes.
+	Otherwise, the world is copied object by object,
+	tracking where every object went in a hash map.
+*/
+
+class b2world_cloner {
+	std::unordered_map<const void*, void*> pointer_migrations;
+	std::unordered_map<const void*, bool> contact_edge_a_or_b_in_contacts;
+	std::unordered_map<const void*, bool> joint_edge_a_or_b_in_joints;
+
+	const b2BlockAllocator* chunk_migrations = nullptr;
+
+	static void copy_trivially(b2World& target, const b2World& source);
+
+public:
+	static bool can_clone_by_chunks(const b2World&);
+
+	void clone(b2World& target, const b2World& source);
+
+	void clone_by_objects(b2World& target, const b2World& source);
+	void clone_by_chunks(b2World& target, const b2World& source);
+
+	/* Where an object of the source world ended up after the last clone. */
+
+	void* migrated(const void* source_object) const;
+
+	template <class T>
+	T* migrated(const T* source_object) const {
+		return reinterpret_cast<T*>(migrated(reinterpret_cast<const void*>(source_object)));
+	}
+};
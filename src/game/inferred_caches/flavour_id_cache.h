@@ -1,6 +1,5 @@
 #pragma once
-#include <unordered_set>
-#include <unordered_map>
+#include "augs/templates/flat_hash_map.h"
 
 #include "game/cosmos/per_entity_type.h"
 
@@ -13,9 +12,9 @@ class cosmos;
 
 class flavour_id_cache {
 	template <class T>
-	using make_flavour_map = std::unordered_map<
+	using make_flavour_map = augs::flat_hash_map<
 		typed_entity_flavour_id<T>, 
-		std::unordered_set<typed_entity_id<T>>
+		augs::flat_hash_set<typed_entity_id<T>>
 	>;
 
 	using caches_type = per_entity_type_container<make_flavour_map>;
@@ -29,7 +28,7 @@ public:
 
 	template <class E>
 	const auto& get_entities_by_flavour_id(const typed_entity_flavour_id<E> id) const {
-		thread_local const std::unordered_set<typed_entity_id<E>> detail_none;
+		thread_local const augs::flat_hash_set<typed_entity_id<E>> detail_none;
 
 		if (const auto mapped = mapped_or_nullptr(caches.get_for<E>(), id)) {
 			return *mapped;
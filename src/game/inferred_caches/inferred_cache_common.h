@@ -1,7 +1,7 @@
 #pragma once
-#include <unordered_map>
+#include "augs/templates/flat_hash_map.h"
 #include "game/cosmos/entity_id.h"
 
 template <class cache_type>
-using inferred_cache_map = std::unordered_map<unversioned_entity_id, cache_type>;
+using inferred_cache_map = augs::flat_hash_map<unversioned_entity_id, cache_type>;
 
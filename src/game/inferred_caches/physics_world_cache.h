@@ -11,6 +11,7 @@
 #include "game/detail/physics/physics_queries_declaration.h"
 #include "game/detail/physics/colliders_connection.h"
 #include "game/cosmos/get_corresponding.h"
+#include "game/inferred_caches/b2world_cloner.h"
 
 class cosmos;
 class physics_world_cache;
@@ -36,7 +37,11 @@ struct physics_raycast_output {
 	bool hit = false;
 	vec2 intersection;
 	vec2 normal;
+	real32 fraction = 1.f;
 	unversioned_entity_id what_entity;
+
+	/* Differs from what_entity when the fixture is attached to the body of another entity, e.g. a held item. */
+	unversioned_entity_id what_fixture_entity;
 };
 
 class physics_world_cache {
@@ -48,6 +53,8 @@ class physics_world_cache {
 	inferred_cache_map<joint_cache> joint_caches;
 #endif
 
+	b2world_cloner cloner;
+
 	template <class E>
 	void specific_infer_colliders_from_scratch(
 		const E&, 
@@ -83,6 +90,15 @@ public:
 		const entity_id ignore_entity = entity_id()
 	) const;
 
+	/* Same as above, but reuses the output vector so that many consecutive raycasts need not allocate. */
+	void ray_cast_all_intersections(
+		std::vector<physics_raycast_output>& output,
+		const vec2 p1_meters,
+		const vec2 p2_meters, 
+		const b2Filter filter, 
+		const entity_id ignore_entity = entity_id()
+	) const;
+
 	physics_raycast_output ray_cast(
 		const vec2 p1_meters, 
 		const vec2 p2_meters, 
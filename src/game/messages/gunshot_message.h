@@ -8,6 +8,9 @@ namespace messages {
 		transformr muzzle_transform;
 
 		std::vector<entity_id> spawned_rounds;
+
+		/* Rounds simulated without an entity of their own. See lightweight_projectiles.h. */
+		std::vector<invariants::cartridge::round_flavour_type> spawned_lightweight_rounds;
 		entity_id capability;
 	};
 }
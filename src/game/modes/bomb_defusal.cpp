@@ -904,11 +904,20 @@ void bomb_defusal::setup_round(
 
 	round_speeds = in.rules.speeds;
 
-	cosm.set(in.initial_signi);
+	/*
+		The initial cosmos has all of its caches inferred already,
+		so this only copies them over instead of reinferring everything from scratch.
+
+		The copied caches were built against the initial cosmos' flavours,
+		so both cosmoses must share the common state - the initial cosmos is always a copy of the loaded arena.
+		It is not checked here, since hashing the common state would cost as much as the reinference this avoids.
+	*/
+
+	cosm.assign_solvable(in.initial_cosm);
 
 	/* 
 		If there are any entries in message queues, 
-		they become invalid when we assign the initial_signi.
+		they become invalid when we assign the initial state.
 	*/
 
 	step.transient.clear();
@@ -231,18 +231,18 @@ struct editor_property_accessors;
 class bomb_defusal {
 public:
 	using ruleset_type = bomb_defusal_ruleset;
-	static constexpr bool needs_initial_signi = true;
+	static constexpr bool needs_initial_cosm = true;
 	static constexpr bool round_based = true;
 
 	template <bool C>
 	struct basic_input {
 		const ruleset_type& rules;
-		const cosmos_solvable_significant& initial_signi;
+		const cosmos& initial_cosm;
 		maybe_const_ref_t<C, cosmos> cosm;
 
 		template <bool is_const = C, class = std::enable_if_t<!is_const>>
 		operator basic_input<!is_const>() const {
-			return { rules, initial_signi, cosm };
+			return { rules, initial_cosm, cosm };
 		}
 	};
 
@@ -48,7 +48,7 @@ struct test_mode_player {
 class test_mode {
 public:
 	using ruleset_type = test_mode_ruleset;
-	static constexpr bool needs_initial_signi = false;
+	static constexpr bool needs_initial_cosm = false;
 	static constexpr bool round_based = false;
 
 	template <bool C>
@@ -9,10 +9,20 @@ struct rigid_body_cache;
 struct colliders_cache;
 struct tree_of_npo_cache_data;
 
+/*
+	statically_allocated_entities is the most entities of a type that may ever exist at once.
+
+	spawn_headroom_entities is how much room to leave on top of the arena content
+	when the pools are fitted to a freshly loaded arena - see cosmic::fit_entity_pools.
+	Types that are only ever placed in the editor need none,
+	types that are spawned during a match keep their whole ceiling.
+*/
+
 /* E.g. a player as a resistance soldier or metropolitan guard */
 
 struct controlled_character {
 	static constexpr std::size_t statically_allocated_entities = 300;
+	static constexpr std::size_t spawn_headroom_entities = 128;
 	static constexpr std::size_t statically_allocated_flavours = 20;
 
 	using invariant_list = type_list<
@@ -60,6 +70,7 @@ struct controlled_character {
 
 struct plain_sprited_body {
 	static constexpr std::size_t statically_allocated_entities = 3000;
+	static constexpr std::size_t spawn_headroom_entities = 0;
 	static constexpr std::size_t statically_allocated_flavours = 300;
 
 	using invariant_list = type_list<
@@ -89,6 +100,7 @@ struct plain_sprited_body {
 
 struct shootable_weapon {
 	static constexpr std::size_t statically_allocated_entities = 1500;
+	static constexpr std::size_t spawn_headroom_entities = statically_allocated_entities;
 	static constexpr std::size_t statically_allocated_flavours = 150;
 
 	using invariant_list = type_list<
@@ -125,6 +137,7 @@ struct shootable_weapon {
 
 struct melee_weapon {
 	static constexpr std::size_t statically_allocated_entities = 1500;
+	static constexpr std::size_t spawn_headroom_entities = statically_allocated_entities;
 	static constexpr std::size_t statically_allocated_flavours = 150;
 
 	using invariant_list = type_list<
@@ -162,6 +175,7 @@ struct melee_weapon {
 
 struct shootable_charge {
 	static constexpr std::size_t statically_allocated_entities = 1500;
+	static constexpr std::size_t spawn_headroom_entities = statically_allocated_entities;
 	static constexpr std::size_t statically_allocated_flavours = 150;
 
 	using invariant_list = type_list<
@@ -192,6 +206,7 @@ struct shootable_charge {
 
 struct sprite_decoration {
 	static constexpr std::size_t statically_allocated_entities = 20000;
+	static constexpr std::size_t spawn_headroom_entities = 0;
 	static constexpr std::size_t statically_allocated_flavours = 300;
 
 	using invariant_list = type_list<
@@ -213,6 +228,7 @@ struct sprite_decoration {
 
 struct wandering_pixels_decoration {
 	static constexpr std::size_t statically_allocated_entities = 2000;
+	static constexpr std::size_t spawn_headroom_entities = 0;
 	static constexpr std::size_t statically_allocated_flavours = 20;
 
 	using invariant_list = type_list<
@@ -233,6 +249,7 @@ struct wandering_pixels_decoration {
 
 struct static_light {
 	static constexpr std::size_t statically_allocated_entities = 2000;
+	static constexpr std::size_t spawn_headroom_entities = 0;
 	static constexpr std::size_t statically_allocated_flavours = 50;
 
 	using invariant_list = type_list<
@@ -251,6 +268,7 @@ struct static_light {
 
 struct hand_explosive {
 	static constexpr std::size_t statically_allocated_entities = 1500;
+	static constexpr std::size_t spawn_headroom_entities = statically_allocated_entities;
 	static constexpr std::size_t statically_allocated_flavours = 150;
 
 	using invariant_list = type_list<
@@ -283,6 +301,7 @@ struct hand_explosive {
 
 struct plain_missile {
 	static constexpr std::size_t statically_allocated_entities = 1500;
+	static constexpr std::size_t spawn_headroom_entities = statically_allocated_entities;
 	static constexpr std::size_t statically_allocated_flavours = 150;
 
 	using invariant_list = type_list<
@@ -316,6 +335,7 @@ struct plain_missile {
 
 struct finishing_trace {
 	static constexpr std::size_t statically_allocated_entities = 3000;
+	static constexpr std::size_t spawn_headroom_entities = statically_allocated_entities;
 	static constexpr std::size_t statically_allocated_flavours = 150;
 
 	using invariant_list = type_list<
@@ -338,6 +358,7 @@ struct finishing_trace {
 
 struct container_item {
 	static constexpr std::size_t statically_allocated_entities = 1500;
+	static constexpr std::size_t spawn_headroom_entities = statically_allocated_entities;
 	static constexpr std::size_t statically_allocated_flavours = 150;
 
 	using invariant_list = type_list<
@@ -368,6 +389,7 @@ struct container_item {
 
 struct complex_decoration {
 	static constexpr std::size_t statically_allocated_entities = 2000;
+	static constexpr std::size_t spawn_headroom_entities = 0;
 	static constexpr std::size_t statically_allocated_flavours = 300;
 
 	using invariant_list = type_list<
@@ -394,6 +416,7 @@ struct complex_decoration {
 
 struct remnant_body {
 	static constexpr std::size_t statically_allocated_entities = 4000;
+	static constexpr std::size_t spawn_headroom_entities = statically_allocated_entities;
 	static constexpr std::size_t statically_allocated_flavours = 300;
 
 	using invariant_list = type_list<
@@ -423,6 +446,7 @@ struct remnant_body {
 
 struct sound_decoration {
 	static constexpr std::size_t statically_allocated_entities = 1000;
+	static constexpr std::size_t spawn_headroom_entities = 0;
 	static constexpr std::size_t statically_allocated_flavours = 500;
 
 	using invariant_list = type_list<
@@ -440,6 +464,7 @@ struct sound_decoration {
 
 struct particles_decoration {
 	static constexpr std::size_t statically_allocated_entities = 1000;
+	static constexpr std::size_t spawn_headroom_entities = 0;
 	static constexpr std::size_t statically_allocated_flavours = 500;
 
 	using invariant_list = type_list<
@@ -459,6 +484,7 @@ struct particles_decoration {
 
 struct point_marker {
 	static constexpr std::size_t statically_allocated_entities = 1000;
+	static constexpr std::size_t spawn_headroom_entities = 0;
 	static constexpr std::size_t statically_allocated_flavours = 100;
 
 	using invariant_list = type_list<
@@ -477,6 +503,7 @@ struct point_marker {
 
 struct box_marker {
 	static constexpr std::size_t statically_allocated_entities = 1000;
+	static constexpr std::size_t spawn_headroom_entities = 0;
 	static constexpr std::size_t statically_allocated_flavours = 150;
 
 	using invariant_list = type_list<
@@ -496,6 +523,7 @@ struct box_marker {
 
 struct explosion_body {
 	static constexpr std::size_t statically_allocated_entities = 2000;
+	static constexpr std::size_t spawn_headroom_entities = statically_allocated_entities;
 	static constexpr std::size_t statically_allocated_flavours = 300;
 
 	using invariant_list = type_list<
@@ -521,6 +549,7 @@ struct explosion_body {
 
 struct tool_item {
 	static constexpr std::size_t statically_allocated_entities = 1500;
+	static constexpr std::size_t spawn_headroom_entities = statically_allocated_entities;
 	static constexpr std::size_t statically_allocated_flavours = 150;
 
 	using invariant_list = type_list<
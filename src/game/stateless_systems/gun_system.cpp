@@ -780,6 +780,69 @@ void gun_system::launch_shots_due_to_pressed_triggers(const logic_step step) {
 											const auto& num_rounds = cartridge_def.num_rounds_spawned;
 
 											auto create_round = [&](const std::optional<real32> rotational_offset) {
+												const auto considered_muzzle_transform = [&]() {
+													auto o = muzzle_transform;
+
+													if (rotational_offset.has_value()) {
+														o.rotation += *rotational_offset;
+													}
+
+													if (cartridge_rotational_offset.has_value()) {
+														o.rotation += *cartridge_rotational_offset;
+													}
+
+													return o;
+												}();
+
+												const bool launched_without_body = cosm.on_flavour(round_flavour, [&](const auto& round_def) {
+													using F = remove_cref<decltype(round_def)>;
+
+													if constexpr(F::template has<invariants::explosive>()) {
+														return false;
+													}
+													else {
+														const auto& missile_def = round_def.template get<invariants::missile>();
+
+														if (!missile_def.can_simulate_without_body()) {
+															return false;
+														}
+
+														total_recoil += missile_def.recoil_multiplier * gun_def.recoil_multiplier / num_rounds;
+
+														auto& projectiles = cosm.get_global_solvable().projectiles;
+
+														lightweight_projectile round;
+
+														round.position = considered_muzzle_transform.pos;
+
+														{
+															const auto muzzle_randomized_vel = stack_rng.randval(gun_def.muzzle_velocity);
+
+															round.velocity = 
+																considered_muzzle_transform.get_direction()
+																* missile_def.muzzle_velocity_mult
+																* muzzle_randomized_vel
+															;
+														}
+
+														round.flavour = round_flavour;
+														round.sender.set(gun_entity);
+														round.power_multiplier_of_sender = gun_def.damage_multiplier;
+														round.damage_charges_before_destruction = round_def.template get<components::missile>().damage_charges_before_destruction;
+														round.when_fired = cosm.get_timestamp();
+														round.rng_seed = augs::hash_multiple(stack_seed, charges, projectiles.size());
+
+														projectiles.push_back(round);
+														response.spawned_lightweight_rounds.push_back(round_flavour);
+
+														return true;
+													}
+												});
+
+												if (launched_without_body) {
+													return;
+												}
+
 												cosmic::create_entity(cosm, round_flavour, [&](const auto round_entity, auto&&...) {
 #if !ENABLE_RECOIL
 													LOG("ROUND CREATED");
@@ -795,20 +858,6 @@ void gun_system::launch_shots_due_to_pressed_triggers(const logic_step step) {
 													const auto& missile_def = round_entity.template get<invariants::missile>();
 													total_recoil += missile_def.recoil_multiplier * gun_def.recoil_multiplier / num_rounds;
 
-													const auto considered_muzzle_transform = [&]() {
-														auto o = muzzle_transform;
-
-														if (rotational_offset.has_value()) {
-															o.rotation += *rotational_offset;
-														}
-
-														if (cartridge_rotational_offset.has_value()) {
-															o.rotation += *cartridge_rotational_offset;
-														}
-
-														return o;
-													}();
-
 													round_entity.set_logic_transform(considered_muzzle_transform);
 
 													response.spawned_rounds.push_back(round_entity);
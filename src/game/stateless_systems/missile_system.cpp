@@ -1,5 +1,6 @@
 #include "missile_system.h"
 #include "augs/math/steering.h"
+#include "augs/misc/randomization.h"
 #include "game/cosmos/cosmos.h"
 #include "game/cosmos/entity_id.h"
 #include "game/cosmos/for_each_entity.h"
@@ -26,9 +27,11 @@
 #include "game/cosmos/logic_step.h"
 #include "game/cosmos/data_living_one_step.h"
 #include "game/cosmos/create_entity.hpp"
+#include "game/inferred_caches/physics_world_cache.h"
 #include "game/detail/entity_handle_mixins/get_owning_transfer_capability.hpp"
 
 #include "game/detail/physics/physics_scripts.h"
+#include "game/detail/missile/lightweight_projectile_sweep.h"
 
 #include "game/assets/ids/asset_ids.h"
 
@@ -406,4 +409,363 @@ void missile_system::detonate_expired_missiles(const logic_step step) {
 			}
 		}
 	);
-}
\ No newline at end of file
+}
+
+void missile_system::advance_lightweight_projectiles(const logic_step step) {
+	auto& cosm = step.get_cosmos();
+	auto& projectiles = cosm.get_global_solvable().projectiles;
+
+	if (projectiles.empty()) {
+		return;
+	}
+
+	const auto& clk = cosm.get_clock();
+	const auto& now = clk.now;
+	const auto& delta = step.get_delta();
+	const auto dt = delta.in_seconds();
+	const auto si = cosm.get_si();
+	const auto& physics = cosm.get_solvable_inferred().physics;
+
+	thread_local std::vector<physics_raycast_output> raycast_hits;
+	thread_local std::vector<lightweight_sweep_hit> hits;
+	thread_local std::vector<uint8_t> removed;
+
+	removed.assign(projectiles.size(), 0);
+
+	auto& positions = projectiles.positions;
+	auto& velocities = projectiles.velocities;
+
+	for (std::size_t i = 0; i < projectiles.size(); ++i) {
+		const auto& flavour_id = projectiles.flavours[i];
+		const auto& sender = projectiles.senders[i];
+		auto& charges = projectiles.damage_charges_before_destruction[i];
+		auto& when_last_ricocheted = projectiles.when_last_ricocheted[i];
+
+		cosm.on_flavour(flavour_id, [&](const auto& flavour) {
+			const auto& missile_def = flavour.template get<invariants::missile>();
+
+			if (missile_def.constrain_lifetime) {
+				if (::lightweight_projectile_expired(projectiles.when_fired[i].step, now.step, missile_def.max_lifetime_ms, delta.in_milliseconds())) {
+					removed[i] = 1;
+					return;
+				}
+			}
+
+			const auto filter = [&]() {
+				if (const auto fixtures = flavour.template find<invariants::fixtures>()) {
+					return fixtures->filter;
+				}
+
+				return filters[predefined_filter_type::FLYING_BULLET];
+			}();
+
+			const auto from = positions[i];
+			const auto to = from + velocities[i] * dt;
+
+			physics.ray_cast_all_intersections(raycast_hits, si.get_meters(from), si.get_meters(to), filter);
+
+			/* 
+				Box2D reports the intersections in the order of its broadphase tree.
+				It is deterministic, but we need to process them front to back.
+			*/
+
+			std::stable_sort(raycast_hits.begin(), raycast_hits.end(), [](const auto& a, const auto& b) {
+				return a.fraction < b.fraction;
+			});
+
+			hits.clear();
+
+			for (const auto& raycast_hit : raycast_hits) {
+				auto& hit = hits.emplace_back();
+
+				hit.point = si.get_pixels(raycast_hit.intersection);
+				hit.normal = raycast_hit.normal;
+
+				const auto surface_handle = cosm[raycast_hit.what_fixture_entity];
+
+				if (surface_handle.dead()) {
+					hit.ignored = true;
+					continue;
+				}
+
+				const auto info = missile_surface_info(sender, surface_handle);
+
+				hit.ignored = info.should_ignore_altogether();
+				hit.ricochetable = info.is_ricochetable();
+				hit.detonates = info.should_detonate();
+
+				/* Same as in contact_listener's PreSolve. */
+				hit.blocking = !info.ignore_standard_impulse() && !surface_handle.template has<components::sentience>();
+
+				hit.max_ricochet_angle = surface_handle.template get<invariants::fixtures>().max_ricochet_angle;
+			}
+
+			lightweight_sweep_input in;
+			in.position = from;
+			in.velocity = velocities[i];
+			in.dt = dt;
+			in.charges = charges;
+			in.destroy_upon_damage = missile_def.destroy_upon_damage;
+			in.ricochet_cooldown = now.step <= when_last_ricocheted.step + 1;
+			in.born_cooldown = clk.lasts(missile_def.ricochet_born_cooldown_ms, projectiles.when_fired[i]);
+
+			const auto impact_velocity = velocities[i];
+			const auto impact_dir = vec2(impact_velocity).normalize();
+
+			auto on_damage = [&](const std::size_t hit_index, const bool destructed) {
+				const auto& hit = hits[hit_index];
+				const auto collision_normal = vec2(hit.normal).normalize();
+
+				messages::damage_message damage_msg;
+				damage_msg.damage = missile_def.damage;
+				damage_msg.damage *= projectiles.power_multipliers_of_sender[i];
+
+				damage_msg.origin.cause.flavour = flavour_id;
+				damage_msg.origin.sender = sender;
+				damage_msg.subject = cosm[raycast_hits[hit_index].what_fixture_entity];
+				damage_msg.impact_velocity = impact_velocity;
+				damage_msg.point_of_impact = hit.point;
+				damage_msg.inflictor_destructed = destructed;
+
+				if (hit.detonates && missile_def.destroy_upon_damage) {
+					const auto& total_damage_amount = damage_msg.damage.base;
+
+					if (augs::is_positive_epsilon(total_damage_amount)) {
+						startle_nearby_organisms(cosm, hit.point, total_damage_amount * 12.f, 27.f, startle_type::LIGHTER);
+						startle_nearby_organisms(cosm, hit.point, total_damage_amount * 6.f, 50.f + total_damage_amount * 2.f, startle_type::IMMEDIATE, render_layer_filter::whitelist(render_layer::INSECTS));
+					}
+				}
+
+				if (destructed) {
+					auto rng = randomization(projectiles.rng_seeds[i]);
+
+					spawn_bullet_remnants(
+						step,
+						rng,
+						missile_def.remnant_flavours,
+						collision_normal,
+						impact_dir,
+						hit.point
+					);
+				}
+
+				step.post_message(damage_msg);
+			};
+
+			auto on_ricochet = [&](const std::size_t hit_index, const vec2 reflected_dir, const real32 angle_mult) {
+				when_last_ricocheted = now;
+				::play_ricochet_effects(step, missile_def, hits[hit_index].point, reflected_dir, angle_mult);
+			};
+
+			const auto result = ::sweep_lightweight_projectile(in, hits, on_damage, on_ricochet);
+
+			positions[i] = result.position;
+			velocities[i] = result.velocity;
+			charges = result.charges;
+
+			if (result.removed) {
+				removed[i] = 1;
+			}
+		});
+	}
+
+	projectiles.erase_flagged(removed);
+}
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+
+TEST_CASE("LightweightProjectilesEraseFlagged") {
+	lightweight_projectiles projectiles;
+
+	for (int i = 0; i < 5; ++i) {
+		lightweight_projectile p;
+		p.position = vec2(static_cast<real32>(i), 0.f);
+		p.damage_charges_before_destruction = i;
+		p.rng_seed = static_cast<rng_seed_type>(i);
+
+		projectiles.push_back(p);
+	}
+
+	projectiles.erase_flagged({ 1, 0, 0, 1, 0 });
+
+	REQUIRE(projectiles.size() == 3);
+	REQUIRE(projectiles.velocities.size() == 3);
+	REQUIRE(projectiles.when_last_ricocheted.size() == 3);
+
+	REQUIRE(projectiles.positions[0].x == 1.f);
+	REQUIRE(projectiles.positions[1].x == 2.f);
+	REQUIRE(projectiles.positions[2].x == 4.f);
+
+	REQUIRE(projectiles.damage_charges_before_destruction[2] == 4);
+	REQUIRE(projectiles.rng_seeds[1] == 2);
+
+	projectiles.clear();
+	REQUIRE(projectiles.empty());
+}
+
+namespace {
+	struct sweep_record {
+		std::vector<std::size_t> damaged;
+		std::vector<bool> destructed;
+		std::vector<std::size_t> ricocheted;
+
+		auto run(const lightweight_sweep_input& in, const std::vector<lightweight_sweep_hit>& hits) {
+			return ::sweep_lightweight_projectile(
+				in,
+				hits,
+				[&](const std::size_t i, const bool d) { damaged.push_back(i); destructed.push_back(d); },
+				[&](const std::size_t i, vec2, real32) { ricocheted.push_back(i); }
+			);
+		}
+	};
+
+	auto make_wall(const vec2 point, const vec2 normal, const real32 max_ricochet_angle = 0.f) {
+		lightweight_sweep_hit wall;
+		wall.point = point;
+		wall.normal = normal;
+		wall.max_ricochet_angle = max_ricochet_angle;
+		wall.ricochetable = true;
+		wall.detonates = true;
+		wall.blocking = true;
+		return wall;
+	}
+
+	auto make_player(const vec2 point) {
+		lightweight_sweep_hit player;
+		player.point = point;
+		player.normal = vec2(-1, 0);
+		player.ricochetable = true;
+		player.detonates = true;
+		player.blocking = false;
+		return player;
+	}
+
+	auto make_input(const int charges) {
+		lightweight_sweep_input in;
+		in.position = vec2(0, 0);
+		in.velocity = vec2(1000, 0);
+		in.dt = 0.1f;
+		in.charges = charges;
+		return in;
+	}
+}
+
+TEST_CASE("LightweightSweep WallHit") {
+	sweep_record rec;
+
+	const auto result = rec.run(make_input(1), { make_wall(vec2(50, 0), vec2(-1, 0)) });
+
+	REQUIRE(result.removed);
+	REQUIRE(result.charges == 0);
+	REQUIRE(result.position == vec2(50, 0));
+	REQUIRE(rec.damaged == std::vector<std::size_t> { 0 });
+	REQUIRE(rec.destructed == std::vector<bool> { true });
+	REQUIRE(rec.ricocheted.empty());
+}
+
+TEST_CASE("LightweightSweep StopsAtFirstBlockingSurface") {
+	sweep_record rec;
+
+	/* Two charges survive the first wall, but the round must never tunnel to the second one. */
+
+	auto in = make_input(2);
+
+	const auto result = rec.run(in, {
+		make_wall(vec2(30, 0), vec2(-1, 0)),
+		make_wall(vec2(60, 0), vec2(-1, 0))
+	});
+
+	REQUIRE(result.removed);
+	REQUIRE(result.charges == 1);
+	REQUIRE(result.position == vec2(30, 0));
+	REQUIRE(rec.damaged == std::vector<std::size_t> { 0 });
+
+	/* Without destroy_upon_damage, no charges are consumed, but the wall still stops the round. */
+
+	sweep_record rec_indestructible;
+	in.destroy_upon_damage = false;
+
+	const auto indestructible = rec_indestructible.run(in, {
+		make_wall(vec2(30, 0), vec2(-1, 0)),
+		make_wall(vec2(60, 0), vec2(-1, 0))
+	});
+
+	REQUIRE(indestructible.removed);
+	REQUIRE(indestructible.charges == 2);
+	REQUIRE(rec_indestructible.damaged == std::vector<std::size_t> { 0 });
+	REQUIRE(rec_indestructible.destructed == std::vector<bool> { false });
+}
+
+TEST_CASE("LightweightSweep Ricochet") {
+	sweep_record rec;
+
+	/* Grazing a horizontal wall at a shallow angle. */
+
+	auto in = make_input(1);
+	in.velocity = vec2(1000, 100);
+
+	const auto result = rec.run(in, { make_wall(vec2(50, 5), vec2(0, -1), 30.f) });
+
+	REQUIRE_FALSE(result.removed);
+	REQUIRE(result.ricocheted);
+	REQUIRE(result.charges == 1);
+	REQUIRE(result.velocity.y < 0.f);
+	REQUIRE(result.velocity.x > 0.f);
+	REQUIRE(rec.ricocheted == std::vector<std::size_t> { 0 });
+	REQUIRE(rec.damaged.empty());
+
+	/* Right after a ricochet, nothing is impacted. */
+
+	sweep_record rec_cooldown;
+	in.ricochet_cooldown = true;
+
+	const auto cooldown = rec_cooldown.run(in, { make_wall(vec2(50, 5), vec2(0, -1), 30.f) });
+
+	REQUIRE_FALSE(cooldown.removed);
+	REQUIRE(rec_cooldown.ricocheted.empty());
+	REQUIRE(rec_cooldown.damaged.empty());
+}
+
+TEST_CASE("LightweightSweep DamagesPlayer") {
+	sweep_record rec;
+
+	lightweight_sweep_hit held_item;
+	held_item.ignored = true;
+
+	const auto result = rec.run(make_input(1), { held_item, make_player(vec2(40, 0)), make_wall(vec2(80, 0), vec2(-1, 0)) });
+
+	REQUIRE(result.removed);
+	REQUIRE(result.position == vec2(40, 0));
+	REQUIRE(rec.damaged == std::vector<std::size_t> { 1 });
+	REQUIRE(rec.destructed == std::vector<bool> { true });
+
+	/* A player never stops a round, so with charges to spare it goes on to the wall behind. */
+
+	sweep_record rec_piercing;
+
+	const auto piercing = rec_piercing.run(make_input(3), { make_player(vec2(40, 0)), make_wall(vec2(80, 0), vec2(-1, 0)) });
+
+	REQUIRE(piercing.removed);
+	REQUIRE(piercing.charges == 1);
+	REQUIRE(piercing.position == vec2(80, 0));
+	REQUIRE(rec_piercing.damaged == std::vector<std::size_t> { 0, 1 });
+	REQUIRE(rec_piercing.destructed == std::vector<bool> { false, false });
+}
+
+TEST_CASE("LightweightSweep ExpiresByLifetime") {
+	sweep_record rec;
+
+	const auto result = rec.run(make_input(1), {});
+
+	REQUIRE_FALSE(result.removed);
+	REQUIRE(result.position == vec2(100, 0));
+
+	const auto step_ms = 1000.f / 60;
+
+	REQUIRE_FALSE(::lightweight_projectile_expired(10, 10, 500.f, step_ms));
+	REQUIRE_FALSE(::lightweight_projectile_expired(10, 38, 500.f, step_ms));
+	REQUIRE(::lightweight_projectile_expired(10, 40, 500.f, step_ms));
+	REQUIRE(::lightweight_projectile_expired(10, 100, 500.f, step_ms));
+}
+#endif
@@ -9,4 +9,6 @@ public:
 	void ricochet_missiles(const logic_step step);
 	void detonate_colliding_missiles(const logic_step step);
 	void detonate_expired_missiles(const logic_step step);
+
+	void advance_lightweight_projectiles(const logic_step step);
 };
\ No newline at end of file
@@ -343,7 +343,7 @@ void particles_simulation_system::remove_dead_particles(const cosmos& cosm) {
 	};
 
 	for (auto& particle_layer : general_particles) {
-		dead_particles_remover(particle_layer);
+		particle_layer.remove_dead();
 	}
 
 	for (auto& particle_layer : animated_particles) {
@@ -397,58 +397,71 @@ void particles_simulation_system::integrate_and_draw_all_particles(const integra
 	const auto delta = in.dt.in_seconds();
 
 	auto generic_integrate = [&anims, delta](const particle_layer, auto& range, int, int from_i, const int till_i, auto&&... args) {
-		using P = typename remove_cref<decltype(range)>::value_type;
+		using R = remove_cref<decltype(range)>;
 
-		for (; from_i < till_i; ++from_i) {
-			auto& particle = range[from_i];
+		if constexpr(std::is_same_v<R, general_particle_store>) {
+			range.integrate(from_i, till_i, delta);
+		}
+		else {
+			using P = typename R::value_type;
 
-			if constexpr(std::is_same_v<P, general_particle>) {
-				particle.integrate(delta);
-			}
-			else if constexpr(std::is_same_v<P, animated_particle>) {
-				particle.integrate(delta, anims);
-			}
-			else if constexpr(std::is_same_v<P, homing_animated_particle>) {
-				particle.integrate(delta, anims, std::forward<decltype(args)>(args)...);
-			}
-			else {
-				static_assert(always_false_v<P>, "Unimplemented!");
+			for (; from_i < till_i; ++from_i) {
+				auto& particle = range[from_i];
+
+				if constexpr(std::is_same_v<P, animated_particle>) {
+					particle.integrate(delta, anims);
+				}
+				else if constexpr(std::is_same_v<P, homing_animated_particle>) {
+					particle.integrate(delta, anims, std::forward<decltype(args)>(args)...);
+				}
+				else {
+					static_assert(always_false_v<P>, "Unimplemented!");
+				}
 			}
 		}
 	};
 
 	auto generic_draw = [&output_buffers, &game_images, &anims](const particle_layer p, auto& range, const int layer_index, const int from_i, const int till_i, auto&&...) {
-		{
-			auto& target_buffer = output_buffers.diffuse[p];
+		if constexpr(std::is_same_v<remove_cref<decltype(range)>, general_particle_store>) {
+			range.write_sprites(output_buffers.diffuse[p].data() + 2 * layer_index, from_i, till_i, game_images);
+
+			if (p == particle_layer::NEONING_PARTICLES) {
+				range.write_neon_sprites(output_buffers.neons.data() + 2 * layer_index, from_i, till_i, game_images);
+			}
+		}
+		else {
+			{
+				auto& target_buffer = output_buffers.diffuse[p];
 
-			auto li = layer_index;
+				auto li = layer_index;
 
-			for (int i = from_i; i < till_i; ++i) {
-				auto& particle = range[i];
+				for (int i = from_i; i < till_i; ++i) {
+					auto& particle = range[i];
 
-				auto& t1 = target_buffer[2 * li];
-				auto& t2 = target_buffer[2 * li + 1];
+					auto& t1 = target_buffer[2 * li];
+					auto& t2 = target_buffer[2 * li + 1];
 
-				particle.template draw_as_sprite<false>(t1, t2, game_images, anims);
+					particle.template draw_as_sprite<false>(t1, t2, game_images, anims);
 
-				++li;
+					++li;
+				}
 			}
-		}
 
-		if (p == particle_layer::NEONING_PARTICLES) {
-			auto& target_buffer = output_buffers.neons;
+			if (p == particle_layer::NEONING_PARTICLES) {
+				auto& target_buffer = output_buffers.neons;
 
-			auto li = layer_index;
+				auto li = layer_index;
 
-			for (int i = from_i; i < till_i; ++i) {
-				auto& particle = range[i];
+				for (int i = from_i; i < till_i; ++i) {
+					auto& particle = range[i];
 
-				auto& t1 = target_buffer[2 * li];
-				auto& t2 = target_buffer[2 * li + 1];
+					auto& t1 = target_buffer[2 * li];
+					auto& t2 = target_buffer[2 * li + 1];
 
-				particle.template draw_as_sprite<true>(t1, t2, game_images, anims);
+					particle.template draw_as_sprite<true>(t1, t2, game_images, anims);
 
-				++li;
+					++li;
+				}
 			}
 		}
 	};
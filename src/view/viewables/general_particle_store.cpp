@@ -0,0 +1,590 @@
+#include <limits>
+
+#include "view/viewables/general_particle_store.h"
+#include "view/viewables/particle_types.hpp"
+
+#if defined(__AVX__)
+#define AUGS_GENERAL_PARTICLES_AVX 1
+#else
+#define AUGS_GENERAL_PARTICLES_AVX 0
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUGS_GENERAL_PARTICLES_SSE2 1
+#else
+#define AUGS_GENERAL_PARTICLES_SSE2 0
+#endif
+
+#if AUGS_GENERAL_PARTICLES_AVX || AUGS_GENERAL_PARTICLES_SSE2
+#include <immintrin.h>
+#endif
+
+namespace {
+	/*
+		Thin wrappers so that a single kernel serves both vector widths.
+		select(m, a, b) picks a where the mask is set and b elsewhere.
+	*/
+
+#if AUGS_GENERAL_PARTICLES_SSE2
+	struct sse_lanes {
+		using type = __m128;
+		static constexpr int n = 4;
+
+		static type load(const float* p) { return _mm_loadu_ps(p); }
+		static void store(float* p, const type v) { _mm_storeu_ps(p, v); }
+		static type set1(const float v) { return _mm_set1_ps(v); }
+
+		static type add(const type a, const type b) { return _mm_add_ps(a, b); }
+		static type sub(const type a, const type b) { return _mm_sub_ps(a, b); }
+		static type mul(const type a, const type b) { return _mm_mul_ps(a, b); }
+		static type div(const type a, const type b) { return _mm_div_ps(a, b); }
+		static type sqrt(const type a) { return _mm_sqrt_ps(a); }
+		static type abs(const type a) { return _mm_andnot_ps(_mm_set1_ps(-0.f), a); }
+
+		static type eq(const type a, const type b) { return _mm_cmpeq_ps(a, b); }
+		static type lt(const type a, const type b) { return _mm_cmplt_ps(a, b); }
+		static type le(const type a, const type b) { return _mm_cmple_ps(a, b); }
+		static type gt(const type a, const type b) { return _mm_cmpgt_ps(a, b); }
+
+		static type select(const type m, const type a, const type b) {
+			return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+		}
+	};
+#endif
+
+#if AUGS_GENERAL_PARTICLES_SSE2
+	/*
+		Sine and cosine of four angles at once, with the Cephes single precision polynomials.
+		Within a couple of ulps of std::sin and std::cos for the angles that particles reach,
+		which is plenty for drawing.
+	*/
+
+	FORCE_INLINE void sincos_lanes(const __m128 radians, __m128& out_sin, __m128& out_cos) {
+		const auto sign_bit = _mm_set1_ps(-0.f);
+		const auto x_abs = _mm_andnot_ps(sign_bit, radians);
+
+		/* Octant of the angle, rounded up to an even one */
+		auto octant = _mm_cvttps_epi32(_mm_mul_ps(x_abs, _mm_set1_ps(1.27323954473516f)));
+		octant = _mm_and_si128(_mm_add_epi32(octant, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+
+		const auto y = _mm_cvtepi32_ps(octant);
+
+		auto x = x_abs;
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(0.78515625f)));
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(2.4187564849853515625e-4f)));
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(3.77489497744594108e-8f)));
+
+		const auto z = _mm_mul_ps(x, x);
+
+		auto cos_poly = _mm_set1_ps(2.443315711809948e-5f);
+		cos_poly = _mm_add_ps(_mm_mul_ps(cos_poly, z), _mm_set1_ps(-1.388731625493765e-3f));
+		cos_poly = _mm_add_ps(_mm_mul_ps(cos_poly, z), _mm_set1_ps(4.166664568298827e-2f));
+		cos_poly = _mm_mul_ps(_mm_mul_ps(cos_poly, z), z);
+		cos_poly = _mm_sub_ps(cos_poly, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+		cos_poly = _mm_add_ps(cos_poly, _mm_set1_ps(1.f));
+
+		auto sin_poly = _mm_set1_ps(-1.9515295891e-4f);
+		sin_poly = _mm_add_ps(_mm_mul_ps(sin_poly, z), _mm_set1_ps(8.3321608736e-3f));
+		sin_poly = _mm_add_ps(_mm_mul_ps(sin_poly, z), _mm_set1_ps(-1.6666654611e-1f));
+		sin_poly = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sin_poly, z), x), x);
+
+		/* In octants 2, 3, 6 and 7 the polynomials swap roles */
+		const auto swapped = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(octant, _mm_set1_epi32(2)), _mm_set1_epi32(2)));
+
+		const auto s = _mm_or_ps(_mm_and_ps(swapped, cos_poly), _mm_andnot_ps(swapped, sin_poly));
+		const auto c = _mm_or_ps(_mm_and_ps(swapped, sin_poly), _mm_andnot_ps(swapped, cos_poly));
+
+		const auto sin_sign = _mm_xor_ps(
+			_mm_and_ps(radians, sign_bit),
+			_mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(octant, _mm_set1_epi32(4)), 29))
+		);
+
+		const auto cos_sign = _mm_castsi128_ps(
+			_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(octant, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29)
+		);
+
+		out_sin = _mm_xor_ps(s, sin_sign);
+		out_cos = _mm_xor_ps(c, cos_sign);
+	}
+#endif
+
+#if AUGS_GENERAL_PARTICLES_AVX
+	struct avx_lanes {
+		using type = __m256;
+		static constexpr int n = 8;
+
+		static type load(const float* p) { return _mm256_loadu_ps(p); }
+		static void store(float* p, const type v) { _mm256_storeu_ps(p, v); }
+		static type set1(const float v) { return _mm256_set1_ps(v); }
+
+		static type add(const type a, const type b) { return _mm256_add_ps(a, b); }
+		static type sub(const type a, const type b) { return _mm256_sub_ps(a, b); }
+		static type mul(const type a, const type b) { return _mm256_mul_ps(a, b); }
+		static type div(const type a, const type b) { return _mm256_div_ps(a, b); }
+		static type sqrt(const type a) { return _mm256_sqrt_ps(a); }
+		static type abs(const type a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a); }
+
+		static type eq(const type a, const type b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+		static type lt(const type a, const type b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+		static type le(const type a, const type b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+		static type gt(const type a, const type b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+
+		static type select(const type m, const type a, const type b) {
+			return _mm256_blendv_ps(b, a, m);
+		}
+	};
+#endif
+
+	/*
+		The same operations as generic_integrate_particle, in the same order,
+		so every lane ends up bit-identical to the scalar result.
+	*/
+
+	struct integrated_fields {
+		float* pos_x;
+		float* pos_y;
+		float* vel_x;
+		float* vel_y;
+		const float* acc_x;
+		const float* acc_y;
+		const float* linear_damping;
+
+		float* rotation;
+		float* rotation_speed;
+		const float* angular_damping;
+
+		float* current_lifetime_ms;
+	};
+
+	template <class L>
+	FORCE_INLINE void integrate_lanes(const integrated_fields& f, const int i, const float dt) {
+		using V = typename L::type;
+
+		const V zero = L::set1(0.f);
+		const V one = L::set1(1.f);
+		const V v_dt = L::set1(dt);
+
+		V vx = L::load(f.vel_x + i);
+		V vy = L::load(f.vel_y + i);
+
+		vx = L::add(vx, L::mul(L::load(f.acc_x + i), v_dt));
+		vy = L::add(vy, L::mul(L::load(f.acc_y + i), v_dt));
+
+		L::store(f.pos_x + i, L::add(L::load(f.pos_x + i), L::mul(vx, v_dt)));
+		L::store(f.pos_y + i, L::add(L::load(f.pos_y + i), L::mul(vy, v_dt)));
+
+		{
+			/* vec2::shrink */
+			const V shrunk_by = L::mul(L::load(f.linear_damping + i), v_dt);
+			const V len = L::sqrt(L::add(L::mul(vx, vx), L::mul(vy, vy)));
+
+			/* vec2::normalize_hint leaves near-zero vectors alone */
+			const V normalizable = L::select(
+				L::lt(L::abs(len), L::set1(std::numeric_limits<float>::epsilon())),
+				zero,
+				L::eq(zero, zero)
+			);
+
+			const V inv_len = L::div(one, len);
+			const V nx = L::select(normalizable, L::mul(vx, inv_len), vx);
+			const V ny = L::select(normalizable, L::mul(vy, inv_len), vy);
+
+			const V new_len = L::sub(len, shrunk_by);
+			const V vanished = L::le(len, shrunk_by);
+			const V untouched = L::eq(shrunk_by, zero);
+
+			vx = L::select(untouched, vx, L::select(vanished, zero, L::mul(nx, new_len)));
+			vy = L::select(untouched, vy, L::select(vanished, zero, L::mul(ny, new_len)));
+		}
+
+		L::store(f.vel_x + i, vx);
+		L::store(f.vel_y + i, vy);
+
+		L::store(f.current_lifetime_ms + i, L::add(L::load(f.current_lifetime_ms + i), L::set1(dt * 1000)));
+
+		{
+			const V speed = L::load(f.rotation_speed + i);
+			L::store(f.rotation + i, L::add(L::load(f.rotation + i), L::mul(speed, v_dt)));
+
+			/* augs::shrink */
+			const V shrunk_by = L::mul(L::load(f.angular_damping + i), v_dt);
+
+			const V decreased = L::sub(speed, shrunk_by);
+			const V increased = L::add(speed, shrunk_by);
+
+			const V if_positive = L::select(L::lt(decreased, zero), zero, decreased);
+			const V if_negative = L::select(L::gt(increased, zero), zero, increased);
+
+			L::store(
+				f.rotation_speed + i,
+				L::select(L::gt(speed, zero), if_positive, L::select(L::lt(speed, zero), if_negative, speed))
+			);
+		}
+	}
+}
+
+void general_particle_store::integrate_scalar(int from, const int to, const float dt) {
+	for (; from < to; ++from) {
+		const auto i = static_cast<std::size_t>(from);
+
+		auto vel = vec2(vel_x[i], vel_y[i]);
+		auto pos = vec2(pos_x[i], pos_y[i]);
+
+		vel += vec2(acc_x[i], acc_y[i]) * dt;
+		pos += vel * dt;
+
+		vel.shrink(linear_damping[i] * dt);
+
+		vel_x[i] = vel.x;
+		vel_y[i] = vel.y;
+		pos_x[i] = pos.x;
+		pos_y[i] = pos.y;
+
+		current_lifetime_ms[i] += dt * 1000;
+
+		rotation[i] += rotation_speed[i] * dt;
+		augs::shrink(rotation_speed[i], angular_damping[i] * dt);
+	}
+}
+
+void general_particle_store::integrate(int from, const int to, const float dt) {
+#if AUGS_GENERAL_PARTICLES_AVX || AUGS_GENERAL_PARTICLES_SSE2
+	const auto f = integrated_fields {
+		pos_x.data(),
+		pos_y.data(),
+		vel_x.data(),
+		vel_y.data(),
+		acc_x.data(),
+		acc_y.data(),
+		linear_damping.data(),
+
+		rotation.data(),
+		rotation_speed.data(),
+		angular_damping.data(),
+
+		current_lifetime_ms.data()
+	};
+#endif
+
+#if AUGS_GENERAL_PARTICLES_AVX
+	for (; from + avx_lanes::n <= to; from += avx_lanes::n) {
+		integrate_lanes<avx_lanes>(f, from, dt);
+	}
+#endif
+
+#if AUGS_GENERAL_PARTICLES_SSE2
+	for (; from + sse_lanes::n <= to; from += sse_lanes::n) {
+		integrate_lanes<sse_lanes>(f, from, dt);
+	}
+#endif
+
+	integrate_scalar(from, to, dt);
+}
+
+void general_particle_store::calc_size_mults(int from, const int to, float* out) const {
+	/*
+		Same formulas as in general_particle::draw_as_sprite.
+		Note that std::min(1.f, x) is x < 1 ? x : 1, which is exactly _mm_min_ps(x, 1).
+	*/
+
+#if AUGS_GENERAL_PARTICLES_SSE2
+	const auto zero = _mm_set1_ps(0.f);
+	const auto one = _mm_set1_ps(1.f);
+
+	for (; from + 4 <= to; from += 4, out += 4) {
+		const auto current = _mm_loadu_ps(current_lifetime_ms.data() + from);
+		const auto shrink_when = _mm_loadu_ps(shrink_when_ms_remaining.data() + from);
+		const auto unshrinking = _mm_loadu_ps(unshrinking_time_ms.data() + from);
+
+		auto mult = one;
+
+		{
+			const auto remaining = _mm_sub_ps(_mm_loadu_ps(max_lifetime_ms.data() + from), current);
+			const auto alivity = _mm_min_ps(_mm_div_ps(remaining, shrink_when), one);
+			const auto shrinking = _mm_cmpgt_ps(shrink_when, zero);
+
+			mult = _mm_or_ps(_mm_and_ps(shrinking, _mm_mul_ps(mult, _mm_sqrt_ps(alivity))), _mm_andnot_ps(shrinking, mult));
+		}
+
+		{
+			const auto progress = _mm_div_ps(current, unshrinking);
+			const auto growth = _mm_min_ps(_mm_mul_ps(progress, progress), one);
+			const auto unshrinking_now = _mm_cmpgt_ps(unshrinking, zero);
+
+			mult = _mm_or_ps(_mm_and_ps(unshrinking_now, _mm_mul_ps(mult, growth)), _mm_andnot_ps(unshrinking_now, mult));
+		}
+
+		_mm_storeu_ps(out, mult);
+	}
+#endif
+
+	for (; from < to; ++from, ++out) {
+		const auto i = static_cast<std::size_t>(from);
+
+		float size_mult = 1.f;
+
+		if (shrink_when_ms_remaining[i] > 0.f) {
+			const auto alivity_multiplier = std::min(1.f, (max_lifetime_ms[i] - current_lifetime_ms[i]) / shrink_when_ms_remaining[i]);
+			size_mult *= std::sqrt(alivity_multiplier);
+		}
+
+		if (unshrinking_time_ms[i] > 0.f) {
+			const auto progress = current_lifetime_ms[i] / unshrinking_time_ms[i];
+			size_mult *= std::min(1.f, progress * progress);
+		}
+
+		*out = size_mult;
+	}
+}
+
+void general_particle_store::calc_sprite_points(
+	const int from,
+	const int to,
+	const float* const size_mults,
+	augs::sprite_points* const out_points,
+	bool* const out_visible
+) const {
+	/*
+		Corners before rotation are (left, top), (right, top), (right, bottom), (left, bottom),
+		computed just like in augs::make_rect_points.
+	*/
+
+	const auto n = to - from;
+
+	alignas(16) std::array<float, draw_batch> left;
+	alignas(16) std::array<float, draw_batch> top;
+	alignas(16) std::array<float, draw_batch> right;
+	alignas(16) std::array<float, draw_batch> bottom;
+	alignas(16) std::array<float, draw_batch> radians;
+
+	for (int j = 0; j < n; ++j) {
+		const auto i = from + j;
+
+		vec2i drawn_size;
+		out_visible[j] = calc_drawn_size(i, size_mults[j], drawn_size);
+
+		const auto h_size = vec2(-drawn_size / 2);
+
+		left[j] = h_size.x;
+		top[j] = h_size.y;
+		right[j] = h_size.x + drawn_size.x;
+		bottom[j] = h_size.y + drawn_size.y;
+
+		radians[j] = DEG_TO_RAD<float> * rotation[i];
+	}
+
+	int j = 0;
+
+#if AUGS_GENERAL_PARTICLES_SSE2
+	for (; j + 4 <= n; j += 4) {
+		__m128 s;
+		__m128 c;
+
+		sincos_lanes(_mm_load_ps(radians.data() + j), s, c);
+
+		const auto px = _mm_loadu_ps(pos_x.data() + from + j);
+		const auto py = _mm_loadu_ps(pos_y.data() + from + j);
+
+		const std::array<__m128, 2> xs = { _mm_load_ps(left.data() + j), _mm_load_ps(right.data() + j) };
+		const std::array<__m128, 2> ys = { _mm_load_ps(top.data() + j), _mm_load_ps(bottom.data() + j) };
+
+		/* Which of left/right and top/bottom each corner uses */
+		static constexpr int corner_x[4] = { 0, 1, 1, 0 };
+		static constexpr int corner_y[4] = { 0, 0, 1, 1 };
+
+		for (int k = 0; k < 4; ++k) {
+			const auto x = xs[corner_x[k]];
+			const auto y = ys[corner_y[k]];
+
+			alignas(16) float rotated_x[4];
+			alignas(16) float rotated_y[4];
+
+			_mm_store_ps(rotated_x, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(x, c), _mm_mul_ps(y, s)), px));
+			_mm_store_ps(rotated_y, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, s), _mm_mul_ps(y, c)), py));
+
+			for (int lane = 0; lane < 4; ++lane) {
+				out_points[j + lane][k] = vec2(rotated_x[lane], rotated_y[lane]);
+			}
+		}
+	}
+#endif
+
+	for (; j < n; ++j) {
+		const auto i = static_cast<std::size_t>(from + j);
+		const auto s = static_cast<real32>(std::sin(radians[j]));
+		const auto c = static_cast<real32>(std::cos(radians[j]));
+
+		const vec2 corners[4] = {
+			{ left[j], top[j] },
+			{ right[j], top[j] },
+			{ right[j], bottom[j] },
+			{ left[j], bottom[j] }
+		};
+
+		for (int k = 0; k < 4; ++k) {
+			const auto& v = corners[k];
+			out_points[j][k] = vec2(v.x * c - v.y * s + pos_x[i], v.x * s + v.y * c + pos_y[i]);
+		}
+	}
+}
+
+void general_particle_store::remove_dead() {
+	std::size_t alive = 0;
+
+	for (std::size_t i = 0; i < count; ++i) {
+		if (current_lifetime_ms[i] >= max_lifetime_ms[i]) {
+			continue;
+		}
+
+		if (alive != i) {
+			pos_x[alive] = pos_x[i];
+			pos_y[alive] = pos_y[i];
+			vel_x[alive] = vel_x[i];
+			vel_y[alive] = vel_y[i];
+			acc_x[alive] = acc_x[i];
+			acc_y[alive] = acc_y[i];
+			linear_damping[alive] = linear_damping[i];
+
+			rotation[alive] = rotation[i];
+			rotation_speed[alive] = rotation_speed[i];
+			angular_damping[alive] = angular_damping[i];
+
+			current_lifetime_ms[alive] = current_lifetime_ms[i];
+			max_lifetime_ms[alive] = max_lifetime_ms[i];
+			shrink_when_ms_remaining[alive] = shrink_when_ms_remaining[i];
+			unshrinking_time_ms[alive] = unshrinking_time_ms[i];
+
+			sizes[alive] = sizes[i];
+			image_ids[alive] = image_ids[i];
+			colors[alive] = colors[i];
+			alpha_levels[alive] = alpha_levels[i];
+		}
+
+		++alive;
+	}
+
+	count = alive;
+}
+
+#if BUILD_UNIT_TESTS
+#include <vector>
+#include <memory>
+#include <cstring>
+#include <Catch/single_include/catch2/catch.hpp>
+#include "augs/misc/randomization.h"
+#include "view/viewables/image_in_atlas.h"
+
+namespace {
+	struct test_images {
+		image_in_atlas entry;
+
+		const image_in_atlas& at(assets::image_id) const {
+			return entry;
+		}
+	};
+
+	auto make_test_particles(randomization& rng, const std::size_t n) {
+		std::vector<general_particle> result;
+
+		for (std::size_t i = 0; i < n; ++i) {
+			general_particle p;
+
+			p.pos = { rng.randval(-1000.f, 1000.f), rng.randval(-1000.f, 1000.f) };
+			p.vel = { rng.randval(-500.f, 500.f), rng.randval(-500.f, 500.f) };
+			p.acc = { rng.randval(-50.f, 50.f), rng.randval(-50.f, 50.f) };
+			p.size = { rng.randval(1, 40), rng.randval(1, 40) };
+			p.rotation = rng.randval(0.f, 360.f);
+			p.rotation_speed = rng.randval(-720.f, 720.f);
+
+			/* Some particles keep their speed, some stop within a few steps */
+			p.linear_damping = i % 5 == 0 ? 0.f : rng.randval(0.f, 3000.f);
+			p.angular_damping = i % 7 == 0 ? 0.f : rng.randval(0.f, 3000.f);
+
+			p.max_lifetime_ms = rng.randval(50.f, 2000.f);
+			p.shrink_when_ms_remaining = i % 3 == 0 ? 0.f : rng.randval(0.f, 500.f);
+			p.unshrinking_time_ms = i % 4 == 0 ? 0.f : rng.randval(0.f, 200.f);
+
+			result.push_back(p);
+		}
+
+		return result;
+	}
+
+	bool same_bits(const float a, const float b) {
+		return std::memcmp(&a, &b, sizeof(float)) == 0;
+	}
+}
+
+TEST_CASE("GeneralParticleStore MatchesScalarParticles") {
+	auto rng = randomization(1234);
+
+	const auto n = std::size_t(1003);
+	auto particles = make_test_particles(rng, n);
+
+	auto store = std::make_unique<general_particle_store>();
+
+	for (const auto& p : particles) {
+		store->push_back(p);
+	}
+
+	auto images = test_images();
+	images.entry.diffuse.atlas_space = { 0.25f, 0.5f, 0.125f, 0.0625f };
+
+	for (int step = 0; step < 40; ++step) {
+		const auto dt = step % 2 == 0 ? 1 / 60.f : 1 / 144.f;
+
+		for (auto& p : particles) {
+			p.integrate(dt);
+		}
+
+		store->integrate(0, static_cast<int>(store->size()), dt);
+
+		REQUIRE(store->size() == particles.size());
+
+		for (std::size_t i = 0; i < particles.size(); ++i) {
+			const auto& expected = particles[i];
+			const auto actual = store->get(i);
+
+			REQUIRE(same_bits(expected.pos.x, actual.pos.x));
+			REQUIRE(same_bits(expected.pos.y, actual.pos.y));
+			REQUIRE(same_bits(expected.vel.x, actual.vel.x));
+			REQUIRE(same_bits(expected.vel.y, actual.vel.y));
+			REQUIRE(same_bits(expected.rotation, actual.rotation));
+			REQUIRE(same_bits(expected.rotation_speed, actual.rotation_speed));
+			REQUIRE(same_bits(expected.current_lifetime_ms, actual.current_lifetime_ms));
+		}
+
+		{
+			/* Start the range at an odd index to exercise the scalar head and tail */
+			const auto from = 3;
+			const auto to = static_cast<int>(particles.size());
+
+			std::vector<augs::vertex_triangle> expected(2 * (to - from));
+			std::vector<augs::vertex_triangle> actual(2 * (to - from));
+
+			for (int i = from; i < to; ++i) {
+				const auto li = i - from;
+				particles[i].draw_as_sprite<false>(expected[2 * li], expected[2 * li + 1], images, {});
+			}
+
+			store->write_sprites(actual.data(), from, to, images);
+
+			for (std::size_t t = 0; t < expected.size(); ++t) {
+				for (int v = 0; v < 3; ++v) {
+					const auto& e = expected[t].vertices[v];
+					const auto& a = actual[t].vertices[v];
+
+					REQUIRE(e.texcoord == a.texcoord);
+					REQUIRE(e.color == a.color);
+					REQUIRE((e.pos - a.pos).length() < 0.01f);
+				}
+			}
+		}
+
+		erase_if(particles, [](const auto& p) { return p.is_dead(); });
+		store->remove_dead();
+	}
+
+	REQUIRE(particles.size() < n);
+}
+#endif
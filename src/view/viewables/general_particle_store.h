@@ -0,0 +1,235 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <algorithm>
+
+#include "view/viewables/particle_types.h"
+
+/*
+	General particles of a single layer, kept as a structure of arrays.
+
+	Integration reads and writes only the kinematic and lifetime fields,
+	so these live in separate contiguous arrays and are advanced several particles at a time.
+	Fields that are only needed for drawing are kept apart so they do not pollute the cache during integration.
+
+	Integration is bit-identical to calling general_particle::integrate on each particle in turn.
+	Drawing matches general_particle::draw_as_sprite except that the vertices are rotated
+	with a vectorized sine and cosine, so their positions may differ in the last bits.
+*/
+
+class general_particle_store {
+public:
+	static constexpr std::size_t capacity = general_particle::statically_allocate;
+
+private:
+	template <class T>
+	using field = std::array<T, capacity>;
+
+	std::size_t count = 0;
+
+	alignas(32) field<float> pos_x;
+	alignas(32) field<float> pos_y;
+	alignas(32) field<float> vel_x;
+	alignas(32) field<float> vel_y;
+	alignas(32) field<float> acc_x;
+	alignas(32) field<float> acc_y;
+	alignas(32) field<float> linear_damping;
+
+	alignas(32) field<float> rotation;
+	alignas(32) field<float> rotation_speed;
+	alignas(32) field<float> angular_damping;
+
+	alignas(32) field<float> current_lifetime_ms;
+	alignas(32) field<float> max_lifetime_ms;
+	alignas(32) field<float> shrink_when_ms_remaining;
+	alignas(32) field<float> unshrinking_time_ms;
+
+	field<vec2i> sizes;
+	field<assets::image_id> image_ids;
+	field<rgba> colors;
+	field<int> alpha_levels;
+
+	void integrate_scalar(int from, int to, float dt);
+	void calc_size_mults(int from, int to, float* out) const;
+	void calc_sprite_points(int from, int to, const float* size_mults, augs::sprite_points* out_points, bool* out_visible) const;
+
+	/*
+		Returns false if the particle shrank to nothing.
+		This mirrors the checks in general_particle::draw_as_sprite.
+	*/
+
+	bool calc_drawn_size(const int i, const float size_mult, vec2i& out) const {
+		if (size_mult != 1.f) {
+			out = vec2i(vec2(sizes[i]) * size_mult);
+			return out.area() > 1;
+		}
+
+		out = sizes[i];
+		return true;
+	}
+
+	static constexpr int draw_batch = 8;
+
+	/*
+		Same vertices as augs::write_sprite_triangles without flips,
+		but every corner is mapped to atlas space only once.
+	*/
+
+	static void write_quad(
+		augs::vertex_triangle& t1,
+		augs::vertex_triangle& t2,
+		const augs::atlas_entry& texture,
+		const augs::sprite_points& v,
+		const rgba col
+	) {
+		const auto uv0 = texture.get_atlas_space_uv(vec2(0.f, 0.f));
+		const auto uv1 = texture.get_atlas_space_uv(vec2(1.f, 0.f));
+		const auto uv2 = texture.get_atlas_space_uv(vec2(1.f, 1.f));
+		const auto uv3 = texture.get_atlas_space_uv(vec2(0.f, 1.f));
+
+		t1.vertices[0] = { v[0], uv0, col };
+		t1.vertices[1] = { v[2], uv2, col };
+		t1.vertices[2] = { v[3], uv3, col };
+
+		t2.vertices[0] = { v[0], uv0, col };
+		t2.vertices[1] = { v[1], uv1, col };
+		t2.vertices[2] = { v[2], uv2, col };
+	}
+
+public:
+	std::size_t size() const {
+		return count;
+	}
+
+	static constexpr std::size_t max_size() {
+		return capacity;
+	}
+
+	bool empty() const {
+		return count == 0;
+	}
+
+	void clear() {
+		count = 0;
+	}
+
+	void push_back(const general_particle& p) {
+		const auto i = count++;
+
+		pos_x[i] = p.pos.x;
+		pos_y[i] = p.pos.y;
+		vel_x[i] = p.vel.x;
+		vel_y[i] = p.vel.y;
+		acc_x[i] = p.acc.x;
+		acc_y[i] = p.acc.y;
+		linear_damping[i] = p.linear_damping;
+
+		rotation[i] = p.rotation;
+		rotation_speed[i] = p.rotation_speed;
+		angular_damping[i] = p.angular_damping;
+
+		current_lifetime_ms[i] = p.current_lifetime_ms;
+		max_lifetime_ms[i] = p.max_lifetime_ms;
+		shrink_when_ms_remaining[i] = p.shrink_when_ms_remaining;
+		unshrinking_time_ms[i] = p.unshrinking_time_ms;
+
+		sizes[i] = p.size;
+		image_ids[i] = p.image_id;
+		colors[i] = p.color;
+		alpha_levels[i] = p.alpha_levels;
+	}
+
+	general_particle get(const std::size_t i) const {
+		general_particle p;
+
+		p.pos = { pos_x[i], pos_y[i] };
+		p.vel = { vel_x[i], vel_y[i] };
+		p.acc = { acc_x[i], acc_y[i] };
+		p.linear_damping = linear_damping[i];
+
+		p.rotation = rotation[i];
+		p.rotation_speed = rotation_speed[i];
+		p.angular_damping = angular_damping[i];
+
+		p.current_lifetime_ms = current_lifetime_ms[i];
+		p.max_lifetime_ms = max_lifetime_ms[i];
+		p.shrink_when_ms_remaining = shrink_when_ms_remaining[i];
+		p.unshrinking_time_ms = unshrinking_time_ms[i];
+
+		p.size = sizes[i];
+		p.image_id = image_ids[i];
+		p.color = colors[i];
+		p.alpha_levels = alpha_levels[i];
+
+		return p;
+	}
+
+	/*
+		Advances particles in [from, to) by dt seconds.
+		Uses AVX or SSE2 where the build allows it, otherwise falls back to the scalar loop.
+	*/
+
+	void integrate(int from, int to, float dt);
+
+	/* Removes dead particles, preserving the order of the remaining ones. */
+
+	void remove_dead();
+
+	/*
+		Writes two triangles per particle in [from, to) starting at out[0].
+		Particles that shrank to nothing leave their triangles untouched,
+		just like general_particle::draw_as_sprite.
+	*/
+
+	template <class M>
+	void write_sprites(augs::vertex_triangle* const out, const int from, const int to, const M& manager) const {
+		std::array<float, draw_batch> size_mults;
+		std::array<augs::sprite_points, draw_batch> points;
+		std::array<bool, draw_batch> visible;
+
+		for (int i = from; i < to; i += draw_batch) {
+			const auto batch_end = std::min(i + draw_batch, to);
+
+			calc_size_mults(i, batch_end, size_mults.data());
+			calc_sprite_points(i, batch_end, size_mults.data(), points.data(), visible.data());
+
+			for (int j = i; j < batch_end; ++j) {
+				if (visible[j - i]) {
+					const auto considered_texture = static_cast<augs::atlas_entry>(manager.at(image_ids[j]));
+					const auto li = j - from;
+
+					write_quad(out[2 * li], out[2 * li + 1], considered_texture, points[j - i], colors[j]);
+				}
+			}
+		}
+	}
+
+	template <class M>
+	void write_neon_sprites(augs::vertex_triangle* const out, const int from, const int to, const M& manager) const {
+		std::array<float, draw_batch> size_mults;
+
+		for (int i = from; i < to; i += draw_batch) {
+			const auto batch_end = std::min(i + draw_batch, to);
+
+			calc_size_mults(i, batch_end, size_mults.data());
+
+			for (int j = i; j < batch_end; ++j) {
+				vec2i drawn_size;
+
+				if (calc_drawn_size(j, size_mults[j - i], drawn_size)) {
+					const auto li = j - from;
+
+					augs::detail_write_neon_sprite(
+						out[2 * li],
+						out[2 * li + 1],
+						manager.at(image_ids[j]),
+						drawn_size,
+						vec2(pos_x[j], pos_y[j]),
+						rotation[j],
+						colors[j]
+					);
+				}
+			}
+		}
+	}
+};
@@ -7,5 +7,9 @@ struct content_regeneration_settings {
 
 	unsigned atlas_blitting_threads = 2;
 	unsigned neon_regeneration_threads = 2;
+	bool cache_baked_atlas = true;
+
+	bool cache_decoded_sounds = true;
+	unsigned sound_decoding_threads = 2;
 	// END GEN INTROSPECTOR
 };
\ No newline at end of file
@@ -124,11 +124,15 @@ void regenerate_and_gather_subjects(
 		thread_local baked_atlas baked;
 		baked.clear();
 
+		const auto& settings = in.subjects.settings;
+		const bool use_cache = settings.cache_baked_atlas && !settings.regenerate_every_time;
+
 		bake_fresh_atlas(
 			{
 				atlas_subjects,
 				in.max_atlas_size,
-				in.subjects.settings.atlas_blitting_threads
+				settings.atlas_blitting_threads,
+				use_cache ? augs::path_type(GENERATED_FILES_DIR) / "baked_atlases" : augs::path_type()
 			},
 			{
 				in.atlas_image_output,
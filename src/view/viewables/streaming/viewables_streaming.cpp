@@ -13,6 +13,8 @@
 #include "augs/misc/imgui/imgui_control_wrappers.h"
 #include "augs/misc/imgui/imgui_scope_wrappers.h"
 #include "augs/filesystem/file.h"
+#include "augs/audio/sound_data.h"
+#include "augs/templates/thread_pool.h"
 
 void viewables_streaming::request_rescan() {
 	if (!general_atlas.empty()) {
@@ -270,21 +272,61 @@ void viewables_streaming::load_all(const viewables_load_input in) {
 
 		if (sound_requests.size() > 0) {
 			future_loaded_buffers = launch_async(
-				[&](){
+				[this, settings](){
 					using value_type = decltype(future_loaded_buffers.get());
 
+					/* 
+						Decoding only touches the filesystem, so it is spread across workers.
+						The buffers are then created in order, on this thread.
+					*/
+
+					std::vector<std::optional<std::vector<augs::sound_data>>> decoded(sound_requests.size());
+
+					{
+						const auto cache_root = 
+							settings.cache_decoded_sounds 
+							? augs::path_type(GENERATED_FILES_DIR) / "decoded_sounds"
+							: augs::path_type()
+						;
+
+						const auto num_workers = std::size_t(std::max(settings.sound_decoding_threads, 1u) - 1);
+
+						static augs::thread_pool workers = 0;
+						workers.resize(num_workers);
+
+						for (std::size_t i = 0; i < sound_requests.size(); ++i) {
+							const auto& r = sound_requests[i];
+
+							if (r.second.source_sound.empty()) {
+								/* A request to unload. */
+								continue;
+							}
+
+							workers.enqueue([&decoded, &r, &cache_root, i]() {
+								try {
+									decoded[i] = augs::decode_sound_variations(r.second, cache_root);
+								}
+								catch (...) {
+
+								}
+							});
+						}
+
+						workers.submit();
+						workers.help_until_no_tasks();
+						workers.wait_for_all_tasks_to_complete();
+					}
+
 					value_type result;
 
-					for (const auto& r : sound_requests) {
-						if (r.second.source_sound.empty()) {
-							/* A request to unload. */
+					for (std::size_t i = 0; i < sound_requests.size(); ++i) {
+						if (decoded[i] == std::nullopt) {
 							result.push_back(std::nullopt);
 							continue;
 						}
 
 						try {
-							augs::sound_buffer b = r.second;
-							result.emplace_back(std::move(b));
+							result.emplace_back(augs::sound_buffer(*decoded[i], sound_requests[i].second.settings));
 						}
 						catch (...) {
 							result.push_back(std::nullopt);
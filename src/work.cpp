@@ -3,6 +3,9 @@
 #endif
 
 #include <functional>
+#include <thread>
+#include <atomic>
+#include <limits>
 
 #include "fp_consistency_tests.h"
 
@@ -15,6 +18,7 @@
 #include "augs/templates/history.hpp"
 #include "augs/templates/traits/in_place.h"
 #include "augs/templates/thread_pool.h"
+#include "augs/templates/thread_templates.h"
 #include "augs/templates/introspection_utils/introspective_equal.h"
 
 #include "augs/filesystem/file.h"
@@ -26,6 +30,7 @@
 
 #include "augs/graphics/renderer.h"
 #include "augs/graphics/renderer_backend.h"
+#include "augs/graphics/null_renderer_backend.h"
 
 #include "augs/window_framework/shell.h"
 #include "augs/window_framework/window.h"
@@ -62,6 +67,10 @@
 #include "application/gui/ingame_menu_gui.h"
 
 #include "application/masterserver/masterserver.h"
+#include "application/benchmark/solve_benchmark.h"
+#include "application/benchmark/particles_benchmark.h"
+#include "application/benchmark/delta_benchmark.h"
+#include "application/benchmark/headless_client.h"
 
 #include "application/network/network_common.h"
 #include "application/setups/all_setups.h"
@@ -81,6 +90,7 @@
 
 #include "application/setups/draw_setup_gui_input.h"
 #include "application/network/resolve_address.h"
+#include "application/arena/shared_arena_cache.h"
 #include "augs/network/netcode_socket_raii.h"
 
 #include "cmd_line_params.h"
@@ -103,7 +113,7 @@
 #include "work_result.h"
 
 std::function<void()> ensure_handler;
-bool log_to_live_file = false;
+std::atomic<bool> log_to_live_file = false;
 
 /*
 	static is used for all variables because some take massive amounts of space.
@@ -259,6 +269,45 @@ work_result work(const int argc, const char* const * const argv) try {
 		LOG("Unit tests were disabled.");
 	}
 
+	if (params.solve_benchmark.steps > 0) {
+		LOG("Running the solve benchmark.");
+
+		if (perform_solve_benchmark(lua, params.solve_benchmark)) {
+			return work_result::SUCCESS;
+		}
+
+		return work_result::FAILURE;
+	}
+
+	if (params.particles_benchmark.particles > 0) {
+		LOG("Running the particles benchmark.");
+
+		if (perform_particles_benchmark(params.particles_benchmark)) {
+			return work_result::SUCCESS;
+		}
+
+		return work_result::FAILURE;
+	}
+
+	if (params.delta_benchmark.iterations > 0) {
+		LOG("Running the delta benchmark.");
+
+		if (perform_delta_benchmark(params.delta_benchmark)) {
+			return work_result::SUCCESS;
+		}
+
+		return work_result::FAILURE;
+	}
+
+	if (params.headless_client.enabled) {
+#if BUILD_OPENGL || BUILD_WINDOW_FRAMEWORK
+		LOG("The headless client requires a build with BUILD_OPENGL and BUILD_WINDOW_FRAMEWORK turned off.");
+		return work_result::FAILURE;
+#else
+		LOG("Running the headless client.");
+#endif
+	}
+
 	LOG("Initializing ImGui.");
 
 	static const auto imgui_ini_path = std::string(USER_FILES_DIR) + "/" + get_preffix_for(current_app_type) + "imgui.ini";
@@ -275,7 +324,8 @@ work_result work(const int argc, const char* const * const argv) try {
 
 	static auto last_update_result = application_update_result();
 	
-	const bool should_update_due_to_config = config.http_client.update_on_launch;
+	/* A headless run measures this very build, so it never upgrades itself. */
+	const bool should_update_due_to_config = config.http_client.update_on_launch && !params.headless_client.enabled;
 
 	if (params.force_update_check || should_update_due_to_config) {
 		using up_result = application_update_result_type;
@@ -552,6 +602,21 @@ work_result work(const int argc, const char* const * const argv) try {
 	if (params.type == app_type::DEDICATED_SERVER) {
 		LOG("Starting the dedicated server at port: %x", chosen_server_port());
 
+		const auto relay_settings = [&]() -> std::optional<server_relay_settings> {
+			auto relay = config.server_relay;
+
+			if (!params.relay_address.empty()) {
+				relay.enabled = true;
+				relay.upstream.address = params.relay_address;
+			}
+
+			if (relay.enabled) {
+				return relay;
+			}
+
+			return std::nullopt;
+		}();
+
 		auto handle_sigint = []() {
 #if PLATFORM_UNIX
 			if (signal_status != 0) {
@@ -601,6 +666,288 @@ work_result work(const int argc, const char* const * const argv) try {
 		start.port = bound_port;
 
 #if BUILD_NETWORKING
+		const auto num_instances = std::max(config.dedicated_server.num_instances, 1u);
+
+		if (num_instances > 1 && relay_settings != std::nullopt) {
+			LOG("ERROR! A relay re-serves exactly one upstream match, so it cannot host %x instances. Set num_instances to 1.", num_instances);
+			return work_result::FAILURE;
+		}
+
+		if (num_instances > 1) {
+			/*
+				Every instance is a separate match bound to a port of its own,
+				with its own lua state and its own copy of the simulated state.
+
+				What the instances share:
+				- arenas are loaded once, through shared_arena_cache,
+				  so the flavours and the logical assets are shared until an instance changes them;
+				- one scheduler drives all of them, see below;
+				- the server list address is resolved once for all of them;
+				- the NATs of all ports are detected at once.
+
+				What was audited for running several instances on a thread pool:
+				- thread_locals in game/ and augs/ are scratch buffers, emptied or overwritten on every use,
+				  so an instance that moves to another worker just uses that worker's scratch.
+				  standard_explosion's rng keeps its state, but it only places the thunders, which are never simulated.
+				  bomb_defusal's thread_local lua state only exists with DUMP_BEFORE_AND_AFTER_ROUND_START.
+				- Function-local statics reachable from server_setup::advance are all const after initialization
+				  (type names, enum maps, constants in movement_path_system and bomb_defusal),
+				  and those are initialized thread-safely.
+				- Mutable globals: cosmos_counter and the pool version counter are atomics,
+				  the log pushes to per-thread rings, and yojimbo is initialized once before any instance starts.
+			*/
+
+			/* Members are ordered so that the server is destroyed before the lua state it references. */
+
+			struct dedicated_instance {
+				sol::state instance_lua;
+				network_profiler network_performance;
+				server_network_info server_stats;
+				nat_detection_result detected_nat;
+				std::unique_ptr<server_setup> setup;
+
+				/* Held until the server binds to the port. */
+				std::optional<netcode_socket_raii> reserved;
+				augs::server_listen_input start;
+			};
+
+			LOG("Hosting %x dedicated server instances in this process.", num_instances);
+
+			std::vector<std::unique_ptr<dedicated_instance>> instances;
+			shared_arena_cache shared_arenas;
+
+			/*
+				Like the auxiliary socket did for the first instance,
+				the port of every next one is probed and reserved by binding a socket to it.
+			*/
+
+			auto reserve_next_port = [](const port_type after) -> std::optional<netcode_socket_raii> {
+				const auto max_attempts = 100u;
+
+				for (unsigned attempt = 1; attempt <= max_attempts; ++attempt) {
+					const auto candidate = static_cast<uint32_t>(after) + attempt;
+
+					if (candidate > std::numeric_limits<port_type>::max()) {
+						break;
+					}
+
+					try {
+						return std::make_optional<netcode_socket_raii>(static_cast<port_type>(candidate));
+					}
+					catch (const netcode_socket_raii_error&) {
+						LOG("Port %x is taken. Trying the next one.", candidate);
+					}
+				}
+
+				return std::nullopt;
+			};
+
+			auto last_port = bound_port;
+
+			for (uint32_t i = 0; i < num_instances; ++i) {
+				auto instance = std::make_unique<dedicated_instance>();
+				instance->start = start;
+
+				if (i == 0) {
+					instance->start.port = bound_port;
+					instance->detected_nat = get_detected_nat();
+				}
+				else {
+					instance->reserved = reserve_next_port(last_port);
+
+					if (instance->reserved == std::nullopt) {
+						LOG("WARNING! Could not find a free port after %x for dedicated server instance %x.", last_port, i);
+						break;
+					}
+
+					instance->start.port = instance->reserved->socket.address.port;
+				}
+
+				last_port = instance->start.port;
+				instances.emplace_back(std::move(instance));
+			}
+
+			/*
+				The NAT has to be detected separately for each port,
+				since the detected mapping - port_delta and predicted_next_port - is specific to the local port.
+				Each is detected through the very socket that reserves the port,
+				but all of them at once rather than one after another.
+			*/
+
+			if (config.server.allow_nat_traversal && instances.size() > 1) {
+				LOG("Detecting NAT for the ports of %x dedicated server instances...", instances.size() - 1);
+
+				std::vector<std::pair<dedicated_instance*, nat_detection_session>> sessions;
+
+				for (auto& instance : instances) {
+					if (instance->reserved != std::nullopt) {
+						sessions.emplace_back(instance.get(), nat_detection_session(config.nat_detection, stun_provider));
+					}
+				}
+
+				for (;;) {
+					bool all_complete = true;
+
+					for (auto& [instance, session] : sessions) {
+						if (session.query_result() == std::nullopt) {
+							session.advance(instance->reserved->socket);
+							all_complete = false;
+						}
+						else {
+							instance->detected_nat = *session.query_result();
+						}
+					}
+
+					if (all_complete) {
+						break;
+					}
+
+					if (handle_sigint()) {
+						/* No instance was started yet. */
+						return work_result::SUCCESS;
+					}
+
+					yojimbo_sleep(1.0 / 1000);
+				}
+			}
+
+			for (std::size_t i = 0; i < instances.size(); ++i) {
+				auto& instance = *instances[i];
+
+				instance.reserved.reset();
+
+				LOG("Starting dedicated server instance %x at port: %x", i, instance.start.port);
+
+				instance.instance_lua = augs::create_lua_state();
+
+				instance.setup = std::make_unique<server_setup>(
+					instance.instance_lua,
+					instance.start,
+					config.server,
+					config.server_solvable,
+					config.client,
+					config.private_server,
+					config.dedicated_server,
+					relay_settings,
+
+					make_server_nat_traversal_input(),
+					std::addressof(shared_arenas)
+				);
+
+				if (!instance.setup->is_running()) {
+					LOG("WARNING! Dedicated server instance %x failed to start at port: %x", i, instance.start.port);
+				}
+			}
+
+			erase_if(instances, [](const auto& instance) { return !instance->setup->is_running(); });
+
+			/*
+				One scheduler drives all the instances.
+
+				On every wakeup, each running instance is advanced on the shared pool
+				- it ticks as many times as it is due, just like a single server would -
+				and then the scheduler sleeps for as long as the soonest of them allows.
+
+				No instance runs between the passes,
+				which is when the server list address is handed over to all of them.
+			*/
+
+			const auto num_workers = std::min<std::size_t>(
+				instances.size(),
+				std::max(std::thread::hardware_concurrency(), 1u)
+			);
+
+			augs::thread_pool tick_pool(num_workers);
+
+			std::future<resolve_address_result> future_server_list_addr;
+			std::optional<netcode_address_t> server_list_addr;
+			net_time_t when_last_resolved_server_list = 0;
+
+			auto resolve_server_list_if_its_time = [&]() {
+				const auto& in = config.server.notified_server_list;
+
+				if (in.address.empty()) {
+					return;
+				}
+
+				if (valid_and_is_ready(future_server_list_addr)) {
+					const auto result = future_server_list_addr.get();
+
+					LOG(result.report());
+
+					if (result.result == resolve_result_type::OK) {
+						server_list_addr = result.addr;
+					}
+				}
+
+				const auto now = yojimbo_time();
+				const auto since_last = now - when_last_resolved_server_list;
+				const auto resolve_every = config.server.resolve_server_list_address_once_every_secs;
+
+				if (!future_server_list_addr.valid() && (server_list_addr == std::nullopt || since_last >= resolve_every)) {
+					LOG("Requesting resolution of server_list address at %x for all instances.", in.address);
+
+					future_server_list_addr = async_resolve_address(in);
+					when_last_resolved_server_list = now;
+				}
+			};
+
+			while (!handle_sigint()) {
+				resolve_server_list_if_its_time();
+
+				std::size_t num_running = 0;
+
+				for (auto& instance : instances) {
+					auto& server = *instance->setup;
+
+					if (!server.is_running()) {
+						continue;
+					}
+
+					++num_running;
+
+					server.use_server_list_address(server_list_addr);
+
+					tick_pool.enqueue([&instance = *instance]() {
+						const auto zoom = 1.f;
+
+						instance.setup->advance(
+							{
+								vec2i(),
+								config.input,
+								zoom,
+								instance.detected_nat,
+								instance.network_performance,
+								instance.server_stats
+							},
+							solver_callbacks()
+						);
+					});
+				}
+
+				if (num_running == 0) {
+					break;
+				}
+
+				tick_pool.submit();
+				tick_pool.wait_for_all_tasks_to_complete();
+
+				auto sleep_secs = std::numeric_limits<double>::max();
+
+				for (const auto& instance : instances) {
+					if (instance->setup->is_running()) {
+						sleep_secs = std::min(sleep_secs, instance->setup->get_sleep_secs_until_next_tick());
+					}
+				}
+
+				if (sleep_secs > 0.0 && sleep_secs != std::numeric_limits<double>::max()) {
+					yojimbo_sleep(sleep_secs);
+				}
+			}
+
+			return work_result::SUCCESS;
+		}
+
 		emplace_current_setup(
 			std::in_place_type_t<server_setup>(),
 			lua,
@@ -610,6 +957,7 @@ work_result work(const int argc, const char* const * const argv) try {
 			config.client,
 			config.private_server,
 			config.dedicated_server,
+			relay_settings,
 
 			make_server_nat_traversal_input()
 		);
@@ -658,6 +1006,29 @@ work_result work(const int argc, const char* const * const argv) try {
 	LOG("Initializing the renderer backend.");
 	static augs::graphics::renderer_backend renderer_backend;
 
+	static std::optional<augs::graphics::null_renderer_backend> headless_backend;
+	static render_commands_profiler render_commands_performance;
+
+	if (params.headless_client.enabled) {
+		LOG("Initializing the null renderer backend.");
+
+		try {
+			headless_backend.emplace(params.headless_client.dump_path);
+		}
+		catch (const augs::file_open_error& err) {
+			LOG("(Headless client) Failed to open the dump file %x: %x", params.headless_client.dump_path, err.what());
+			return work_result::FAILURE;
+		}
+	}
+
+	static auto get_max_texture_size = []() {
+		if (headless_backend) {
+			return headless_backend->get_max_texture_size();
+		}
+
+		return renderer_backend.get_max_texture_size();
+	};
+
 	static game_frame_buffer_swapper buffer_swapper;
 
 	static auto get_read_buffer = []() -> game_frame_buffer& {
@@ -680,7 +1051,7 @@ work_result work(const int argc, const char* const * const argv) try {
 		return get_write_buffer().renderers.all[renderer_type::GENERAL];
 	};
 
-	LOG_NVPS(renderer_backend.get_max_texture_size());
+	LOG_NVPS(get_max_texture_size());
 
 	LOG("Initializing the necessary fbos.");
 	static all_necessary_fbos necessary_fbos(
@@ -721,6 +1092,10 @@ work_result work(const int argc, const char* const * const argv) try {
 	static atlas_profiler atlas_performance;
 	static frame_profiler game_thread_performance;
 
+	if (params.headless_client.enabled) {
+		game_thread_performance.total.enable_percentiles(1e-6, 10.0);
+	}
+
 	/* 
 		unique_ptr is used to avoid stack overflow.
 
@@ -848,6 +1223,22 @@ work_result work(const int argc, const char* const * const argv) try {
 
 	static std::atomic<augs::frame_num_type> current_frame = 0;
 
+	/* 
+		The headless client only measures the frames rendered once the gameplay is on,
+		so that connecting and loading the demo never count towards the results.
+	*/
+
+	static std::optional<augs::frame_num_type> headless_first_frame;
+	static augs::timer headless_client_timer;
+
+	static auto get_num_headless_frames = []() -> augs::frame_num_type {
+		if (headless_first_frame) {
+			return current_frame.load() - *headless_first_frame;
+		}
+
+		return 0;
+	};
+
 	static auto load_all = [&](const all_viewables_defs& new_defs) {
 		const auto frame_num = current_frame.load();
 
@@ -867,7 +1258,7 @@ work_result work(const int argc, const char* const * const argv) try {
 			config.content_regeneration,
 			get_unofficial_content_dir(),
 			get_general_renderer(),
-			renderer_backend.get_max_texture_size(),
+			get_max_texture_size(),
 
 			new_player_metas
 		});
@@ -1016,6 +1407,7 @@ work_result work(const int argc, const char* const * const argv) try {
 						config.client,
 						config.private_server,
 						std::nullopt,
+						std::nullopt,
 
 						make_server_nat_traversal_input()
 					);
@@ -1989,6 +2381,13 @@ work_result work(const int argc, const char* const * const argv) try {
 	else if (params.start_server) {
 		launch_setup(launch_type::SERVER);
 	}
+	else if (!params.headless_client.demo_path.empty()) {
+		/* Not saved to the config file, so that the next regular launch does not start a replay. */
+		config.default_client_start.chosen_address_type = connect_address_type::REPLAY;
+		config.default_client_start.replay_demo = params.headless_client.demo_path;
+
+		launch_setup(launch_type::CLIENT);
+	}
 	else if (params.should_connect) {
 		{
 			const auto& target = params.connect_address;
@@ -2141,6 +2540,11 @@ work_result work(const int argc, const char* const * const argv) try {
 				return false;
 			};
 
+			auto headless_frames_elapsed = []() {
+				const auto frames = params.headless_client.frames;
+				return headless_first_frame != std::nullopt && frames > 0 && get_num_headless_frames() >= frames;
+			};
+
 			auto perform_input_pass = [&]() -> input_pass_result {
 				/* 
 					The centralized transformation of all window inputs.
@@ -2838,6 +3242,12 @@ work_result work(const int argc, const char* const * const argv) try {
 				return;
 			}
 
+			if (headless_frames_elapsed()) {
+				LOG("(Headless client) Rendered %x frames of gameplay. Quitting.", get_num_headless_frames());
+				request_quit();
+				return;
+			}
+
 			ensure_float_flags_hold();
 
 			if (setup_requires_cursor()) {
@@ -3048,6 +3458,33 @@ work_result work(const int argc, const char* const * const argv) try {
 		}
 	};
 
+	/* Declared before the joiner of the game thread, so that it only runs once the game thread has finished. */
+	auto headless_client_reporter = augs::scope_guard([]() {
+		if (headless_backend == std::nullopt) {
+			return;
+		}
+
+		if (headless_first_frame == std::nullopt) {
+			LOG("(Headless client) The gameplay has never started. Nothing was measured.");
+			return;
+		}
+
+		try {
+			report_headless_client_performance({
+				params.headless_client,
+				static_cast<std::size_t>(get_num_headless_frames()),
+				headless_client_timer.get<std::chrono::seconds>(),
+				game_thread_performance,
+				render_thread_performance,
+				render_commands_performance,
+				get_audiovisuals().performance
+			});
+		}
+		catch (const augs::file_open_error& err) {
+			LOG("(Headless client) Failed to write the report: %x", err.what());
+		}
+	});
+
 	static auto game_thread = std::thread(game_thread_worker);
 
 	auto audio_thread_joiner = augs::scope_guard([]() { audio_buffers.quit(); });
@@ -3090,6 +3527,29 @@ work_result work(const int argc, const char* const * const argv) try {
 		for (const auto& f : renderer_backend_result.imgui_lists_to_delete) {
 			IM_DELETE(f);
 		}
+
+		if (headless_backend && headless_first_frame == std::nullopt) {
+			bool gameplay_on = false;
+
+			on_specific_setup([&](client_setup& setup) {
+				gameplay_on = setup.is_gameplay_on();
+			});
+
+			if (gameplay_on) {
+				/* Both threads are synchronized here, so the profilers can be safely reset. */
+
+				LOG("(Headless client) The gameplay has started at frame %x. Measuring from now on.", current_frame.load());
+
+				game_thread_performance = frame_profiler();
+				game_thread_performance.total.enable_percentiles(1e-6, 10.0);
+				render_thread_performance = session_profiler();
+				render_commands_performance = render_commands_profiler();
+				get_audiovisuals().performance = audiovisual_profiler();
+
+				headless_first_frame = current_frame.load();
+				headless_client_timer.reset();
+			}
+		}
 	};
 
 	for (;;) {
@@ -3120,12 +3580,27 @@ work_result work(const int argc, const char* const * const argv) try {
 				renderer_backend_result.clear();
 
 				for (auto& r : read_buffer.renderers.all) {
-					renderer_backend.perform(
-						renderer_backend_result,
-						r.commands.data(),
-						r.commands.size(),
-						r.dedicated
-					);
+					if (headless_backend) {
+						headless_backend->perform(
+							renderer_backend_result,
+							r.commands.data(),
+							r.commands.size(),
+							r.dedicated
+						);
+					}
+					else {
+						renderer_backend.perform(
+							renderer_backend_result,
+							r.commands.data(),
+							r.commands.size(),
+							r.dedicated
+						);
+					}
+				}
+
+				if (headless_backend) {
+					headless_backend->finish_frame();
+					render_commands_performance.measure(headless_backend->get_last_frame());
 				}
 
 				current_frame.fetch_add(1, std::memory_order_relaxed);